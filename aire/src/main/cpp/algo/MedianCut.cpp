@@ -30,6 +30,8 @@
 
 #include "MedianCut.h"
 #include "median/Wirth.h"
+#include "base/Histogram.h"
+#include <algorithm>
 #include <vector>
 
 namespace aire {
@@ -219,11 +221,16 @@ namespace aire {
     }
 
     void Palette::medianCut(size_t maxcubes, const std::function<void(const Cube &)> &callback) {
-        memset(_hist, 0, sizeof(int) * kHistSize);
-        std::for_each(_colors, _colors + _colorSize, [&](RGBA color) {
-            uint16_t quantizedColor = rgb555FromRgba(color);
-            _hist[quantizedColor]++;
+        // Colors are laid out as rows to let histogram split them over threads
+        const int rowWidth = 4096;
+        const int rows = static_cast<int>(_colorSize / rowWidth);
+        std::vector<uint32_t> histogram(kHistSize);
+        jointHistogram3D(reinterpret_cast<const uint8_t *>(_colors), rowWidth * sizeof(RGBA), rowWidth, rows, 5,
+                         histogram.data());
+        std::for_each(_colors + static_cast<size_t>(rows) * rowWidth, _colors + _colorSize, [&](RGBA color) {
+            histogram[rgb555FromRgba(color)]++;
         });
+        std::copy(histogram.begin(), histogram.end(), _hist);
 
         uint16_t lower = 0;
         uint16_t upper = 0;
@@ -0,0 +1,248 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 20/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "ArbitraryMorphology.h"
+#include "ArbitraryUtil.h"
+#include "concurrency.hpp"
+#include "jni/JNIUtils.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace aire {
+
+    template<int channels, bool isMax>
+    class SlidingHistogram {
+    public:
+        SlidingHistogram() {
+            for (auto &h: histogram) {
+                h.fill(0);
+            }
+            for (int c = 0; c < channels; ++c) {
+                extreme[c] = isMax ? 0 : 255;
+            }
+        }
+
+        inline void add(const uint8_t *px) {
+            for (int c = 0; c < channels; ++c) {
+                const uint8_t v = px[c];
+                histogram[c][v]++;
+                if constexpr (isMax) {
+                    if (v > extreme[c]) extreme[c] = v;
+                } else {
+                    if (v < extreme[c]) extreme[c] = v;
+                }
+            }
+        }
+
+        inline void remove(const uint8_t *px) {
+            for (int c = 0; c < channels; ++c) {
+                histogram[c][px[c]]--;
+            }
+        }
+
+        inline void store(uint8_t *dst) {
+            for (int c = 0; c < channels; ++c) {
+                int e = extreme[c];
+                if constexpr (isMax) {
+                    while (e > 0 && histogram[c][e] == 0) e--;
+                } else {
+                    while (e < 255 && histogram[c][e] == 0) e++;
+                }
+                extreme[c] = e;
+                dst[c] = static_cast<uint8_t>(e);
+            }
+        }
+
+    private:
+        std::array<std::array<uint32_t, 256>, channels> histogram;
+        int extreme[channels];
+    };
+
+    struct SEFronts {
+        std::vector<int> left, right, up, down, all;
+    };
+
+    static SEFronts buildFronts(const uint8_t *se, const int seWidth, const int seHeight, const int blocWidth,
+                                const int channels) {
+        std::vector<uint8_t> element(se, se + seWidth * seHeight);
+        int ax = -1, ay = -1;
+        for (int j = 0; j < seHeight && ax < 0; ++j) {
+            for (int i = 0; i < seWidth; ++i) {
+                if (element[j * seWidth + i] != 0) {
+                    ax = i;
+                    ay = j;
+                    break;
+                }
+            }
+        }
+
+        SEFronts fronts;
+        struct front l = {}, r = {}, u = {}, d = {};
+        // Fronts do not depend on origin, any element point satisfies analysis
+        if (MORPHO_SUCCESS != analyse_b(element.data(), seWidth, seHeight, &l, &r, &u, &d, ax, ay) ||
+            MORPHO_SUCCESS != transform_b(blocWidth, &l, &r, &u, &d)) {
+            free_front(&l);
+            free_front(&r);
+            free_front(&u);
+            free_front(&d);
+            return fronts;
+        }
+
+        auto toOffsets = [&](const struct front &f, std::vector<int> &dst) {
+            dst.resize(f.size);
+            for (int n = 0; n < f.size; ++n) {
+                dst[n] = f.pos[n] * channels;
+            }
+        };
+        toOffsets(l, fronts.left);
+        toOffsets(r, fronts.right);
+        toOffsets(u, fronts.up);
+        toOffsets(d, fronts.down);
+
+        for (int j = 0; j < seHeight; ++j) {
+            for (int i = 0; i < seWidth; ++i) {
+                if (element[j * seWidth + i] != 0) {
+                    fronts.all.push_back((j * blocWidth + i) * channels);
+                }
+            }
+        }
+
+        free_front(&l);
+        free_front(&r);
+        free_front(&u);
+        free_front(&d);
+        return fronts;
+    }
+
+    template<int channels, bool isMax>
+    void morphologyArbitrarySE(const uint8_t *pixels, uint8_t *destination, const int stride,
+                               const int width, const int height,
+                               const uint8_t *se, const int seWidth, const int seHeight,
+                               const int originX, const int originY, const int threads) {
+        // Image with border of neutral value, so window never leaves the buffer
+        const int blocWidth = width + seWidth * 2;
+        const SEFronts fronts = buildFronts(se, seWidth, seHeight, blocWidth, channels);
+        if (fronts.all.empty()) {
+            throw AireError("Structuring element must contain at least one non zero value");
+        }
+
+        const int blocHeight = height + seHeight * 2;
+        const int blocStride = blocWidth * channels;
+        std::vector<uint8_t> bloc(blocStride * blocHeight, isMax ? 0 : 255);
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(bloc.data() + (y + seHeight) * blocStride + seWidth * channels,
+                        pixels + y * stride, width * channels);
+        }
+
+        const int threadCount = threads > 0 ? threads :
+                                std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+        const int bandHeight = (height + threadCount - 1) / threadCount;
+        const int bands = (height + bandHeight - 1) / bandHeight;
+
+        concurrency::parallel_for(threadCount, bands, [&](int band) {
+            const int startY = band * bandHeight;
+            const int endY = std::min(startY + bandHeight, height);
+
+            // Top-left corner of the element placed for output pixel (x, y)
+            auto corner = [&](int x, int y) -> const uint8_t * {
+                return bloc.data() + (y - originY + seHeight) * blocStride + (x - originX + seWidth) * channels;
+            };
+
+            SlidingHistogram<channels, isMax> histogram;
+            const uint8_t *c = corner(0, startY);
+            for (int p: fronts.all) {
+                histogram.add(c + p);
+            }
+
+            // Serpentine scan: along the row by left/right fronts, to the next row by up/down fronts
+            for (int y = startY; y < endY; ++y) {
+                uint8_t *dst = destination + y * stride;
+                const bool forward = ((y - startY) & 1) == 0;
+                for (int i = 0; i < width; ++i) {
+                    const int x = forward ? i : width - 1 - i;
+                    histogram.store(dst + x * channels);
+                    if (i == width - 1) {
+                        break;
+                    }
+                    if (forward) {
+                        const uint8_t *next = c + channels;
+                        for (int p: fronts.right) histogram.add(next + p);
+                        for (int p: fronts.left) histogram.remove(c + p);
+                        c = next;
+                    } else {
+                        const uint8_t *next = c - channels;
+                        for (int p: fronts.left) histogram.add(next + p);
+                        for (int p: fronts.right) histogram.remove(c + p);
+                        c = next;
+                    }
+                }
+                if (y + 1 < endY) {
+                    const uint8_t *next = c + blocStride;
+                    for (int p: fronts.down) histogram.add(next + p);
+                    for (int p: fronts.up) histogram.remove(c + p);
+                    c = next;
+                }
+            }
+        });
+    }
+
+    template<bool isMax>
+    void morphologyArbitrarySE(const uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                               int channels, const uint8_t *se, int seWidth, int seHeight, int originX, int originY,
+                               int threadCount) {
+        if (channels == 4) {
+            morphologyArbitrarySE<4, isMax>(pixels, destination, stride, width, height,
+                                            se, seWidth, seHeight, originX, originY, threadCount);
+        } else {
+            morphologyArbitrarySE<1, isMax>(pixels, destination, stride, width, height,
+                                            se, seWidth, seHeight, originX, originY, threadCount);
+        }
+    }
+
+    void erodeArbitrarySE(const uint8_t *pixels, uint8_t *destination, int stride, int width, int height, int channels,
+                          const uint8_t *se, int seWidth, int seHeight, int originX, int originY, int threadCount) {
+        morphologyArbitrarySE<false>(pixels, destination, stride, width, height, channels,
+                                     se, seWidth, seHeight, originX, originY, threadCount);
+    }
+
+    void dilateArbitrarySE(const uint8_t *pixels, uint8_t *destination, int stride, int width, int height, int channels,
+                           const uint8_t *se, int seWidth, int seHeight, int originX, int originY, int threadCount) {
+        // Dilation is erosion dual with reflected structuring element
+        std::vector<uint8_t> reflected(seWidth * seHeight);
+        invert_SE(const_cast<uint8_t *>(se), reflected.data(), seWidth, seHeight);
+        morphologyArbitrarySE<true>(pixels, destination, stride, width, height, channels,
+                                    reflected.data(), seWidth, seHeight,
+                                    seWidth - 1 - originX, seHeight - 1 - originY, threadCount);
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 20/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace aire {
+
+    // Erosion and dilation with arbitrary flat structuring element, histogram of window is updated
+    // only by fronts of the element when window moves, so cost per pixel is proportional to the element perimeter.
+    // se is row major seWidth x seHeight, non zero entries belongs to the element, origin is (originX, originY).
+    // Supports 1 or 4 interleaved channels. threadCount 0 picks threads by image size, callers already running
+    // on pool threads pass 1
+    void erodeArbitrarySE(const uint8_t *pixels, uint8_t *destination, int stride, int width, int height, int channels,
+                          const uint8_t *se, int seWidth, int seHeight, int originX, int originY, int threadCount = 0);
+
+    void dilateArbitrarySE(const uint8_t *pixels, uint8_t *destination, int stride, int width, int height, int channels,
+                           const uint8_t *se, int seWidth, int seHeight, int originX, int originY, int threadCount = 0);
+}
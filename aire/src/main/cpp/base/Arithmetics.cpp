@@ -45,34 +45,33 @@ namespace aire {
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
-    void absDiff(uint8_t *destination, uint8_t *s1, uint8_t *s2, int width, int height) {
+    void absDiffRow(uint8_t *destination, const uint8_t *s1, const uint8_t *s2, int count) {
         const ScalableTag<uint8_t> du;
-        using VU = Vec<decltype(du)>;
-        const RebindToSigned<decltype(du)> di;
-        using VI = Vec<decltype(du)>;
         const int lanes = du.MaxLanes();
+        int x = 0;
+        for (; x + lanes <= count; x += lanes) {
+            StoreU(AbsDiff(LoadU(du, s1 + x), LoadU(du, s2 + x)), du, destination + x);
+        }
+        for (; x < count; ++x) {
+            destination[x] = static_cast<uint8_t>(std::abs(s1[x] - s2[x]));
+        }
+    }
+
+    void diffRow(uint8_t *destination, const uint8_t *s1, const uint8_t *s2, int count) {
+        const ScalableTag<uint8_t> du;
+        const int lanes = du.MaxLanes();
+        int x = 0;
+        for (; x + lanes <= count; x += lanes) {
+            StoreU(SaturatedSub(LoadU(du, s1 + x), LoadU(du, s2 + x)), du, destination + x);
+        }
+        for (; x < count; ++x) {
+            destination[x] = static_cast<uint8_t>(std::max(s1[x] - s2[x], 0));
+        }
+    }
 
+    void absDiff(uint8_t *destination, uint8_t *s1, uint8_t *s2, int width, int height) {
         concurrency::parallel_for(3, height, [&](int y) {
-            auto ms = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(s1) + y * width);
-            auto ds = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(s2) +
-                                                  y * width);
-            auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(destination) +
-                                                   y * width);
-            int x = 0;
-            for (; x + lanes < width; x += lanes) {
-                auto m = LoadU(di, reinterpret_cast<int8_t *>(ms));
-                auto s = LoadU(di, reinterpret_cast<int8_t *>(ds));
-                StoreU(Abs(Sub(m, s)), di, reinterpret_cast<int8_t *>(dst));
-                dst += lanes;
-                ms += lanes;
-                ds += lanes;
-            }
-            for (; x < width; ++x) {
-                dst[0] = std::abs(ms[0] - ds[0]);
-                ds += 1;
-                ms += 1;
-                dst += 1;
-            }
+            absDiffRow(destination + y * width, s1 + y * width, s2 + y * width, width);
         });
     }
 
@@ -35,6 +35,12 @@
 namespace aire {
     void absDiff(uint8_t *destination, uint8_t *s1, uint8_t *s2, int width, int height);
 
+    // |s1 - s2| over count bytes
+    void absDiffRow(uint8_t *destination, const uint8_t *s1, const uint8_t *s2, int count);
+
+    // max(s1 - s2, 0) over count bytes
+    void diffRow(uint8_t *destination, const uint8_t *s1, const uint8_t *s2, int count);
+
     void diff(uint8_t *destination, uint8_t value, uint8_t *s1, int width, int height);
 
     template<class V>
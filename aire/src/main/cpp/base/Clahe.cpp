@@ -0,0 +1,504 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 27/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Clahe.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "Clahe.h"
+#include "Histogram.h"
+#include "concurrency.hpp"
+#include "jni/JNIUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    void ClaheQuantizeRow(const float *src, uint16_t *bins, const int width, const float scale, const int maxBin) {
+        const ScalableTag<float> df;
+        const RebindToSigned<decltype(df)> di;
+        const Rebind<uint16_t, decltype(df)> du16;
+        const int lanes = static_cast<int>(Lanes(df));
+        const auto vScale = Set(df, scale);
+        const auto vMaxBin = Set(di, maxBin);
+        const auto zeros = Zero(di);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            const auto bin = Clamp(NearestInt(Mul(LoadU(df, src + x), vScale)), zeros, vMaxBin);
+            StoreU(DemoteTo(du16, bin), du16, bins + x);
+        }
+        for (; x < width; ++x) {
+            bins[x] = static_cast<uint16_t>(std::clamp(static_cast<int>(std::lround(src[x] * scale)), 0, maxBin));
+        }
+    }
+
+    /**
+     * Bilinear blend of four tile mappings, tile offsets and horizontal weights are per column,
+     * tile rows and vertical weight are shared by the whole row
+     */
+    void ClaheMapRow(const uint16_t *bins, float *dst, const int width, const float *luts,
+                     const int topRow, const int bottomRow, const float weightY,
+                     const int32_t *left, const int32_t *right, const float *weightX, const float scale) {
+        const ScalableTag<float> df;
+        const RebindToSigned<decltype(df)> di;
+        const Rebind<uint16_t, decltype(df)> du16;
+        const int lanes = static_cast<int>(Lanes(df));
+        const auto vTop = Set(di, topRow);
+        const auto vBottom = Set(di, bottomRow);
+        const auto vWeightY = Set(df, weightY);
+        const auto vScale = Set(df, scale);
+
+        uint16_t binsTail[HWY_MAX_BYTES / sizeof(float)] = {0};
+        int32_t leftTail[HWY_MAX_BYTES / sizeof(float)] = {0};
+        int32_t rightTail[HWY_MAX_BYTES / sizeof(float)] = {0};
+        float weightTail[HWY_MAX_BYTES / sizeof(float)] = {0};
+        float dstTail[HWY_MAX_BYTES / sizeof(float)];
+
+        for (int x = 0; x < width; x += lanes) {
+            const int count = std::min(lanes, width - x);
+            const uint16_t *b = bins + x;
+            const int32_t *l = left + x;
+            const int32_t *r = right + x;
+            const float *w = weightX + x;
+            float *d = dst + x;
+            if (count < lanes) {
+                std::copy(b, b + count, binsTail);
+                std::copy(l, l + count, leftTail);
+                std::copy(r, r + count, rightTail);
+                std::copy(w, w + count, weightTail);
+                b = binsTail;
+                l = leftTail;
+                r = rightTail;
+                w = weightTail;
+                d = dstTail;
+            }
+            const auto bin = PromoteTo(di, LoadU(du16, b));
+            const auto vLeft = Add(LoadU(di, l), bin);
+            const auto vRight = Add(LoadU(di, r), bin);
+            const auto wx = LoadU(df, w);
+            const auto topLeft = GatherIndex(df, luts, Add(vTop, vLeft));
+            const auto topRight = GatherIndex(df, luts, Add(vTop, vRight));
+            const auto bottomLeft = GatherIndex(df, luts, Add(vBottom, vLeft));
+            const auto bottomRight = GatherIndex(df, luts, Add(vBottom, vRight));
+            const auto top = MulAdd(Sub(topRight, topLeft), wx, topLeft);
+            const auto bottom = MulAdd(Sub(bottomRight, bottomLeft), wx, bottomLeft);
+            StoreU(Mul(MulAdd(Sub(bottom, top), vWeightY, top), vScale), df, d);
+            if (count < lanes) {
+                std::copy(dstTail, dstTail + count, dst + x);
+            }
+        }
+    }
+    /**
+     * Adds incoming and removes outgoing column histogram from the window, either may be null.
+     * Returns how many window pixels changed at bins up to bin, so the running rank stays exact
+     */
+    HWY_INLINE int32_t ClaheSlideWindow(int32_t *window, const uint16_t *incoming, const uint16_t *outgoing,
+                                        const int columnStride, const int bin) {
+        const ScalableTag<int32_t> di32;
+        const Rebind<uint16_t, decltype(di32)> du16;
+        const int lanes = static_cast<int>(Lanes(di32));
+        const auto vBin = Set(di32, bin);
+        auto index = Iota(di32, 0);
+        const auto step = Set(di32, lanes);
+        auto below = Zero(di32);
+        for (int i = 0; i < columnStride; i += lanes) {
+            auto delta = Zero(di32);
+            if (incoming) {
+                delta = PromoteTo(di32, LoadU(du16, incoming + i));
+            }
+            if (outgoing) {
+                delta = Sub(delta, PromoteTo(di32, LoadU(du16, outgoing + i)));
+            }
+            StoreU(Add(LoadU(di32, window + i), delta), di32, window + i);
+            below = Add(below, IfThenElseZero(Le(index, vBin), delta));
+            index = Add(index, step);
+        }
+        return ReduceSum(di32, below);
+    }
+
+    /**
+     * Equalizes a row from per column histograms, window moves right by whole columns and
+     * rank of the pixel's bin is kept incrementally, so it walks only between neighbouring bins
+     */
+    void ClaheSlideRow(const uint16_t *columns, const int columnStride, const uint16_t *row, float *dst,
+                       const int width, const int radiusX, const int rows, const float scale, int32_t *window) {
+        std::fill(window, window + columnStride, 0);
+        const int firstRight = std::min(radiusX, width - 1);
+        for (int x = 0; x <= firstRight; ++x) {
+            ClaheSlideWindow(window, columns + static_cast<size_t>(x) * columnStride, nullptr, columnStride, 0);
+        }
+
+        int bin = row[0];
+        int32_t rank = 0;
+        for (int i = 0; i <= bin; ++i) {
+            rank += window[i];
+        }
+
+        for (int x = 0; x < width; ++x) {
+            if (x > 0) {
+                const int incoming = x + radiusX;
+                const int outgoing = x - radiusX - 1;
+                rank += ClaheSlideWindow(window,
+                                         incoming < width ? columns + static_cast<size_t>(incoming) * columnStride : nullptr,
+                                         outgoing >= 0 ? columns + static_cast<size_t>(outgoing) * columnStride : nullptr,
+                                         columnStride, bin);
+                const int next = row[x];
+                for (; bin < next; ++bin) {
+                    rank += window[bin + 1];
+                }
+                for (; bin > next; --bin) {
+                    rank -= window[bin];
+                }
+            }
+            const int columnsCount = std::min(x + radiusX, width - 1) - std::max(x - radiusX, 0) + 1;
+            dst[x] = static_cast<float>(rank) / static_cast<float>(rows * columnsCount) * scale;
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(ClaheQuantizeRow);
+    HWY_EXPORT(ClaheMapRow);
+    HWY_EXPORT(ClaheSlideRow);
+
+    typedef std::function<void(const uint16_t *bins, float *lightness, float scale)> ClaheEqualizer;
+
+    static int claheThreadCount(const int width, const int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   height * width / (256 * 256)), 1, 12);
+    }
+
+    // Per tile histograms and mappings grow with bins count, more bins than this gives nothing for 8 bit output
+    static const int claheMaxBinsCount = 4096;
+
+    static void claheValidate(const int gridX, const int gridY, const int binsCount) {
+        if (gridX <= 0 || gridY <= 0) {
+            std::string msg = "Grid size must be positive, but received " + std::to_string(gridX) + "x" +
+                              std::to_string(gridY);
+            throw AireError(msg);
+        }
+        if (binsCount < 2 || binsCount > claheMaxBinsCount) {
+            std::string msg = "Bins count must be in range 2..." + std::to_string(claheMaxBinsCount) +
+                              ", but received " + std::to_string(binsCount);
+            throw AireError(msg);
+        }
+    }
+
+    static void equalizeLuma(uint8_t *data, int stride, int width, int height, const ClaheEqualizer &equalizer) {
+        std::vector<uint16_t> bins(static_cast<size_t>(width) * height);
+        std::vector<float> lightness(bins.size());
+        const int threadCount = claheThreadCount(width, height);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const uint8_t *src = data + y * stride;
+            uint16_t *dst = bins.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x, src += 4) {
+                dst[x] = static_cast<uint16_t>((src[0] * 77 + src[1] * 150 + src[2] * 29 + 128) >> 8);
+            }
+        });
+
+        equalizer(bins.data(), lightness.data(), 255.f);
+
+        // Chroma of full range YCbCr is kept by moving R, G and B by the luma difference
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *dst = data + y * stride;
+            const uint16_t *luma = bins.data() + static_cast<size_t>(y) * width;
+            const float *equalized = lightness.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x, dst += 4) {
+                const int delta = static_cast<int>(std::lround(equalized[x])) - luma[x];
+                dst[0] = static_cast<uint8_t>(std::clamp(dst[0] + delta, 0, 255));
+                dst[1] = static_cast<uint8_t>(std::clamp(dst[1] + delta, 0, 255));
+                dst[2] = static_cast<uint8_t>(std::clamp(dst[2] + delta, 0, 255));
+            }
+        });
+    }
+
+    static void equalizeColorspace(uint8_t *data, int stride, int width, int height, int binsCount,
+                                   ColorSpace colorSpace, const ClaheEqualizer &equalizer) {
+        const size_t planeSize = static_cast<size_t>(width) * height;
+        std::vector<float> planes(planeSize * 3);
+        rgbaToPlanar(data, stride, planes.data(), width, width, height, colorSpace);
+
+        // Lightness range is taken from white in the same space
+        const int channel = colorSpace == COLORSPACE_HSV || colorSpace == COLORSPACE_HSL ? 2 : 0;
+        const uint8_t white[4] = {255, 255, 255, 255};
+        float whitePlanes[3];
+        rgbaToPlanar(white, 4, whitePlanes, 1, 1, 1, colorSpace);
+        const float maxLightness = whitePlanes[channel];
+
+        float *lightness = planes.data() + planeSize * channel;
+        std::vector<uint16_t> bins(planeSize);
+        const float scale = static_cast<float>(binsCount - 1) / maxLightness;
+        concurrency::parallel_for(claheThreadCount(width, height), height, [&](int y) {
+            const size_t offset = static_cast<size_t>(y) * width;
+            HWY_DYNAMIC_DISPATCH(ClaheQuantizeRow)(lightness + offset, bins.data() + offset, width, scale,
+                                                   binsCount - 1);
+        });
+
+        equalizer(bins.data(), lightness, maxLightness);
+
+        planarToRgba(data, stride, planes.data(), width, width, height, colorSpace);
+    }
+
+    static void claheClip(uint32_t *histogram, const int binsCount, const uint32_t clipLimit) {
+        uint32_t excess = 0;
+        for (int i = 0; i < binsCount; ++i) {
+            if (histogram[i] > clipLimit) {
+                excess += histogram[i] - clipLimit;
+                histogram[i] = clipLimit;
+            }
+        }
+        const uint32_t add = excess / binsCount;
+        uint32_t residual = excess - add * binsCount;
+        for (int i = 0; i < binsCount; ++i) {
+            histogram[i] += add;
+        }
+        if (residual > 0) {
+            const int step = std::max(binsCount / static_cast<int>(residual), 1);
+            for (int i = 0; i < binsCount && residual > 0; i += step, --residual) {
+                histogram[i]++;
+            }
+        }
+    }
+
+    /**
+     * Tile mappings from tile histograms, clipped when threshold is positive.
+     * Mapping is blended bilinearly between tile centers or taken from the own tile only
+     */
+    static void equalizeTiles(const uint16_t *bins, float *lightness, const float scale, const int width,
+                              const int height, const int binsCount, const int gridX, const int gridY,
+                              const float threshold, const bool interpolate) {
+        const size_t tileBins = static_cast<size_t>(binsCount);
+        std::vector<uint32_t> histograms(tileBins * gridX * gridY);
+        tileHistograms(bins, width * static_cast<int>(sizeof(uint16_t)), width, height, gridX, gridY, binsCount,
+                       histograms.data());
+
+        std::vector<float> luts(histograms.size());
+        for (int tileY = 0; tileY < gridY; ++tileY) {
+            for (int tileX = 0; tileX < gridX; ++tileX) {
+                const size_t tile = static_cast<size_t>(tileY * gridX + tileX);
+                uint32_t *histogram = histograms.data() + tile * tileBins;
+                const int tileArea = ((tileX + 1) * width / gridX - tileX * width / gridX) *
+                                     ((tileY + 1) * height / gridY - tileY * height / gridY);
+                if (threshold > 0) {
+                    const auto clipLimit = static_cast<uint32_t>(std::max(threshold * tileArea / binsCount, 1.f));
+                    claheClip(histogram, binsCount, clipLimit);
+                }
+                float *lut = luts.data() + tile * tileBins;
+                const float total = 1.f / static_cast<float>(std::max(tileArea, 1));
+                uint32_t cdf = 0;
+                for (int i = 0; i < binsCount; ++i) {
+                    cdf += histogram[i];
+                    lut[i] = std::min(static_cast<float>(cdf) * total, 1.f);
+                }
+            }
+        }
+
+        const float tileWidth = static_cast<float>(width) / static_cast<float>(gridX);
+        const float tileHeight = static_cast<float>(height) / static_cast<float>(gridY);
+
+        auto tilePosition = [&](const int position, const float tileSize, const int grid,
+                                int &first, int &second, float &weight) {
+            if (!interpolate) {
+                first = std::min(static_cast<int>(static_cast<float>(position) / tileSize), grid - 1);
+                second = first;
+                weight = 0.f;
+                return;
+            }
+            const float center = (static_cast<float>(position) + 0.5f) / tileSize - 0.5f;
+            const float floored = std::floor(center);
+            first = std::clamp(static_cast<int>(floored), 0, grid - 1);
+            second = std::min(first + 1, grid - 1);
+            weight = center < 0 || first == second ? 0.f : center - floored;
+        };
+
+        std::vector<int32_t> left(width), right(width);
+        std::vector<float> weightX(width);
+        for (int x = 0; x < width; ++x) {
+            int first, second;
+            tilePosition(x, tileWidth, gridX, first, second, weightX[x]);
+            left[x] = static_cast<int32_t>(first * tileBins);
+            right[x] = static_cast<int32_t>(second * tileBins);
+        }
+
+        concurrency::parallel_for(claheThreadCount(width, height), height, [&](int y) {
+            int top, bottom;
+            float weightY;
+            tilePosition(y, tileHeight, gridY, top, bottom, weightY);
+            const size_t offset = static_cast<size_t>(y) * width;
+            HWY_DYNAMIC_DISPATCH(ClaheMapRow)(bins + offset, lightness + offset, width, luts.data(),
+                                              static_cast<int>(top * gridX * tileBins),
+                                              static_cast<int>(bottom * gridX * tileBins), weightY,
+                                              left.data(), right.data(), weightX.data(), scale);
+        });
+    }
+
+    /**
+     * Column histograms slide down by one pixel per row, window slides right by whole columns,
+     * so each step costs O(bins) vector adds instead of window area
+     */
+    static void equalizeSliding(const uint16_t *bins, float *lightness, const float scale, const int width,
+                                const int height, const int binsCount, const int gridX, const int gridY) {
+        const int radiusX = std::max(width / gridX / 2, 1);
+        const int radiusY = std::max(height / gridY / 2, 1);
+        // Padded to whole vectors of any target, padding bins stay zero
+        constexpr int binsAlignment = HWY_MAX_BYTES / sizeof(int32_t);
+        const int columnStride = (binsCount + binsAlignment - 1) / binsAlignment * binsAlignment;
+
+        concurrency::parallel_for_segment(claheThreadCount(width, height), height, [&](int start, int end) {
+            if (start >= end) {
+                return;
+            }
+            std::vector<uint16_t> columns(static_cast<size_t>(columnStride) * width, 0);
+            std::vector<int32_t> window(columnStride);
+
+            int windowTop = std::max(start - radiusY, 0);
+            int windowBottom = std::min(start + radiusY, height - 1);
+            for (int y = windowTop; y <= windowBottom; ++y) {
+                const uint16_t *row = bins + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    columns[static_cast<size_t>(x) * columnStride + row[x]]++;
+                }
+            }
+
+            for (int y = start; y < end; ++y) {
+                const int newTop = std::max(y - radiusY, 0);
+                const int newBottom = std::min(y + radiusY, height - 1);
+                for (; windowTop < newTop; ++windowTop) {
+                    const uint16_t *row = bins + static_cast<size_t>(windowTop) * width;
+                    for (int x = 0; x < width; ++x) {
+                        columns[static_cast<size_t>(x) * columnStride + row[x]]--;
+                    }
+                }
+                for (; windowBottom < newBottom; ++windowBottom) {
+                    const uint16_t *row = bins + static_cast<size_t>(windowBottom + 1) * width;
+                    for (int x = 0; x < width; ++x) {
+                        columns[static_cast<size_t>(x) * columnStride + row[x]]++;
+                    }
+                }
+                const int rows = windowBottom - windowTop + 1;
+                HWY_DYNAMIC_DISPATCH(ClaheSlideRow)(columns.data(), columnStride, bins + static_cast<size_t>(y) * width,
+                                                    lightness + static_cast<size_t>(y) * width, width, radiusX, rows,
+                                                    scale, window.data());
+            }
+        });
+    }
+
+    void equalizeHist(uint8_t *data, int stride, int width, int height) {
+        equalizeLuma(data, stride, width, height, [&](const uint16_t *bins, float *lightness, float scale) {
+            equalizeTiles(bins, lightness, scale, width, height, 256, 1, 1, 0.f, false);
+        });
+    }
+
+    void equalizeHist(uint8_t *data, int stride, int width, int height, int binsCount, ColorSpace colorSpace) {
+        claheValidate(1, 1, binsCount);
+        equalizeColorspace(data, stride, width, height, binsCount, colorSpace,
+                           [&](const uint16_t *bins, float *lightness, float scale) {
+                               equalizeTiles(bins, lightness, scale, width, height, binsCount, 1, 1, 0.f, false);
+                           });
+    }
+
+    void equalizeHistSquares(uint8_t *data, int stride, int width, int height, int gridX, int gridY) {
+        claheValidate(gridX, gridY, 256);
+        equalizeLuma(data, stride, width, height, [&](const uint16_t *bins, float *lightness, float scale) {
+            equalizeTiles(bins, lightness, scale, width, height, 256, gridX, gridY, 0.f, false);
+        });
+    }
+
+    void clahe(uint8_t *data, int stride, int width, int height, float threshold, int gridX, int gridY) {
+        claheValidate(gridX, gridY, 256);
+        equalizeLuma(data, stride, width, height, [&](const uint16_t *bins, float *lightness, float scale) {
+            equalizeTiles(bins, lightness, scale, width, height, 256, gridX, gridY, threshold, true);
+        });
+    }
+
+    void clahe(uint8_t *data, int stride, int width, int height, float threshold, int gridX, int gridY,
+               int binsCount, ColorSpace colorSpace) {
+        claheValidate(gridX, gridY, binsCount);
+        equalizeColorspace(data, stride, width, height, binsCount, colorSpace,
+                           [&](const uint16_t *bins, float *lightness, float scale) {
+                               equalizeTiles(bins, lightness, scale, width, height, binsCount,
+                                             gridX, gridY, threshold, true);
+                           });
+    }
+
+    void clahePlane(uint8_t *plane, int stride, int width, int height, float threshold, int gridX, int gridY,
+                    uint8_t low, uint8_t high) {
+        claheValidate(gridX, gridY, 256);
+        std::vector<uint16_t> bins(static_cast<size_t>(width) * height);
+        std::vector<float> lightness(bins.size());
+        const int threadCount = claheThreadCount(width, height);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const uint8_t *src = plane + static_cast<size_t>(y) * stride;
+            std::copy(src, src + width, bins.begin() + static_cast<size_t>(y) * width);
+        });
+
+        equalizeTiles(bins.data(), lightness.data(), static_cast<float>(high - low), width, height, 256,
+                      gridX, gridY, threshold, true);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *dst = plane + static_cast<size_t>(y) * stride;
+            const float *equalized = lightness.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                dst[x] = static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround(equalized[x])) + low,
+                                                         static_cast<int>(low), static_cast<int>(high)));
+            }
+        });
+    }
+
+    void equalizeHistAdaptive(uint8_t *data, int stride, int width, int height, int gridX, int gridY) {
+        claheValidate(gridX, gridY, 256);
+        equalizeLuma(data, stride, width, height, [&](const uint16_t *bins, float *lightness, float scale) {
+            equalizeSliding(bins, lightness, scale, width, height, 256, gridX, gridY);
+        });
+    }
+
+    void equalizeHistAdaptive(uint8_t *data, int stride, int width, int height, int gridX, int gridY,
+                              int binsCount, ColorSpace colorSpace) {
+        claheValidate(gridX, gridY, binsCount);
+        equalizeColorspace(data, stride, width, height, binsCount, colorSpace,
+                           [&](const uint16_t *bins, float *lightness, float scale) {
+                               equalizeSliding(bins, lightness, scale, width, height, binsCount, gridX, gridY);
+                           });
+    }
+}
+#endif
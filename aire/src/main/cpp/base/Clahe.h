@@ -0,0 +1,69 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 27/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "color/Colorspace.h"
+
+namespace aire {
+
+    /**
+     * Histogram equalization family. Variants without color space equalize BT.601 luma and keep
+     * chroma of full range YCbCr, others equalize L ( or V for HSV ) of colorSpace quantized to binsCount bins.
+     * Grid sizes and bins count are validated and AireError is thrown for invalid ones
+     */
+
+    void equalizeHist(uint8_t *data, int stride, int width, int height);
+
+    void equalizeHist(uint8_t *data, int stride, int width, int height, int binsCount, ColorSpace colorSpace);
+
+    // Each tile is equalized on its own without blending between tiles
+    void equalizeHistSquares(uint8_t *data, int stride, int width, int height, int gridX, int gridY);
+
+    /**
+     * Contrast limited adaptive equalization, tile histograms are clipped at threshold times
+     * uniform bin height and tile mappings blended bilinearly
+     */
+    void clahe(uint8_t *data, int stride, int width, int height, float threshold, int gridX, int gridY);
+
+    void clahe(uint8_t *data, int stride, int width, int height, float threshold, int gridX, int gridY,
+               int binsCount, ColorSpace colorSpace);
+
+    // Equalizes single 8 bit plane such as Y of YUV, result is mapped into [low, high]
+    void clahePlane(uint8_t *plane, int stride, int width, int height, float threshold, int gridX, int gridY,
+                    uint8_t low = 0, uint8_t high = 255);
+
+    // Sliding window equalization, window is image size over grid size centered at each pixel
+    void equalizeHistAdaptive(uint8_t *data, int stride, int width, int height, int gridX, int gridY);
+
+    void equalizeHistAdaptive(uint8_t *data, int stride, int width, int height, int gridX, int gridY,
+                              int binsCount, ColorSpace colorSpace);
+}
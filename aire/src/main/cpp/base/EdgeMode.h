@@ -0,0 +1,72 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 21/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+
+namespace aire {
+
+    enum EdgeMode {
+        EDGE_CLAMP = 0,
+        EDGE_WRAP = 1,
+        EDGE_REFLECT = 2,
+        EDGE_REFLECT_101 = 3,
+        EDGE_CONSTANT = 4
+    };
+
+    // Maps coordinate outside [0, size) back to the image, EDGE_CONSTANT returns -1 for outside coordinates
+    static inline int edgeIndex(int x, const int size, const EdgeMode mode) {
+        if (x >= 0 && x < size) {
+            return x;
+        }
+        switch (mode) {
+            case EDGE_CLAMP:
+                return std::clamp(x, 0, size - 1);
+            case EDGE_WRAP:
+                return ((x % size) + size) % size;
+            case EDGE_REFLECT: {
+                const int period = size * 2;
+                x = ((x % period) + period) % period;
+                return x < size ? x : period - 1 - x;
+            }
+            case EDGE_REFLECT_101: {
+                if (size == 1) {
+                    return 0;
+                }
+                const int period = size * 2 - 2;
+                x = ((x % period) + period) % period;
+                return x < size ? x : period - x;
+            }
+            default:
+                return -1;
+        }
+    }
+}
@@ -31,8 +31,8 @@
 #include "Erosion.h"
 #include <vector>
 #include <algorithm>
-#include <thread>
-#include "concurrency.hpp"
+#include "ArbitraryMorphology.h"
+#include "RectMorphology.h"
 
 using namespace std;
 
@@ -41,72 +41,29 @@ namespace aire {
     template<class T>
     void erodeRGBA(T *pixels, T *destination, int stride, int width, int height,
                    Eigen::MatrixXi &kernel) {
-        concurrency::parallel_for(8, height, [&](int y) {
-            for (int x = 0; x < width; ++x) {
-                int mSize = kernel.rows() / 2;
+        int x0, y0, rectWidth, rectHeight;
+        if (isRectangleKernel(kernel, x0, y0, rectWidth, rectHeight)) {
+            erodeRectRGBA(reinterpret_cast<uint8_t *>(pixels), reinterpret_cast<uint8_t *>(destination),
+                          stride, width, height, rectWidth, rectHeight,
+                          x0 - static_cast<int>(kernel.cols()) / 2, y0 - static_cast<int>(kernel.rows()) / 2);
+            return;
+        }
 
-                auto srcLocal = reinterpret_cast<uint32_t *>(
-                        reinterpret_cast<uint8_t *>(pixels) +
-                        y * stride);
-
-                long min = srcLocal[x];
-
-                for (int m = -mSize; m < mSize; ++m) {
-                    int nSize = kernel.cols() / 2;
-                    for (int n = -nSize; n < nSize; ++n) {
-                        int newX = x + m;
-                        int newY = y + n;
-                        if (newX >= 0 && newX < width && newY >= 0 && newY < height) {
-                            auto src = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(pixels) + newY * stride);
-                            const uint32_t item = src[newX] * kernel(m + mSize, n + nSize);
-                            if (item < min) {
-                                min = item;
-                            }
-                        }
-                    }
-                }
-
-                auto dst = reinterpret_cast<uint32_t *>(
-                        reinterpret_cast<uint8_t *>(destination) + y * stride);
-                dst[x] = min;
-            }
-        });
+        Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rowMajor = (kernel.array() != 0).cast<uint8_t>();
+        erodeArbitrarySE(reinterpret_cast<uint8_t *>(pixels), reinterpret_cast<uint8_t *>(destination),
+                         stride, width, height, 4,
+                         rowMajor.data(), static_cast<int>(rowMajor.cols()), static_cast<int>(rowMajor.rows()),
+                         static_cast<int>(kernel.cols()) / 2, static_cast<int>(kernel.rows()) / 2);
     }
 
     template<class T>
     void erode(T *pixels, T *destination, int width, int height,
                Eigen::MatrixXi &kernel) {
-        concurrency::parallel_for(8, height, [&](int y) {
-            auto dst = reinterpret_cast<T *>(
-                    reinterpret_cast<uint8_t *>(destination) + y * width);
-            for (int x = 0; x < width; ++x) {
-                int mSize = kernel.rows() / 2;
-
-                auto srcLocal = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(pixels) + y * height);
-
-                T min = srcLocal[x];
-
-                for (int m = -mSize; m < mSize; ++m) {
-                    int nSize = kernel.cols() / 2;
-                    for (int n = -nSize; n < nSize; ++n) {
-                        int newX = x + m;
-                        int newY = y + n;
-                        if (newX >= 0 && newX < width && newY >= 0 &&
-                            newY < height) {
-                            auto src = reinterpret_cast<T *>(
-                                    reinterpret_cast<uint8_t *>(pixels) +
-                                    newY * width);
-                            T vl = src[newX] * kernel(m + mSize, n + nSize);
-                            if (vl > min) {
-                                min = vl;
-                            }
-                        }
-                    }
-                }
-
-                dst[x] = min;
-            }
-        });
+        Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rowMajor = (kernel.array() != 0).cast<uint8_t>();
+        erodeArbitrarySE(reinterpret_cast<uint8_t *>(pixels), reinterpret_cast<uint8_t *>(destination),
+                         width * static_cast<int>(sizeof(T)), width, height, 1,
+                         rowMajor.data(), static_cast<int>(rowMajor.cols()), static_cast<int>(rowMajor.rows()),
+                         static_cast<int>(kernel.cols()) / 2, static_cast<int>(kernel.rows()) / 2);
     }
 
     template void
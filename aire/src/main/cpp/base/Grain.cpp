@@ -28,31 +28,159 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Grain.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "Grain.h"
-#include <random>
+#include "algo/math-inl.h"
 #include "concurrency.hpp"
+#include <algorithm>
+#include <thread>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    // lowbias32 integer mixer
+    template<class DU, typename VU = Vec<DU>>
+    HWY_INLINE VU GrainMix(const DU du, VU v) {
+        v = Xor(v, ShiftRight<16>(v));
+        v = Mul(v, Set(du, 0x7feb352dU));
+        v = Xor(v, ShiftRight<15>(v));
+        v = Mul(v, Set(du, 0x846ca68bU));
+        return Xor(v, ShiftRight<16>(v));
+    }
+
+    // Two keyed rounds over pixel counter, result is uniform in (0, 1]
+    template<class D, typename VU = Vec<RebindToUnsigned<D>>>
+    HWY_INLINE Vec<D> GrainUniform(const D df, VU counter, const uint32_t key0, const uint32_t key1) {
+        const RebindToUnsigned<D> du;
+        const RebindToSigned<D> di;
+        auto v = GrainMix(du, Xor(counter, Set(du, key0)));
+        v = GrainMix(du, Add(v, Set(du, key1)));
+        const auto bits = ConvertTo(df, BitCast(di, ShiftRight<8>(v)));
+        return Mul(Add(bits, Set(df, 1.f)), Set(df, 1.f / 16777216.f));
+    }
+
+    // Box-Muller, two normal samples from two uniform ones
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void GrainGaussian(const D df, V u1, V u2, V &z0, V &z1) {
+        const auto radius = Sqrt(Mul(Set(df, -2.f), hwy::HWY_NAMESPACE::Log(df, u1)));
+        V sine, cosine;
+        hwy::HWY_NAMESPACE::SinCos(df, Mul(u2, Set(df, 2.f * static_cast<float>(M_PI))), sine, cosine);
+        z0 = Mul(radius, cosine);
+        z1 = Mul(radius, sine);
+    }
+
+    template<class D>
+    HWY_INLINE void GrainPixels(const D df, uint8_t *pixels, const uint32_t counter, const uint32_t keys[8],
+                                const float sigma, const float luminanceResponse, const float chromaSigma) {
+        const RebindToUnsigned<D> du;
+        const Rebind<uint8_t, D> du8;
+        const RebindToSigned<D> di;
+        using V = Vec<D>;
+
+        const auto counters = Add(Iota(du, 0), Set(du, counter));
 
-    using namespace std;
+        V luma, chromaR, chromaB;
+        GrainGaussian(df, GrainUniform(df, counters, keys[0], keys[1]),
+                      GrainUniform(df, counters, keys[2], keys[3]), luma, chromaR);
 
-    void grain(uint8_t *data, int stride, int width, int height, float intensity) {
-        default_random_engine generator;
-        generator.seed(std::chrono::system_clock::now().time_since_epoch().count());
-        normal_distribution<float> distribution(0, 127.f * intensity);
+        Vec<decltype(du8)> ru, gu, bu, au;
+        LoadInterleaved4(du8, pixels, ru, gu, bu, au);
+        auto r = ConvertTo(df, PromoteTo(di, ru));
+        auto g = ConvertTo(df, PromoteTo(di, gu));
+        auto b = ConvertTo(df, PromoteTo(di, bu));
 
-        concurrency::parallel_for(2, height, [&](int y) {
-            auto dst = reinterpret_cast<uint8_t *>(
-                    reinterpret_cast<uint8_t *>(data) + y * stride);
-            for (int x = 0; x < width; ++x) {
-                int grain = distribution(generator);
-                const float mGrain = static_cast<float>(grain);
+        auto amount = Set(df, sigma);
+        if (luminanceResponse > 0) {
+            // Mid tones get full grain, shadows and highlights fade by response
+            const auto lightness = Mul(MulAdd(Set(df, 0.299f), r, MulAdd(Set(df, 0.587f), g, Mul(Set(df, 0.114f), b))),
+                                       Set(df, 1.f / 255.f));
+            const auto midTones = Mul(Set(df, 4.f), Mul(lightness, Sub(Set(df, 1.f), lightness)));
+            amount = Mul(amount, MulAdd(Set(df, luminanceResponse), midTones, Set(df, 1.f - luminanceResponse)));
+        }
+        luma = Mul(luma, amount);
 
-                int px = x * 4;
-                dst[px] = clamp(dst[px] + mGrain, 0.f, 255.f);
-                dst[px + 1] = clamp(dst[px + 1] + mGrain, 0.f, 255.f);
-                dst[px + 2] = clamp(dst[px + 2] + mGrain, 0.f, 255.f);
+        auto offsetR = luma;
+        auto offsetG = luma;
+        auto offsetB = luma;
+        if (chromaSigma > 0) {
+            V unused;
+            GrainGaussian(df, GrainUniform(df, counters, keys[4], keys[5]),
+                          GrainUniform(df, counters, keys[6], keys[7]), chromaB, unused);
+            const auto vChroma = Set(df, chromaSigma);
+            chromaR = Mul(chromaR, vChroma);
+            chromaB = Mul(chromaB, vChroma);
+            // Noise in Cr and Cb of full range YCbCr
+            offsetR = MulAdd(Set(df, 1.402f), chromaR, offsetR);
+            offsetG = MulAdd(Set(df, -0.714136f), chromaR, MulAdd(Set(df, -0.344136f), chromaB, offsetG));
+            offsetB = MulAdd(Set(df, 1.772f), chromaB, offsetB);
+        }
+
+        const auto zeros = Zero(df);
+        const auto max = Set(df, 255.f);
+        ru = DemoteTo(du8, NearestInt(Clamp(Add(r, offsetR), zeros, max)));
+        gu = DemoteTo(du8, NearestInt(Clamp(Add(g, offsetG), zeros, max)));
+        bu = DemoteTo(du8, NearestInt(Clamp(Add(b, offsetB), zeros, max)));
+        StoreInterleaved4(ru, gu, bu, au, du8, pixels);
+    }
+
+    void GrainRGBA(uint8_t *data, const int stride, const int width, const int height, const float intensity,
+                   const uint64_t seed, const float luminanceResponse, const float chromaIntensity) {
+        const ScalableTag<float> df;
+        const int lanes = static_cast<int>(Lanes(df));
+
+        // Each uniform stream takes own key pair derived from the seed
+        uint32_t keys[8];
+        uint64_t state = seed;
+        for (uint32_t &key: keys) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = static_cast<uint32_t>(z ^ (z >> 31));
+        }
+
+        const float sigma = 127.f * intensity;
+        const float chromaSigma = 127.f * chromaIntensity;
+        const float response = std::clamp(luminanceResponse, 0.f, 1.f);
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *row = data + y * stride;
+            const uint32_t rowCounter = static_cast<uint32_t>(y) * static_cast<uint32_t>(width);
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                GrainPixels(df, row + x * 4, rowCounter + x, keys, sigma, response, chromaSigma);
+            }
+            if (x < width) {
+                const int remaining = width - x;
+                uint8_t tail[HWY_MAX_BYTES] = {0};
+                std::copy(row + x * 4, row + width * 4, tail);
+                GrainPixels(df, tail, rowCounter + x, keys, sigma, response, chromaSigma);
+                std::copy(tail, tail + remaining * 4, row + x * 4);
             }
         });
     }
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(GrainRGBA);
+
+    void grain(uint8_t *data, int stride, int width, int height, float intensity, uint64_t seed,
+               float luminanceResponse, float chromaIntensity) {
+        HWY_DYNAMIC_DISPATCH(GrainRGBA)(data, stride, width, height, intensity, seed, luminanceResponse,
+                                        chromaIntensity);
+    }
+}
+#endif
@@ -33,5 +33,11 @@
 #include <cstdint>
 
 namespace aire {
-    void grain(uint8_t *data, int stride, int width, int height, float intensity);
+    /**
+     * Gaussian film grain from a counter based generator keyed by seed and pixel position,
+     * so same seed gives same grain on any thread count.
+     * luminanceResponse in 0...1 concentrates grain in mid tones, chromaIntensity adds colored grain
+     */
+    void grain(uint8_t *data, int stride, int width, int height, float intensity, uint64_t seed,
+               float luminanceResponse = 0.f, float chromaIntensity = 0.f);
 }
\ No newline at end of file
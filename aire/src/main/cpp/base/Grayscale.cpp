@@ -28,57 +28,90 @@
  *
  */
 
-#include "Grayscale.h"
-#include "color/Gamut.h"
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Grayscale.cpp"
+
+#include "hwy/foreach_target.h"
 #include "hwy/highway.h"
+
+#include "Grayscale.h"
 #include "color/eotf-inl.h"
 #include "concurrency.hpp"
+#include <algorithm>
+#include <thread>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
-    using namespace aire::HWY_NAMESPACE;
 
-    template<class D, HWY_IF_U8_D(D), typename T = TFromD<D>>
-    void grayscaleHWY(D du, T *pixels, T *destination, int stride, int width, int height,
-                      const float rPrimary, const float gPrimary, const float bPrimary) {
-        const FixedTag<uint32_t, 4> du32x4;
-        const FixedTag<float32_t, 4> dfx4;
-        using VF = Vec<decltype(dfx4)>;
-        using VU = Vec<decltype(du)>;
+    /**
+     * Weighted linearized values of each channel are precomputed into 256 entry tables,
+     * so a pixel is three gathers and two adds instead of three transfer function evaluations
+     */
+    void GrayscaleRGBA(const uint8_t *pixels, uint8_t *destination, const int stride, const int width, const int height,
+                       const float rPrimary, const float gPrimary, const float bPrimary) {
+        const ScalableTag<float> df;
+        const Rebind<uint8_t, decltype(df)> du8;
+        const Rebind<int32_t, decltype(df)> di32;
+        using V8 = Vec<decltype(du8)>;
+        const int lanes = static_cast<int>(Lanes(df));
 
-        const auto vScale = Set(dfx4, 255.f);
-        const auto vRevertScale = ApproximateReciprocal(vScale);
+        const auto vScale = Set(df, 255.f);
+        HWY_ALIGN float tables[3][256];
+        const float primaries[3] = {rPrimary, gPrimary, bPrimary};
+        for (int c = 0; c < 3; ++c) {
+            const auto vPrimary = Set(df, primaries[c] * 255.f);
+            for (int i = 0; i < 256; i += lanes) {
+                const auto value = Mul(ConvertTo(df, Iota(di32, i)), Set(df, 1.f / 255.f));
+                StoreU(Mul(SRGBToLinear(df, value), vPrimary), df, tables[c] + i);
+            }
+        }
 
-        const float lumaPrimaries[4] = {rPrimary, gPrimary, bPrimary, 0.f};
-        const VF vLumaPrimaries = LoadU(dfx4, lumaPrimaries);
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
 
-        concurrency::parallel_for(2, height, [&](int y) {
-            auto dst = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(destination) + y * stride);
-            auto src = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(pixels) + y * stride);
-            for (int x = 0; x < width; ++x) {
-                VF local = Mul(ConvertTo(dfx4, PromoteTo(du32x4, LoadU(du, &src[0]))), vRevertScale);
-                VF pv = Mul(SumOfLanes(dfx4, Mul(
-                        aire::HWY_NAMESPACE::SRGBToLinear(dfx4, local),
-                        vLumaPrimaries)), vScale);
-                T pixel = ExtractLane(DemoteTo(du, ConvertTo(du32x4, pv)), 0);
-                dst[0] = pixel;
-                dst[1] = pixel;
-                dst[2] = pixel;
-                dst[3] = src[3];
-                src += 4;
-                dst += 4;
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const uint8_t *src = pixels + y * stride;
+            uint8_t *dst = destination + y * stride;
+            uint8_t tail[HWY_MAX_BYTES];
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                const uint8_t *s = src + x * 4;
+                uint8_t *d = dst + x * 4;
+                if (count < lanes) {
+                    std::copy(s, s + count * 4, tail);
+                    s = tail;
+                    d = tail;
+                }
+                V8 ru, gu, bu, au;
+                LoadInterleaved4(du8, s, ru, gu, bu, au);
+                const auto r = GatherIndex(df, tables[0], PromoteTo(di32, ru));
+                const auto g = GatherIndex(df, tables[1], PromoteTo(di32, gu));
+                const auto b = GatherIndex(df, tables[2], PromoteTo(di32, bu));
+                const auto luma = Add(r, Add(g, b));
+                const auto pixel = DemoteTo(du8, ConvertTo(di32, Clamp(luma, Zero(df), vScale)));
+                StoreInterleaved4(pixel, pixel, pixel, au, du8, d);
+                if (count < lanes) {
+                    std::copy(tail, tail + count * 4, dst + x * 4);
+                }
             }
         });
     }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(GrayscaleRGBA);
 
     void
     grayscale(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
               const float rPrimary,
               const float gPrimary, const float bPrimary) {
-        const FixedTag<uint8_t, 4> du8;
-        grayscaleHWY(du8, pixels, destination, stride, width, height, rPrimary, gPrimary,
-                     bPrimary);
+        HWY_DYNAMIC_DISPATCH(GrayscaleRGBA)(pixels, destination, stride, width, height, rPrimary, gPrimary,
+                                            bPrimary);
     }
-}
\ No newline at end of file
+}
+#endif
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <valarray>
 
 namespace aire {
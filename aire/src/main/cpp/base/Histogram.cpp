@@ -0,0 +1,233 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 26/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "Histogram.h"
+#include "concurrency.hpp"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aire {
+
+    /**
+     * Consecutive pixels go to different banks, so repeated values in flat areas don't serialize
+     * on the same counter. Large histograms don't fit cache with copies, and those use one bank
+     */
+    static const int histogramBanks = 4;
+    static const size_t histogramMaxBankedBins = 4096;
+
+    static int histogramThreadCount(const int width, const int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   height * width / (256 * 256)), 1, 12);
+    }
+
+    class HistogramBanks {
+    public:
+        explicit HistogramBanks(const size_t bins) : bins(bins),
+                                                     count(bins <= histogramMaxBankedBins ? histogramBanks : 1),
+                                                     counters(bins * count, 0) {
+            for (int i = 0; i < histogramBanks; ++i) {
+                banks[i] = counters.data() + (i % count) * bins;
+            }
+        }
+
+        // Sums all banks into destination
+        void merge(uint32_t *destination) const {
+            for (int bank = 0; bank < count; ++bank) {
+                const uint32_t *src = counters.data() + bank * bins;
+                for (size_t i = 0; i < bins; ++i) {
+                    destination[i] += src[i];
+                }
+            }
+        }
+
+        uint32_t *banks[histogramBanks];
+
+    private:
+        const size_t bins;
+        const int count;
+        std::vector<uint32_t> counters;
+    };
+
+    /**
+     * Runs rowFunction(y, banks) over per thread banks and merges them into histogram,
+     * rowFunction should put pixel x into banks[x % histogramBanks]
+     */
+    template<typename RowFunction>
+    static void accumulateHistogram(const int width, const int height, const size_t bins, uint32_t *histogram,
+                                    RowFunction &&rowFunction) {
+        std::fill(histogram, histogram + bins, 0);
+        std::mutex mergeMutex;
+        concurrency::parallel_for_segment(histogramThreadCount(width, height), height, [&](int start, int end) {
+            HistogramBanks banks(bins);
+            for (int y = start; y < end; ++y) {
+                rowFunction(y, banks.banks);
+            }
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            banks.merge(histogram);
+        });
+    }
+
+    template<typename IndexFunction>
+    static inline void histogramRow(uint32_t *const banks[histogramBanks], const int width, IndexFunction &&index) {
+        int x = 0;
+        for (; x + histogramBanks <= width; x += histogramBanks) {
+            banks[0][index(x)]++;
+            banks[1][index(x + 1)]++;
+            banks[2][index(x + 2)]++;
+            banks[3][index(x + 3)]++;
+        }
+        for (; x < width; ++x) {
+            banks[0][index(x)]++;
+        }
+    }
+
+    static inline uint8_t histogramLuma(const uint8_t *px) {
+        return static_cast<uint8_t>((px[0] * 77 + px[1] * 150 + px[2] * 29 + 128) >> 8);
+    }
+
+    void channelHistograms(const uint8_t *data, int stride, int width, int height, ChannelHistograms &histograms) {
+        const size_t bins = 256 * 5;
+        std::vector<uint32_t> histogram(bins);
+        accumulateHistogram(width, height, bins, histogram.data(), [&](int y, uint32_t *const banks[histogramBanks]) {
+            const uint8_t *row = data + y * stride;
+            auto accumulate = [](uint32_t *bank, const uint8_t *px) {
+                bank[px[0]]++;
+                bank[256 + px[1]]++;
+                bank[512 + px[2]]++;
+                bank[768 + px[3]]++;
+                bank[1024 + histogramLuma(px)]++;
+            };
+            int x = 0;
+            for (; x + histogramBanks <= width; x += histogramBanks) {
+                accumulate(banks[0], row + x * 4);
+                accumulate(banks[1], row + (x + 1) * 4);
+                accumulate(banks[2], row + (x + 2) * 4);
+                accumulate(banks[3], row + (x + 3) * 4);
+            }
+            for (; x < width; ++x) {
+                accumulate(banks[0], row + x * 4);
+            }
+        });
+        std::copy(histogram.begin(), histogram.begin() + 256, histograms.red);
+        std::copy(histogram.begin() + 256, histogram.begin() + 512, histograms.green);
+        std::copy(histogram.begin() + 512, histogram.begin() + 768, histograms.blue);
+        std::copy(histogram.begin() + 768, histogram.begin() + 1024, histograms.alpha);
+        std::copy(histogram.begin() + 1024, histogram.end(), histograms.luma);
+    }
+
+    void planeHistogram(const uint8_t *data, int stride, int width, int height, uint32_t histogram[256]) {
+        accumulateHistogram(width, height, 256, histogram, [&](int y, uint32_t *const banks[histogramBanks]) {
+            const uint8_t *row = data + y * stride;
+            histogramRow(banks, width, [row](int x) { return row[x]; });
+        });
+    }
+
+    void jointHistogram2D(const uint8_t *data, int stride, int width, int height,
+                          int channel0, int channel1, int bitsPerChannel, uint32_t *histogram) {
+        const int shift = 8 - bitsPerChannel;
+        const size_t bins = static_cast<size_t>(1) << (2 * bitsPerChannel);
+        accumulateHistogram(width, height, bins, histogram, [&](int y, uint32_t *const banks[histogramBanks]) {
+            const uint8_t *row = data + y * stride;
+            histogramRow(banks, width, [&](int x) {
+                const uint8_t *px = row + x * 4;
+                return ((px[channel0] >> shift) << bitsPerChannel) | (px[channel1] >> shift);
+            });
+        });
+    }
+
+    void jointHistogram3D(const uint8_t *data, int stride, int width, int height,
+                          int bitsPerChannel, uint32_t *histogram) {
+        const int shift = 8 - bitsPerChannel;
+        const size_t bins = static_cast<size_t>(1) << (3 * bitsPerChannel);
+        accumulateHistogram(width, height, bins, histogram, [&](int y, uint32_t *const banks[histogramBanks]) {
+            const uint8_t *row = data + y * stride;
+            histogramRow(banks, width, [&](int x) {
+                const uint8_t *px = row + x * 4;
+                return ((px[0] >> shift) << (2 * bitsPerChannel)) | ((px[1] >> shift) << bitsPerChannel) |
+                       (px[2] >> shift);
+            });
+        });
+    }
+
+    /**
+     * Tile rows are independent, so each task writes straight into its tiles. When there are fewer tile rows
+     * than threads, tile rows are cut into slices of image rows and slices are merged under a lock
+     */
+    template<typename T>
+    static void tileHistogramsImpl(const T *data, int stride, int width, int height,
+                                   int gridX, int gridY, int binsCount, uint32_t *histograms) {
+        const size_t bins = static_cast<size_t>(binsCount);
+        const int threadCount = histogramThreadCount(width, height);
+        const int slices = std::max(threadCount / gridY, 1);
+        const int tasks = gridY * slices;
+        std::fill(histograms, histograms + static_cast<size_t>(gridY) * gridX * bins, 0);
+        std::mutex mergeMutex;
+        concurrency::parallel_for(std::min(threadCount, tasks), tasks, [&](int task) {
+            const int tileY = task / slices;
+            const int slice = task % slices;
+            const int tileTop = tileY * height / gridY;
+            const int tileHeight = (tileY + 1) * height / gridY - tileTop;
+            const int top = tileTop + slice * tileHeight / slices;
+            const int bottom = tileTop + (slice + 1) * tileHeight / slices;
+            HistogramBanks banks(bins * gridX);
+            for (int tileX = 0; tileX < gridX; ++tileX) {
+                const int left = tileX * width / gridX;
+                const int right = (tileX + 1) * width / gridX;
+                uint32_t *const tileBanks[histogramBanks] = {banks.banks[0] + tileX * bins,
+                                                             banks.banks[1] + tileX * bins,
+                                                             banks.banks[2] + tileX * bins,
+                                                             banks.banks[3] + tileX * bins};
+                for (int y = top; y < bottom; ++y) {
+                    const T *row = reinterpret_cast<const T *>(reinterpret_cast<const uint8_t *>(data) + y * stride) + left;
+                    histogramRow(tileBanks, right - left, [row](int x) { return row[x]; });
+                }
+            }
+            uint32_t *tileRow = histograms + static_cast<size_t>(tileY) * gridX * bins;
+            if (slices == 1) {
+                banks.merge(tileRow);
+            } else {
+                std::lock_guard<std::mutex> lock(mergeMutex);
+                banks.merge(tileRow);
+            }
+        });
+    }
+
+    void tileHistograms(const uint8_t *data, int stride, int width, int height,
+                        int gridX, int gridY, int binsCount, uint32_t *histograms) {
+        tileHistogramsImpl(data, stride, width, height, gridX, gridY, binsCount, histograms);
+    }
+
+    void tileHistograms(const uint16_t *data, int stride, int width, int height,
+                        int gridX, int gridY, int binsCount, uint32_t *histograms) {
+        tileHistogramsImpl(data, stride, width, height, gridX, gridY, binsCount, histograms);
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 26/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace aire {
+
+    // 1D histograms of RGBA8888 collected in one pass, luma is BT.601
+    struct ChannelHistograms {
+        uint32_t red[256];
+        uint32_t green[256];
+        uint32_t blue[256];
+        uint32_t alpha[256];
+        uint32_t luma[256];
+    };
+
+    void channelHistograms(const uint8_t *data, int stride, int width, int height, ChannelHistograms &histograms);
+
+    // Single 8 bit plane
+    void planeHistogram(const uint8_t *data, int stride, int width, int height, uint32_t histogram[256]);
+
+    /**
+     * Joint histogram of two RGBA8888 channels quantized to bitsPerChannel bits,
+     * histogram holds 1 << (2 * bitsPerChannel) bins indexed as (c0 << bitsPerChannel) | c1
+     */
+    void jointHistogram2D(const uint8_t *data, int stride, int width, int height,
+                          int channel0, int channel1, int bitsPerChannel, uint32_t *histogram);
+
+    // Joint RGB histogram of 1 << (3 * bitsPerChannel) bins indexed as (r << 2 * bitsPerChannel) | (g << bitsPerChannel) | b
+    void jointHistogram3D(const uint8_t *data, int stride, int width, int height,
+                          int bitsPerChannel, uint32_t *histogram);
+
+    /**
+     * Histograms of gridX * gridY tiles for CLAHE over a plane of bin indices below binsCount,
+     * tile (x, y) histogram starts at (y * gridX + x) * binsCount. Stride is in bytes
+     */
+    void tileHistograms(const uint8_t *data, int stride, int width, int height,
+                        int gridX, int gridY, int binsCount, uint32_t *histograms);
+
+    void tileHistograms(const uint16_t *data, int stride, int width, int height,
+                        int gridX, int gridY, int binsCount, uint32_t *histograms);
+}
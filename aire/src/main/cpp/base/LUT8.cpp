@@ -30,24 +30,126 @@
 
 #include "LUT8.h"
 #include <algorithm>
+#include <thread>
 #include "concurrency.hpp"
 
+#if __aarch64__
+#include <arm_neon.h>
+#endif
+
 namespace aire {
 
     using namespace std;
 
+#if __aarch64__
+
+    /**
+     * 256 entries table takes 16 q registers, TBL covers first 64 entries
+     * and each TBX with flipped top bits fills the next 64 leaving other lanes intact.
+     * Only a single table fits in the register file next to the pixels,
+     * with per channel tables quarters are reloaded from L1 on every lookup
+     */
+    struct LUT8Neon {
+        uint8x16x4_t quarters[4];
+
+        explicit LUT8Neon(const uint8_t *table) {
+            for (int i = 0; i < 4; ++i) {
+                quarters[i] = vld1q_u8_x4(table + i * 64);
+            }
+        }
+
+        inline uint8x16_t lookup(const uint8x16_t v) const {
+            uint8x16_t result = vqtbl4q_u8(quarters[0], v);
+            result = vqtbx4q_u8(result, quarters[1], veorq_u8(v, vdupq_n_u8(0x40)));
+            result = vqtbx4q_u8(result, quarters[2], veorq_u8(v, vdupq_n_u8(0x80)));
+            result = vqtbx4q_u8(result, quarters[3], veorq_u8(v, vdupq_n_u8(0xC0)));
+            return result;
+        }
+    };
+
+#endif
+
     void LUT8::apply(uint8_t *data, int stride, int width, int height) const {
-        concurrency::parallel_for(2, height, [&](int y) {
-            auto dst = reinterpret_cast<uint8_t *>(
-                    reinterpret_cast<uint8_t *>(data) + y * stride);
-            for (int x = 0; x < width; ++x) {
-                auto src = reinterpret_cast<uint8_t *>(
-                        reinterpret_cast<uint8_t *>(data) + y * stride);
-                int px = x * 4;
-                dst[px] = this->table[clamp(src[px], uint8_t(0), uint8_t(255))];
-                dst[px + 1] = this->table[clamp(src[px + 1], uint8_t(0), uint8_t(255))];
-                dst[px + 2] = this->table[clamp(src[px + 2], uint8_t(0), uint8_t(255))];
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+#if __aarch64__
+        if (sharedTable) {
+            const LUT8Neon lut(tables[0]);
+            concurrency::parallel_for(threadCount, height, [&](int y) {
+                auto dst = reinterpret_cast<uint8_t *>(data) + y * stride;
+                int x = 0;
+                for (; x + 16 <= width; x += 16) {
+                    uint8x16x4_t pixels = vld4q_u8(dst);
+                    pixels.val[0] = lut.lookup(pixels.val[0]);
+                    pixels.val[1] = lut.lookup(pixels.val[1]);
+                    pixels.val[2] = lut.lookup(pixels.val[2]);
+                    vst4q_u8(dst, pixels);
+                    dst += 16 * 4;
+                }
+                for (; x < width; ++x) {
+                    dst[0] = this->tables[0][dst[0]];
+                    dst[1] = this->tables[0][dst[1]];
+                    dst[2] = this->tables[0][dst[2]];
+                    dst += 4;
+                }
+            });
+            return;
+        }
+        const LUT8Neon rLut(tables[0]), gLut(tables[1]), bLut(tables[2]), aLut(tables[hasAlphaTable ? 3 : 0]);
+#endif
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto dst = reinterpret_cast<uint8_t *>(data) + y * stride;
+            int x = 0;
+
+#if __aarch64__
+            for (; x + 16 <= width; x += 16) {
+                uint8x16x4_t pixels = vld4q_u8(dst);
+                pixels.val[0] = rLut.lookup(pixels.val[0]);
+                pixels.val[1] = gLut.lookup(pixels.val[1]);
+                pixels.val[2] = bLut.lookup(pixels.val[2]);
+                if (hasAlphaTable) {
+                    pixels.val[3] = aLut.lookup(pixels.val[3]);
+                }
+                vst4q_u8(dst, pixels);
+                dst += 16 * 4;
+            }
+#endif
+
+            for (; x < width; ++x) {
+                dst[0] = this->tables[0][dst[0]];
+                dst[1] = this->tables[1][dst[1]];
+                dst[2] = this->tables[2][dst[2]];
+                if (hasAlphaTable) {
+                    dst[3] = this->tables[3][dst[3]];
+                }
+                dst += 4;
+            }
+        });
+    }
+
+    void LUT8::applyPlane(uint8_t *plane, int stride, int width, int height) const {
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+#if __aarch64__
+        const LUT8Neon lut(tables[0]);
+#endif
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *dst = plane + y * stride;
+            int x = 0;
+
+#if __aarch64__
+            for (; x + 16 <= width; x += 16) {
+                vst1q_u8(dst, lut.lookup(vld1q_u8(dst)));
+                dst += 16;
+            }
+#endif
+
+            for (; x < width; ++x) {
+                dst[0] = this->tables[0][dst[0]];
+                dst += 1;
             }
         });
     }
-}
\ No newline at end of file
+}
@@ -32,16 +32,42 @@
 
 #include <memory>
 #include <cstdint>
+#include <cstring>
 
 namespace aire {
     class LUT8 {
     public:
+        // Same table for R, G and B, alpha is kept
         LUT8(uint8_t table[256]) {
-            memcpy(this->table, table, sizeof(uint8_t) * 256);
+            memcpy(this->tables[0], table, sizeof(uint8_t) * 256);
+            memcpy(this->tables[1], table, sizeof(uint8_t) * 256);
+            memcpy(this->tables[2], table, sizeof(uint8_t) * 256);
+            this->hasAlphaTable = false;
+            this->sharedTable = true;
+        }
+
+        // Per channel tables, alpha is kept when alphaTable is null
+        LUT8(const uint8_t redTable[256], const uint8_t greenTable[256], const uint8_t blueTable[256],
+             const uint8_t *alphaTable = nullptr) {
+            memcpy(this->tables[0], redTable, sizeof(uint8_t) * 256);
+            memcpy(this->tables[1], greenTable, sizeof(uint8_t) * 256);
+            memcpy(this->tables[2], blueTable, sizeof(uint8_t) * 256);
+            this->hasAlphaTable = alphaTable != nullptr;
+            if (alphaTable) {
+                memcpy(this->tables[3], alphaTable, sizeof(uint8_t) * 256);
+            }
+            this->sharedTable = !hasAlphaTable && memcmp(tables[0], tables[1], 256) == 0 &&
+                                memcmp(tables[0], tables[2], 256) == 0;
         }
 
         void apply(uint8_t *data, int stride, int width, int height) const;
+
+        // Single 8 bit plane, e.g. luma of YUV frame, through the red table
+        void applyPlane(uint8_t *plane, int stride, int width, int height) const;
+
     private:
-        uint8_t table[256];
+        uint8_t tables[4][256];
+        bool hasAlphaTable;
+        bool sharedTable;
     };
-}
\ No newline at end of file
+}
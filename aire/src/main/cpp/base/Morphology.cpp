@@ -0,0 +1,210 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 21/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "Morphology.h"
+#include "Arithmetics.h"
+#include "ArbitraryMorphology.h"
+#include "RectMorphology.h"
+#include "concurrency.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace aire {
+
+    class MorphologyElement {
+    public:
+        explicit MorphologyElement(const Eigen::MatrixXi &kernel) {
+            cols = static_cast<int>(kernel.cols());
+            rows = static_cast<int>(kernel.rows());
+            cx = cols / 2;
+            cy = rows / 2;
+            rectangle = isRectangleKernel(kernel, x0, y0, rectWidth, rectHeight);
+            se.resize(cols * rows);
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    se[i * cols + j] = kernel(i, j) != 0 ? 1 : 0;
+                }
+            }
+            extentX = std::max(cx, cols - 1 - cx);
+            extentY = std::max(cy, rows - 1 - cy);
+        }
+
+        // Tiles are already spread over the pool, so passes over a tile run on the calling thread
+        void erode(uint8_t *src, uint8_t *dst, const int stride, const int width, const int height) const {
+            if (rectangle) {
+                erodeRectRGBA(src, dst, stride, width, height, rectWidth, rectHeight, x0 - cx, y0 - cy, 1);
+            } else {
+                erodeArbitrarySE(src, dst, stride, width, height, 4, se.data(), cols, rows, cx, cy, 1);
+            }
+        }
+
+        void dilate(uint8_t *src, uint8_t *dst, const int stride, const int width, const int height) const {
+            if (rectangle) {
+                dilateRectRGBA(src, dst, stride, width, height, rectWidth, rectHeight,
+                               cx - x0 - rectWidth + 1, cy - y0 - rectHeight + 1, 1);
+            } else {
+                dilateArbitrarySE(src, dst, stride, width, height, 4, se.data(), cols, rows, cx, cy, 1);
+            }
+        }
+
+        int extentX, extentY;
+
+    private:
+        std::vector<uint8_t> se;
+        int cols, rows, cx, cy;
+        bool rectangle;
+        int x0 = 0, y0 = 0, rectWidth = 0, rectHeight = 0;
+    };
+
+    // Copies tile with halo from the image, outside pixels are produced by edge mode
+    static void fillMorphologyTile(const uint8_t *pixels, const int stride, const int width, const int height,
+                                   uint8_t *tile, const int tileStride, const int startX, const int startY,
+                                   const int tileWidth, const int tileHeight,
+                                   const EdgeMode edgeMode, const std::array<uint8_t, 4> &borderScalar) {
+        const int innerStart = std::clamp(-startX, 0, tileWidth);
+        const int innerEnd = std::clamp(width - startX, innerStart, tileWidth);
+        for (int y = 0; y < tileHeight; ++y) {
+            uint8_t *dst = tile + y * tileStride;
+            const int sy = edgeIndex(startY + y, height, edgeMode);
+            if (sy < 0) {
+                for (int x = 0; x < tileWidth; ++x) {
+                    std::memcpy(dst + x * 4, borderScalar.data(), 4);
+                }
+                continue;
+            }
+            const uint8_t *src = pixels + sy * stride;
+            for (int x = 0; x < innerStart; ++x) {
+                const int sx = edgeIndex(startX + x, width, edgeMode);
+                std::memcpy(dst + x * 4, sx < 0 ? borderScalar.data() : src + sx * 4, 4);
+            }
+            std::memcpy(dst + innerStart * 4, src + (startX + innerStart) * 4, (innerEnd - innerStart) * 4);
+            for (int x = innerEnd; x < tileWidth; ++x) {
+                const int sx = edgeIndex(startX + x, width, edgeMode);
+                std::memcpy(dst + x * 4, sx < 0 ? borderScalar.data() : src + sx * 4, 4);
+            }
+        }
+    }
+
+    void morphology(const uint8_t *pixels, uint8_t *destination, const int stride, const int width, const int height,
+                    const MorphOp op, const MorphOpMode mode, const EdgeMode edgeMode,
+                    const std::array<uint8_t, 4> borderScalar, const Eigen::MatrixXi &kernel) {
+        const MorphologyElement element(kernel);
+
+        const int passes = (op == MORPH_DILATE || op == MORPH_ERODE || op == MORPH_GRADIENT) ? 1 : 2;
+        const int haloX = element.extentX * passes;
+        const int haloY = element.extentY * passes;
+        const int tileSize = std::max(128, std::max(haloX, haloY) * 2);
+
+        const int tilesX = (width + tileSize - 1) / tileSize;
+        const int tilesY = (height + tileSize - 1) / tileSize;
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, tilesX * tilesY, [&](int tile) {
+            const int tx = (tile % tilesX) * tileSize;
+            const int ty = (tile / tilesX) * tileSize;
+            const int tw = std::min(tileSize, width - tx);
+            const int th = std::min(tileSize, height - ty);
+
+            const int pw = tw + haloX * 2;
+            const int ph = th + haloY * 2;
+            const int pStride = pw * 4;
+
+            std::vector<uint8_t> a(pStride * ph);
+            std::vector<uint8_t> b(pStride * ph);
+            std::vector<uint8_t> c;
+
+            fillMorphologyTile(pixels, stride, width, height, a.data(), pStride, tx - haloX, ty - haloY,
+                               pw, ph, edgeMode, borderScalar);
+
+            const uint8_t *result = b.data();
+            const uint8_t *subtrahend = nullptr;
+
+            switch (op) {
+                case MORPH_DILATE:
+                    element.dilate(a.data(), b.data(), pStride, pw, ph);
+                    break;
+                case MORPH_ERODE:
+                    element.erode(a.data(), b.data(), pStride, pw, ph);
+                    break;
+                case MORPH_OPENING:
+                    element.erode(a.data(), b.data(), pStride, pw, ph);
+                    element.dilate(b.data(), a.data(), pStride, pw, ph);
+                    result = a.data();
+                    break;
+                case MORPH_CLOSING:
+                    element.dilate(a.data(), b.data(), pStride, pw, ph);
+                    element.erode(b.data(), a.data(), pStride, pw, ph);
+                    result = a.data();
+                    break;
+                case MORPH_GRADIENT:
+                    c.resize(pStride * ph);
+                    element.dilate(a.data(), b.data(), pStride, pw, ph);
+                    element.erode(a.data(), c.data(), pStride, pw, ph);
+                    subtrahend = c.data();
+                    break;
+                case MORPH_TOPHAT:
+                    c.resize(pStride * ph);
+                    element.erode(a.data(), b.data(), pStride, pw, ph);
+                    element.dilate(b.data(), c.data(), pStride, pw, ph);
+                    result = a.data();
+                    subtrahend = c.data();
+                    break;
+                case MORPH_BLACKHAT:
+                    c.resize(pStride * ph);
+                    element.dilate(a.data(), b.data(), pStride, pw, ph);
+                    element.erode(b.data(), c.data(), pStride, pw, ph);
+                    result = c.data();
+                    subtrahend = a.data();
+                    break;
+            }
+
+            const int innerOffset = haloY * pStride + haloX * 4;
+            for (int y = 0; y < th; ++y) {
+                uint8_t *dst = destination + (ty + y) * stride + tx * 4;
+                const uint8_t *resultRow = result + innerOffset + y * pStride;
+                if (subtrahend) {
+                    diffRow(dst, resultRow, subtrahend + innerOffset + y * pStride, tw * 4);
+                } else {
+                    std::memcpy(dst, resultRow, tw * 4);
+                }
+                if (mode == MORPH_OP_RGB) {
+                    const uint8_t *src = pixels + (ty + y) * stride + tx * 4;
+                    for (int x = 0; x < tw; ++x) {
+                        dst[x * 4 + 3] = src[x * 4 + 3];
+                    }
+                }
+            }
+        });
+    }
+}
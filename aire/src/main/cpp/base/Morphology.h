@@ -0,0 +1,64 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 21/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Eigen/Eigen"
+#include "EdgeMode.h"
+
+namespace aire {
+
+    enum MorphOp {
+        MORPH_DILATE = 0,
+        MORPH_ERODE = 1,
+        MORPH_OPENING = 2,
+        MORPH_CLOSING = 3,
+        MORPH_GRADIENT = 4,
+        MORPH_TOPHAT = 5,
+        MORPH_BLACKHAT = 6
+    };
+
+    enum MorphOpMode {
+        MORPH_OP_RGB = 0,
+        MORPH_OP_RGBA = 1
+    };
+
+    /**
+     * Composite morphology on RGBA image, kernel origin is its center, non zero entries belongs to the element.
+     * Image processed by tiles, every tile runs all erosion/dilation passes over own scratch and
+     * final subtraction is written directly to destination. In MORPH_OP_RGB mode alpha is copied from the source.
+     * Destination must not alias pixels
+     */
+    void morphology(const uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                    MorphOp op, MorphOpMode mode, EdgeMode edgeMode, std::array<uint8_t, 4> borderScalar,
+                    const Eigen::MatrixXi &kernel);
+}
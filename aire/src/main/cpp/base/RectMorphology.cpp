@@ -0,0 +1,266 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/RectMorphology.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "RectMorphology.h"
+#include "concurrency.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    template<bool isMax>
+    HWY_INLINE void VanHerkCombine(uint8_t *HWY_RESTRICT dst, const uint8_t *a, const uint8_t *b, const int span) {
+        const ScalableTag<uint8_t> du8;
+        const int lanes = static_cast<int>(Lanes(du8));
+        int i = 0;
+        for (; i + lanes <= span; i += lanes) {
+            const auto va = LoadU(du8, a + i);
+            const auto vb = LoadU(du8, b + i);
+            if constexpr (isMax) {
+                StoreU(Max(va, vb), du8, dst + i);
+            } else {
+                StoreU(Min(va, vb), du8, dst + i);
+            }
+        }
+        // Horizontal elements are 16 bytes, narrower than full vectors on wide targets
+        const CappedTag<uint8_t, 16> du8x16;
+        const int lanes16 = static_cast<int>(Lanes(du8x16));
+        for (; i + lanes16 <= span; i += lanes16) {
+            const auto va = LoadU(du8x16, a + i);
+            const auto vb = LoadU(du8x16, b + i);
+            if constexpr (isMax) {
+                StoreU(Max(va, vb), du8x16, dst + i);
+            } else {
+                StoreU(Min(va, vb), du8x16, dst + i);
+            }
+        }
+        for (; i < span; ++i) {
+            if constexpr (isMax) {
+                dst[i] = std::max(a[i], b[i]);
+            } else {
+                dst[i] = std::min(a[i], b[i]);
+            }
+        }
+    }
+
+    /**
+     * Runs 1D van Herk/Gil-Werman min/max over n elements of span bytes each,
+     * element x receives op over source elements [x + offset, x + offset + k - 1],
+     * elements outside [0, n) are treated as neutral.
+     * g and h must hold at least (n + |offset| + k) * span bytes
+     */
+    template<bool isMax, class Source, class Sink>
+    HWY_INLINE void VanHerkGilWerman(const int n, const int k, const int offset, const int span,
+                                     Source source, Sink sink,
+                                     uint8_t *g, uint8_t *h, const uint8_t *neutral) {
+        const int start = std::min(0, offset);
+        const int end = std::max(n - 1, n - 1 + offset + k - 1);
+        const int length = end - start + 1;
+
+        auto f = [&](int q) -> const uint8_t * {
+            const int x = start + q;
+            return (x >= 0 && x < n) ? source(x) : neutral;
+        };
+
+        for (int q = 0; q < length; ++q) {
+            if (q % k == 0) {
+                std::memcpy(g + q * span, f(q), span);
+            } else {
+                VanHerkCombine<isMax>(g + q * span, g + (q - 1) * span, f(q), span);
+            }
+        }
+
+        for (int q = length - 1; q >= 0; --q) {
+            if (q == length - 1 || q % k == k - 1) {
+                std::memcpy(h + q * span, f(q), span);
+            } else {
+                VanHerkCombine<isMax>(h + q * span, h + (q + 1) * span, f(q), span);
+            }
+        }
+
+        for (int x = 0; x < n; ++x) {
+            const int a = x + offset - start;
+            VanHerkCombine<isMax>(sink(x), h + a * span, g + (a + k - 1) * span, span);
+        }
+    }
+
+    template<bool isMax>
+    void RectMorphologyRGBA(uint8_t *pixels, uint8_t *destination, const int stride, const int width,
+                            const int height, const int kernelWidth, const int kernelHeight,
+                            const int offsetX, const int offsetY, const int threads) {
+        const uint8_t neutralValue = isMax ? 0 : 255;
+        const int threadCount = threads > 0 ? threads : std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        // Horizontal pass: 4 rows are interleaved so each element is a 16 bytes vector of 4 pixels
+        constexpr int groupRows = 4;
+        constexpr int hSpan = groupRows * 4;
+        const int hLength = width + std::abs(offsetX) + kernelWidth;
+
+        if (kernelWidth == 1 && offsetX == 0) {
+            if (pixels != destination) {
+                for (int y = 0; y < height; ++y) {
+                    std::memcpy(destination + y * stride, pixels + y * stride, width * 4);
+                }
+            }
+        } else {
+            const int groups = (height + groupRows - 1) / groupRows;
+            concurrency::parallel_for(threadCount, groups, [&](int group) {
+                std::vector<uint8_t> lanes(width * hSpan);
+                std::vector<uint8_t> g(hLength * hSpan);
+                std::vector<uint8_t> h(hLength * hSpan);
+                uint8_t neutral[hSpan];
+                std::fill(neutral, neutral + hSpan, neutralValue);
+
+                const int y0 = group * groupRows;
+                for (int r = 0; r < groupRows; ++r) {
+                    const int y = std::min(y0 + r, height - 1);
+                    auto src = reinterpret_cast<const uint32_t *>(pixels + y * stride);
+                    for (int x = 0; x < width; ++x) {
+                        std::memcpy(lanes.data() + x * hSpan + r * 4, &src[x], 4);
+                    }
+                }
+
+                VanHerkGilWerman<isMax>(width, kernelWidth, offsetX, hSpan,
+                                        [&](int x) -> const uint8_t * { return lanes.data() + x * hSpan; },
+                                        [&](int x) -> uint8_t * { return lanes.data() + x * hSpan; },
+                                        g.data(), h.data(), neutral);
+
+                for (int r = 0; r < groupRows && y0 + r < height; ++r) {
+                    auto dst = reinterpret_cast<uint32_t *>(destination + (y0 + r) * stride);
+                    for (int x = 0; x < width; ++x) {
+                        std::memcpy(&dst[x], lanes.data() + x * hSpan + r * 4, 4);
+                    }
+                }
+            });
+        }
+
+        if (kernelHeight == 1 && offsetY == 0) {
+            return;
+        }
+
+        // Vertical pass works in place over column strips, rows of strip are contiguous so no gathering required
+        constexpr int stripBytes = 256;
+        const int rowBytes = width * 4;
+        const int strips = (rowBytes + stripBytes - 1) / stripBytes;
+        const int vLength = height + std::abs(offsetY) + kernelHeight;
+        const int stripThreads = std::clamp(std::min(threadCount, strips), 1, 12);
+
+        concurrency::parallel_for(stripThreads, strips, [&](int strip) {
+            const int stripStart = strip * stripBytes;
+            const int span = std::min(stripBytes, rowBytes - stripStart);
+            std::vector<uint8_t> g(vLength * span);
+            std::vector<uint8_t> h(vLength * span);
+            uint8_t neutral[stripBytes];
+            std::fill(neutral, neutral + stripBytes, neutralValue);
+
+            VanHerkGilWerman<isMax>(height, kernelHeight, offsetY, span,
+                                    [&](int y) -> const uint8_t * { return destination + y * stride + stripStart; },
+                                    [&](int y) -> uint8_t * { return destination + y * stride + stripStart; },
+                                    g.data(), h.data(), neutral);
+        });
+    }
+
+    void ErodeRectRGBA(uint8_t *pixels, uint8_t *destination, const int stride, const int width,
+                       const int height, const int kernelWidth, const int kernelHeight,
+                       const int offsetX, const int offsetY, const int threadCount) {
+        RectMorphologyRGBA<false>(pixels, destination, stride, width, height,
+                                  kernelWidth, kernelHeight, offsetX, offsetY, threadCount);
+    }
+
+    void DilateRectRGBA(uint8_t *pixels, uint8_t *destination, const int stride, const int width,
+                        const int height, const int kernelWidth, const int kernelHeight,
+                        const int offsetX, const int offsetY, const int threadCount) {
+        RectMorphologyRGBA<true>(pixels, destination, stride, width, height,
+                                 kernelWidth, kernelHeight, offsetX, offsetY, threadCount);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(ErodeRectRGBA);
+    HWY_EXPORT(DilateRectRGBA);
+
+    void erodeRectRGBA(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                       int kernelWidth, int kernelHeight, int offsetX, int offsetY, int threadCount) {
+        HWY_DYNAMIC_DISPATCH(ErodeRectRGBA)(pixels, destination, stride, width, height,
+                                            kernelWidth, kernelHeight, offsetX, offsetY, threadCount);
+    }
+
+    void dilateRectRGBA(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                        int kernelWidth, int kernelHeight, int offsetX, int offsetY, int threadCount) {
+        HWY_DYNAMIC_DISPATCH(DilateRectRGBA)(pixels, destination, stride, width, height,
+                                             kernelWidth, kernelHeight, offsetX, offsetY, threadCount);
+    }
+
+    bool isRectangleKernel(const Eigen::MatrixXi &kernel, int &x0, int &y0, int &rectWidth, int &rectHeight) {
+        int minX = static_cast<int>(kernel.cols()), minY = static_cast<int>(kernel.rows());
+        int maxX = -1, maxY = -1;
+        for (int i = 0; i < kernel.rows(); ++i) {
+            for (int j = 0; j < kernel.cols(); ++j) {
+                if (kernel(i, j) != 0) {
+                    minX = std::min(minX, j);
+                    maxX = std::max(maxX, j);
+                    minY = std::min(minY, i);
+                    maxY = std::max(maxY, i);
+                }
+            }
+        }
+        if (maxX < 0) {
+            return false;
+        }
+        for (int i = minY; i <= maxY; ++i) {
+            for (int j = minX; j <= maxX; ++j) {
+                if (kernel(i, j) == 0) {
+                    return false;
+                }
+            }
+        }
+        x0 = minX;
+        y0 = minY;
+        rectWidth = maxX - minX + 1;
+        rectHeight = maxY - minY + 1;
+        return true;
+    }
+}
+#endif
@@ -0,0 +1,50 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "Eigen/Eigen"
+
+namespace aire {
+
+    // Van Herk/Gil-Werman min/max filtering over a rectangle of kernelWidth x kernelHeight,
+    // window for pixel (x, y) spans [x + offsetX, x + offsetX + kernelWidth - 1] and the same vertically.
+    // Costs 3 comparisons per pixel and channel regardless of the rectangle size, lines are rectangles with one side 1.
+    // threadCount 0 picks threads by image size, callers already running on pool threads pass 1
+    void erodeRectRGBA(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                       int kernelWidth, int kernelHeight, int offsetX, int offsetY, int threadCount = 0);
+
+    void dilateRectRGBA(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                        int kernelWidth, int kernelHeight, int offsetX, int offsetY, int threadCount = 0);
+
+    // Checks if non-zero kernel entries form single solid rectangle ( or line ) and returns it bounds
+    bool isRectangleKernel(const Eigen::MatrixXi &kernel, int &x0, int &y0, int &rectWidth, int &rectHeight);
+}
@@ -28,32 +28,138 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Vibrance.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "Vibrance.h"
+#include "conversion/attenuate-inl.h"
 #include <algorithm>
-#include "fast_math-inl.h"
+#include <cmath>
+#include <thread>
 #include "MathUtils.hpp"
 #include "concurrency.hpp"
 
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void VibrancePixels(const D di16, V r, V g, V b, const V vibranceQ10, V &dr, V &dg, V &db) {
+        // Sum fits 765, and multiplying by 65536/3 in high half is exact floor division here
+        const auto average = MulHigh(Add(r, Add(g, b)), Set(di16, 21846));
+        const auto difference = Sub(Max(r, Max(g, b)), average);
+        const auto limit = Set(di16, 255);
+        const auto boost = Clamp(MulHigh(ShiftLeft<6>(difference), vibranceQ10), Neg(limit), limit);
+        dr = Add(r, boost);
+        dg = Add(g, boost);
+        db = Add(b, boost);
+    }
+
+    // Premultiplied pixels are unpremultiplied in i16 lanes and premultiplied back before narrowing
+    void VibranceRGBA(uint8_t *pixels, const int stride, const int width, const int height, const float vibrance,
+                      const bool premultiplied) {
+        const ScalableTag<uint8_t> du8;
+        const Repartition<int16_t, decltype(du8)> di16;
+        using V8 = Vec<decltype(du8)>;
+        const int lanes = static_cast<int>(Lanes(du8));
+        const auto vibranceQ10 = Set(di16, static_cast<int16_t>(std::lround(vibrance * 1024.f)));
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *data = pixels + y * stride;
+            uint8_t tail[HWY_MAX_BYTES * 4];
+            const auto zeros = Zero(di16);
+            const auto vMax = Set(di16, 255);
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                uint8_t *px = data + x * 4;
+                if (count < lanes) {
+                    std::copy(px, px + count * 4, tail);
+                    px = tail;
+                }
+                V8 r, g, b, a;
+                LoadInterleaved4(du8, px, r, g, b, a);
+                auto rl = PromoteLowerTo(di16, r);
+                auto gl = PromoteLowerTo(di16, g);
+                auto bl = PromoteLowerTo(di16, b);
+                auto rh = PromoteUpperTo(di16, r);
+                auto gh = PromoteUpperTo(di16, g);
+                auto bh = PromoteUpperTo(di16, b);
+                const bool attenuated = premultiplied && !AllTrue(du8, Eq(a, Set(du8, 255)));
+                const auto al = PromoteLowerTo(di16, a);
+                const auto ah = PromoteUpperTo(di16, a);
+                if (attenuated) {
+                    rl = UnattenuateVec16(di16, rl, al);
+                    gl = UnattenuateVec16(di16, gl, al);
+                    bl = UnattenuateVec16(di16, bl, al);
+                    rh = UnattenuateVec16(di16, rh, ah);
+                    gh = UnattenuateVec16(di16, gh, ah);
+                    bh = UnattenuateVec16(di16, bh, ah);
+                }
+                VibrancePixels(di16, rl, gl, bl, vibranceQ10, rl, gl, bl);
+                VibrancePixels(di16, rh, gh, bh, vibranceQ10, rh, gh, bh);
+                if (attenuated) {
+                    rl = AttenuateVec16(di16, Clamp(rl, zeros, vMax), al);
+                    gl = AttenuateVec16(di16, Clamp(gl, zeros, vMax), al);
+                    bl = AttenuateVec16(di16, Clamp(bl, zeros, vMax), al);
+                    rh = AttenuateVec16(di16, Clamp(rh, zeros, vMax), ah);
+                    gh = AttenuateVec16(di16, Clamp(gh, zeros, vMax), ah);
+                    bh = AttenuateVec16(di16, Clamp(bh, zeros, vMax), ah);
+                }
+                r = OrderedDemote2To(du8, rl, rh);
+                g = OrderedDemote2To(du8, gl, gh);
+                b = OrderedDemote2To(du8, bl, bh);
+                StoreInterleaved4(r, g, b, a, du8, px);
+                if (count < lanes) {
+                    std::copy(tail, tail + count * 4, data + x * 4);
+                }
+            }
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
 namespace aire {
-    void vibrance(uint8_t *pixels, int stride, int width, int height, float vibrance) {
+    HWY_EXPORT(VibranceRGBA);
+
+    void vibrance(uint8_t *pixels, int stride, int width, int height, float vibrance, bool premultiplied) {
+        // Q10 multiplier has to fit into i16
+        if (std::abs(vibrance) < 31.f) {
+            HWY_DYNAMIC_DISPATCH(VibranceRGBA)(pixels, stride, width, height, vibrance, premultiplied);
+            return;
+        }
         concurrency::parallel_for(2, height, [&](int y) {
             auto data = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(pixels) + y * stride);
             int x = 0;
 
             for (; x < width; ++x) {
-                int red = data[0];
-                int green = data[1];
-                int blue = data[2];
+                const int alpha = premultiplied ? data[3] : 255;
+                if (alpha == 0) {
+                    data += 4;
+                    continue;
+                }
+                int red = std::min((data[0] * 255 + alpha / 2) / alpha, 255);
+                int green = std::min((data[1] * 255 + alpha / 2) / alpha, 255);
+                int blue = std::min((data[2] * 255 + alpha / 2) / alpha, 255);
 
                 int avgIntensity = (red + green + blue) / 3;
                 int mx = max3(red, green, blue);
                 int vibranceBoost = std::clamp((float(mx) - avgIntensity) * vibrance, -255.f, 255.f);
 
-                data[0] = std::clamp(red + vibranceBoost, 0, 255);
-                data[1] = std::clamp(green + vibranceBoost, 0, 255);
-                data[2] = std::clamp(blue + vibranceBoost, 0, 255);
+                data[0] = (std::clamp(red + vibranceBoost, 0, 255) * alpha + 127) / 255;
+                data[1] = (std::clamp(green + vibranceBoost, 0, 255) * alpha + 127) / 255;
+                data[2] = (std::clamp(blue + vibranceBoost, 0, 255) * alpha + 127) / 255;
                 data += 4;
             }
         });
     }
-}
\ No newline at end of file
+}
+#endif
@@ -33,5 +33,6 @@
 #include <cstdint>
 
 namespace aire {
-    void vibrance(uint8_t *pixels, int stride, int width, int height, float vibrance);
+    // Premultiplied pixels are unpremultiplied and premultiplied back in registers
+    void vibrance(uint8_t *pixels, int stride, int width, int height, float vibrance, bool premultiplied = false);
 }
\ No newline at end of file
@@ -0,0 +1,418 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 18/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "BilateralGrid.h"
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include "HalfFloats.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "blur/BilateralGrid.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "color/eotf-inl.h"
+#include "concurrency.hpp"
+#include "MathUtils.hpp"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static const float bilateralLumaR = 0.299f;
+    static const float bilateralLumaG = 0.587f;
+    static const float bilateralLumaB = 0.114f;
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE V LoadBilateralPixel(D df, const uint8_t *src) {
+        const FixedTag<uint8_t, 4> du8x4;
+        const FixedTag<uint32_t, 4> du32x4;
+        return ConvertTo(df, PromoteTo(du32x4, LoadU(du8x4, src)));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE V LoadBilateralPixel(D df, const uint16_t *src) {
+        const FixedTag<uint16_t, 4> du16x4;
+        const FixedTag<hwy::float16_t, 4> df16x4;
+        return PromoteTo(df, BitCast(df16x4, LoadU(du16x4, src)));
+    }
+
+    HWY_INLINE float BilateralGuide(const uint8_t *src) {
+        return (src[0] * bilateralLumaR + src[1] * bilateralLumaG + src[2] * bilateralLumaB) * (1.f / 255.f);
+    }
+
+    HWY_INLINE float BilateralGuide(const uint16_t *src) {
+        const float luma = half_to_float(src[0]) * bilateralLumaR + half_to_float(src[1]) * bilateralLumaG
+                           + half_to_float(src[2]) * bilateralLumaB;
+        return std::clamp(luma, 0.f, 1.f);
+    }
+
+    template<class T>
+    void BilateralGridSplatRow(const T *src, const int width, float *gridRow,
+                               const int gridWidth, const int gridDepth,
+                               const float invSpatial, const float invRange,
+                               const int padding, const float scale, const bool linearLight) {
+        const FixedTag<float32_t, 4> dfx4;
+        using VF = Vec<decltype(dfx4)>;
+        const VF vScale = Set(dfx4, scale);
+        const VF zeros = Zero(dfx4);
+        const auto lastLane = FirstN(dfx4, 3);
+        const VF ones = Set(dfx4, 1.f);
+        const int maxZ = gridDepth - 1;
+
+        for (int x = 0; x < width; ++x) {
+            const int gx = static_cast<int>(std::lround(static_cast<float>(x) * invSpatial)) + padding;
+            const int gz = std::min(static_cast<int>(std::lround(BilateralGuide(src) * invRange)) + padding, maxZ);
+            VF pixel = Mul(LoadBilateralPixel(dfx4, src), vScale);
+            if (linearLight) {
+                pixel = aire::HWY_NAMESPACE::SRGBToLinear(dfx4, Max(pixel, zeros));
+            }
+            pixel = IfThenElse(lastLane, pixel, ones);
+            float *cell = gridRow + (gz * gridWidth + gx) * 4;
+            StoreU(Add(LoadU(dfx4, cell), pixel), dfx4, cell);
+            src += 4;
+        }
+    }
+
+    void BilateralGridSplatRowU8(const uint8_t *src, const int width, float *gridRow,
+                                 const int gridWidth, const int gridDepth,
+                                 const float invSpatial, const float invRange,
+                                 const int padding, const bool linearLight) {
+        BilateralGridSplatRow(src, width, gridRow, gridWidth, gridDepth, invSpatial, invRange,
+                              padding, 1.f / 255.f, linearLight);
+    }
+
+    void BilateralGridSplatRowF16(const uint16_t *src, const int width, float *gridRow,
+                                  const int gridWidth, const int gridDepth,
+                                  const float invSpatial, const float invRange,
+                                  const int padding, const bool linearLight) {
+        BilateralGridSplatRow(src, width, gridRow, gridWidth, gridDepth, invSpatial, invRange,
+                              padding, 1.f, linearLight);
+    }
+
+    // Convolves `run` adjacent cell lines of length `n`, each step along the axis is `axisStride` cells
+    void BilateralGridBlurLines(const float *src, float *dst, const int n, const int axisStride, const int run,
+                                const float *kernel, const int kernelSize) {
+        const FixedTag<float32_t, 4> dfx4;
+        using VF = Vec<decltype(dfx4)>;
+        const int half = kernelSize / 2;
+
+        for (int i = 0; i < n; ++i) {
+            const int kStart = std::max(0, half - i);
+            const int kEnd = std::min(kernelSize, n - i + half);
+            float *dstLine = dst + i * axisStride * 4;
+            for (int c = 0; c < run; ++c) {
+                VF store = Zero(dfx4);
+                for (int k = kStart; k < kEnd; ++k) {
+                    const float *cell = src + ((i + k - half) * axisStride + c) * 4;
+                    store = MulAdd(LoadU(dfx4, cell), Set(dfx4, kernel[k]), store);
+                }
+                StoreU(store, dfx4, dstLine + c * 4);
+            }
+        }
+    }
+
+    HWY_INLINE void StoreBilateralPixel(Vec<FixedTag<float32_t, 4>> color, uint8_t *dst) {
+        const FixedTag<float32_t, 4> dfx4;
+        const FixedTag<uint8_t, 4> du8x4;
+        const FixedTag<uint32_t, 4> du32x4;
+        const uint8_t alpha = dst[3];
+        color = Min(Round(color), Set(dfx4, 255.f));
+        StoreU(DemoteTo(du8x4, ConvertTo(du32x4, color)), du8x4, dst);
+        dst[3] = alpha;
+    }
+
+    HWY_INLINE void StoreBilateralPixel(Vec<FixedTag<float32_t, 4>> color, uint16_t *dst) {
+        const FixedTag<uint16_t, 4> du16x4;
+        const FixedTag<hwy::float16_t, 4> df16x4;
+        const uint16_t alpha = dst[3];
+        StoreU(BitCast(du16x4, DemoteTo(df16x4, color)), du16x4, dst);
+        dst[3] = alpha;
+    }
+
+    template<typename V>
+    HWY_INLINE V BilateralLerp(V a, V b, V t) {
+        return MulAdd(t, Sub(b, a), a);
+    }
+
+    template<class T>
+    void BilateralGridSliceRow(T *row, const int width, const float *grid,
+                               const int gridWidth, const int gridHeight, const int gridDepth,
+                               const float fy, const float invSpatial, const float invRange,
+                               const int padding, const float scale, const bool linearLight) {
+        const FixedTag<float32_t, 4> dfx4;
+        using VF = Vec<decltype(dfx4)>;
+        const int planeStride = gridDepth * gridWidth;
+
+        const int y0 = std::min(static_cast<int>(fy), gridHeight - 2);
+        const VF ty = Set(dfx4, fy - static_cast<float>(y0));
+        const float *planeTop = grid + y0 * planeStride * 4;
+        const float *planeBottom = planeTop + planeStride * 4;
+        const VF zeros = Zero(dfx4);
+        const VF minWeight = Set(dfx4, 1e-6f);
+        const VF vScale = Set(dfx4, scale);
+
+        for (int x = 0; x < width; ++x) {
+            const float fx = static_cast<float>(x) * invSpatial + static_cast<float>(padding);
+            const float fz = BilateralGuide(row) * invRange + static_cast<float>(padding);
+            const int x0 = std::min(static_cast<int>(fx), gridWidth - 2);
+            const int z0 = std::min(static_cast<int>(fz), gridDepth - 2);
+            const VF tx = Set(dfx4, fx - static_cast<float>(x0));
+            const VF tz = Set(dfx4, fz - static_cast<float>(z0));
+
+            const int c000 = (z0 * gridWidth + x0) * 4;
+            const int c001 = c000 + 4;
+            const int c010 = c000 + gridWidth * 4;
+            const int c011 = c010 + 4;
+
+            const VF top0 = BilateralLerp(LoadU(dfx4, planeTop + c000), LoadU(dfx4, planeTop + c001), tx);
+            const VF top1 = BilateralLerp(LoadU(dfx4, planeTop + c010), LoadU(dfx4, planeTop + c011), tx);
+            const VF bottom0 = BilateralLerp(LoadU(dfx4, planeBottom + c000), LoadU(dfx4, planeBottom + c001), tx);
+            const VF bottom1 = BilateralLerp(LoadU(dfx4, planeBottom + c010), LoadU(dfx4, planeBottom + c011), tx);
+
+            const VF top = BilateralLerp(top0, top1, tz);
+            const VF bottom = BilateralLerp(bottom0, bottom1, tz);
+            const VF cell = BilateralLerp(top, bottom, ty);
+
+            const VF weight = Max(Broadcast<3>(cell), minWeight);
+            VF color = Max(Div(cell, weight), zeros);
+            if (linearLight) {
+                color = aire::HWY_NAMESPACE::LinearSRGBTosRGB(dfx4, color);
+            }
+            color = Mul(color, vScale);
+
+            StoreBilateralPixel(color, row);
+            row += 4;
+        }
+    }
+
+
+    void BilateralGridSliceRowU8(uint8_t *row, const int width, const float *grid,
+                                 const int gridWidth, const int gridHeight, const int gridDepth,
+                                 const float fy, const float invSpatial, const float invRange,
+                                 const int padding, const bool linearLight) {
+        BilateralGridSliceRow(row, width, grid, gridWidth, gridHeight, gridDepth, fy, invSpatial, invRange,
+                              padding, 255.f, linearLight);
+    }
+
+    void BilateralGridSliceRowF16(uint16_t *row, const int width, const float *grid,
+                                  const int gridWidth, const int gridHeight, const int gridDepth,
+                                  const float fy, const float invSpatial, const float invRange,
+                                  const int padding, const bool linearLight) {
+        BilateralGridSliceRow(row, width, grid, gridWidth, gridHeight, gridDepth, fy, invSpatial, invRange,
+                              padding, 1.f, linearLight);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(BilateralGridSplatRowU8);
+    HWY_EXPORT(BilateralGridSplatRowF16);
+    HWY_EXPORT(BilateralGridBlurLines);
+    HWY_EXPORT(BilateralGridSliceRowU8);
+    HWY_EXPORT(BilateralGridSliceRowF16);
+
+    static const int bilateralGridPadding = 1;
+    // Cells of one grid, three grids of RGBW floats take 96 MB at most
+    static const double bilateralGridCellBudget = 1 << 21;
+
+    // Coarsens spatial sampling when requested one would exceed the cell budget on large images
+    static float bilateralGridSpatialSampling(int width, int height, float spatialSampling, float rangeSampling) {
+        const float sampling = std::max(spatialSampling, 1.f);
+        const double depth = std::ceil(255.f / std::clamp(rangeSampling, 1.f, 255.f)) + 1 + 2 * bilateralGridPadding;
+        const double planeBudget = bilateralGridCellBudget / depth;
+        // Padding and the extra node take up to (1 + 2 * padding) cells on each side
+        const double padded = 1 + 2 * bilateralGridPadding + 1;
+        auto cells = [&](const double s) {
+            return (std::ceil(width / s) + padded) * (std::ceil(height / s) + padded);
+        };
+        if (cells(sampling) <= planeBudget) {
+            return sampling;
+        }
+        double minimum = std::max(static_cast<double>(sampling),
+                                  std::sqrt(static_cast<double>(width) * height / planeBudget));
+        while (cells(minimum) > planeBudget) {
+            minimum *= 1.05;
+        }
+        return static_cast<float>(minimum);
+    }
+
+    BilateralGrid::BilateralGrid(int width, int height, float spatialSampling, float rangeSampling, bool linearLight) :
+            width(width), height(height),
+            spatialSampling(bilateralGridSpatialSampling(width, height, spatialSampling, rangeSampling)),
+            rangeSampling(std::clamp(rangeSampling, 1.f, 255.f) / 255.f),
+            linearLight(linearLight) {
+        gridWidth = static_cast<int>(std::ceil(static_cast<float>(width - 1) / this->spatialSampling)) + 1 + 2 * bilateralGridPadding;
+        gridHeight = static_cast<int>(std::ceil(static_cast<float>(height - 1) / this->spatialSampling)) + 1 + 2 * bilateralGridPadding;
+        gridDepth = static_cast<int>(std::ceil(1.f / this->rangeSampling)) + 1 + 2 * bilateralGridPadding;
+
+        const size_t cells = static_cast<size_t>(gridWidth) * gridHeight * gridDepth * 4;
+        splatted.resize(cells);
+        blurred.resize(cells);
+        transient.resize(cells);
+
+        // Nearest splatting maps every image row to exactly one grid row,
+        // so grid rows may be filled concurrently without synchronization
+        const float invSpatial = 1.f / this->spatialSampling;
+        rowStart.resize(gridHeight, 0);
+        rowEnd.resize(gridHeight, 0);
+        for (int y = 0; y < height; ++y) {
+            const int gy = static_cast<int>(std::lround(static_cast<float>(y) * invSpatial)) + bilateralGridPadding;
+            if (rowEnd[gy] == rowStart[gy]) {
+                rowStart[gy] = y;
+            }
+            rowEnd[gy] = y + 1;
+        }
+    }
+
+    void BilateralGrid::clearSplat() {
+        std::fill(splatted.begin(), splatted.end(), 0.f);
+    }
+
+    void BilateralGrid::splat(const uint8_t *data, int stride) {
+        clearSplat();
+        const float invSpatial = 1.f / spatialSampling;
+        const float invRange = 1.f / rangeSampling;
+        const int planeSize = gridDepth * gridWidth * 4;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, gridHeight, [&](int gy) {
+            for (int y = rowStart[gy]; y < rowEnd[gy]; ++y) {
+                auto src = data + y * stride;
+                HWY_DYNAMIC_DISPATCH(BilateralGridSplatRowU8)(src, width, splatted.data() + gy * planeSize,
+                                                              gridWidth, gridDepth, invSpatial, invRange,
+                                                              bilateralGridPadding, linearLight);
+            }
+        });
+    }
+
+    void BilateralGrid::splat(const uint16_t *data, int stride) {
+        clearSplat();
+        const float invSpatial = 1.f / spatialSampling;
+        const float invRange = 1.f / rangeSampling;
+        const int planeSize = gridDepth * gridWidth * 4;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, gridHeight, [&](int gy) {
+            for (int y = rowStart[gy]; y < rowEnd[gy]; ++y) {
+                auto src = reinterpret_cast<const uint16_t *>(reinterpret_cast<const uint8_t *>(data) + y * stride);
+                HWY_DYNAMIC_DISPATCH(BilateralGridSplatRowF16)(src, width, splatted.data() + gy * planeSize,
+                                                               gridWidth, gridDepth, invSpatial, invRange,
+                                                               bilateralGridPadding, linearLight);
+            }
+        });
+    }
+
+    void BilateralGrid::blur(float spatialSigma, float rangeSigma) {
+        const float spatialCells = std::max(spatialSigma / spatialSampling, 0.5f);
+        const float rangeCells = std::max((rangeSigma / 255.f) / rangeSampling, 0.5f);
+        const int spatialSize = 2 * static_cast<int>(std::ceil(2.f * spatialCells)) + 1;
+        const int rangeSize = 2 * static_cast<int>(std::ceil(2.f * rangeCells)) + 1;
+        const std::vector<float> spatialKernel = compute1DGaussianKernel(spatialSize, spatialCells);
+        const std::vector<float> rangeKernel = compute1DGaussianKernel(rangeSize, rangeCells);
+
+        const int planeSize = gridDepth * gridWidth;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    gridHeight * planeSize / (64 * 64)), 1, 12);
+
+        // x axis: splatted -> blurred
+        concurrency::parallel_for(threadCount, gridHeight * gridDepth, [&](int line) {
+            HWY_DYNAMIC_DISPATCH(BilateralGridBlurLines)(splatted.data() + line * gridWidth * 4,
+                                                         blurred.data() + line * gridWidth * 4,
+                                                         gridWidth, 1, 1,
+                                                         spatialKernel.data(), static_cast<int>(spatialKernel.size()));
+        });
+
+        // range axis: blurred -> transient
+        concurrency::parallel_for(threadCount, gridHeight, [&](int gy) {
+            HWY_DYNAMIC_DISPATCH(BilateralGridBlurLines)(blurred.data() + gy * planeSize * 4,
+                                                         transient.data() + gy * planeSize * 4,
+                                                         gridDepth, gridWidth, gridWidth,
+                                                         rangeKernel.data(), static_cast<int>(rangeKernel.size()));
+        });
+
+        // y axis: transient -> blurred
+        concurrency::parallel_for(threadCount, gridDepth, [&](int gz) {
+            HWY_DYNAMIC_DISPATCH(BilateralGridBlurLines)(transient.data() + gz * gridWidth * 4,
+                                                         blurred.data() + gz * gridWidth * 4,
+                                                         gridHeight, planeSize, gridWidth,
+                                                         spatialKernel.data(), static_cast<int>(spatialKernel.size()));
+        });
+    }
+
+    void BilateralGrid::slice(uint8_t *data, int stride) const {
+        const float invSpatial = 1.f / spatialSampling;
+        const float invRange = 1.f / rangeSampling;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto row = data + y * stride;
+            const float fy = static_cast<float>(y) * invSpatial + static_cast<float>(bilateralGridPadding);
+            HWY_DYNAMIC_DISPATCH(BilateralGridSliceRowU8)(row, width, blurred.data(),
+                                                          gridWidth, gridHeight, gridDepth, fy,
+                                                          invSpatial, invRange, bilateralGridPadding, linearLight);
+        });
+    }
+
+    void BilateralGrid::slice(uint16_t *data, int stride) const {
+        const float invSpatial = 1.f / spatialSampling;
+        const float invRange = 1.f / rangeSampling;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto row = reinterpret_cast<uint16_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
+            const float fy = static_cast<float>(y) * invSpatial + static_cast<float>(bilateralGridPadding);
+            HWY_DYNAMIC_DISPATCH(BilateralGridSliceRowF16)(row, width, blurred.data(),
+                                                           gridWidth, gridHeight, gridDepth, fy,
+                                                           invSpatial, invRange, bilateralGridPadding, linearLight);
+        });
+    }
+
+    void bilateralGridBlurU8(uint8_t *data, int stride, int width, int height,
+                             float spatialSigma, float rangeSigma, bool linearLight) {
+        BilateralGrid grid(width, height, spatialSigma, rangeSigma, linearLight);
+        grid.splat(data, stride);
+        grid.blur(spatialSigma, rangeSigma);
+        grid.slice(data, stride);
+    }
+
+    void bilateralGridBlurF16(uint16_t *data, int stride, int width, int height,
+                              float spatialSigma, float rangeSigma, bool linearLight) {
+        BilateralGrid grid(width, height, spatialSigma, rangeSigma, linearLight);
+        grid.splat(data, stride);
+        grid.blur(spatialSigma, rangeSigma);
+        grid.slice(data, stride);
+    }
+}
+#endif
@@ -0,0 +1,94 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 18/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace aire {
+
+    // Bilateral grid: image is splatted into downsampled (x, y, luminance) grid of homogeneous RGBW cells,
+    // grid is blurred separably and sliced back with trilinear interpolation.
+    // Splatted cells are retained, so blur and slice may be repeated with other sigmas without re-splatting,
+    // as long as sigmas are not lower than the sampling grid was built with.
+    // Spatial sampling is coarsened when the grid would not fit a fixed cell budget
+    class BilateralGrid {
+    public:
+        BilateralGrid(int width, int height, float spatialSampling, float rangeSampling, bool linearLight = false);
+
+        void splat(const uint8_t *data, int stride);
+
+        void splat(const uint16_t *data, int stride);
+
+        // spatialSigma is in pixels, rangeSigma in 0...255 intensity units
+        void blur(float spatialSigma, float rangeSigma);
+
+        // Guide luminance is read from data itself, so slicing in place is supported
+        void slice(uint8_t *data, int stride) const;
+
+        void slice(uint16_t *data, int stride) const;
+
+        int getGridWidth() const {
+            return gridWidth;
+        }
+
+        int getGridHeight() const {
+            return gridHeight;
+        }
+
+        int getGridDepth() const {
+            return gridDepth;
+        }
+
+    private:
+        void clearSplat();
+
+        const int width;
+        const int height;
+        const float spatialSampling;
+        const float rangeSampling;
+        const bool linearLight;
+        int gridWidth;
+        int gridHeight;
+        int gridDepth;
+        std::vector<int> rowStart;
+        std::vector<int> rowEnd;
+        std::vector<float> splatted;
+        std::vector<float> blurred;
+        std::vector<float> transient;
+    };
+
+    void bilateralGridBlurU8(uint8_t *data, int stride, int width, int height,
+                             float spatialSigma, float rangeSigma, bool linearLight = false);
+
+    void bilateralGridBlurF16(uint16_t *data, int stride, int width, int height,
+                              float spatialSigma, float rangeSigma, bool linearLight = false);
+}
@@ -28,16 +28,132 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "color/Adjustments.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "Adjustments.h"
+#include "conversion/attenuate-inl.h"
 #include "Eigen/Eigen"
-#include "color/Gamut.h"
-#include "color/Blend.h"
-#include "color/eotf-inl.h"
 #include "concurrency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    // Runs row kernel over i16 halves of deinterleaved RGBA8888 and narrows back with saturation,
+    // premultiplied pixels are unpremultiplied before the kernel and premultiplied back after it
+    template<typename Kernel>
+    HWY_INLINE void AdjustmentsRows(uint8_t *data, const int stride, const int width, const int height,
+                                    const bool premultiplied, Kernel &&kernel) {
+        const ScalableTag<uint8_t> du8;
+        const Repartition<int16_t, decltype(du8)> di16;
+        using V8 = Vec<decltype(du8)>;
+        const int lanes = static_cast<int>(Lanes(du8));
 
-    using namespace aire::HWY_NAMESPACE;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *row = data + y * stride;
+            uint8_t tail[HWY_MAX_BYTES * 4];
+            const auto zeros = Zero(di16);
+            const auto vMax = Set(di16, 255);
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                uint8_t *px = row + x * 4;
+                if (count < lanes) {
+                    std::copy(px, px + count * 4, tail);
+                    px = tail;
+                }
+                V8 r, g, b, a;
+                LoadInterleaved4(du8, px, r, g, b, a);
+                auto rl = PromoteLowerTo(di16, r);
+                auto gl = PromoteLowerTo(di16, g);
+                auto bl = PromoteLowerTo(di16, b);
+                auto rh = PromoteUpperTo(di16, r);
+                auto gh = PromoteUpperTo(di16, g);
+                auto bh = PromoteUpperTo(di16, b);
+                const bool attenuated = premultiplied && !AllTrue(du8, Eq(a, Set(du8, 255)));
+                const auto al = PromoteLowerTo(di16, a);
+                const auto ah = PromoteUpperTo(di16, a);
+                if (attenuated) {
+                    rl = UnattenuateVec16(di16, rl, al);
+                    gl = UnattenuateVec16(di16, gl, al);
+                    bl = UnattenuateVec16(di16, bl, al);
+                    rh = UnattenuateVec16(di16, rh, ah);
+                    gh = UnattenuateVec16(di16, gh, ah);
+                    bh = UnattenuateVec16(di16, bh, ah);
+                }
+                kernel(di16, rl, gl, bl);
+                kernel(di16, rh, gh, bh);
+                if (attenuated) {
+                    rl = AttenuateVec16(di16, Clamp(rl, zeros, vMax), al);
+                    gl = AttenuateVec16(di16, Clamp(gl, zeros, vMax), al);
+                    bl = AttenuateVec16(di16, Clamp(bl, zeros, vMax), al);
+                    rh = AttenuateVec16(di16, Clamp(rh, zeros, vMax), ah);
+                    gh = AttenuateVec16(di16, Clamp(gh, zeros, vMax), ah);
+                    bh = AttenuateVec16(di16, Clamp(bh, zeros, vMax), ah);
+                }
+                r = OrderedDemote2To(du8, rl, rh);
+                g = OrderedDemote2To(du8, gl, gh);
+                b = OrderedDemote2To(du8, bl, bh);
+                StoreInterleaved4(r, g, b, a, du8, px);
+                if (count < lanes) {
+                    std::copy(tail, tail + count * 4, row + x * 4);
+                }
+            }
+        });
+    }
+
+    /**
+     * Luma is Q6 from Q15 primaries, difference to luma is Q6 and scaled by Q12 saturation into Q3,
+     * result is floored like float to u8 truncation does for positive values
+     */
+    void SaturationRGBA(uint8_t *data, const int stride, const int width, const int height, const float saturation,
+                        const bool premultiplied) {
+        const int16_t saturationQ12 = static_cast<int16_t>(std::lround(saturation * 4096.f));
+        AdjustmentsRows(data, stride, width, height, premultiplied,
+                        [saturationQ12](auto di16, auto &r, auto &g, auto &b) {
+            const auto vSaturation = Set(di16, saturationQ12);
+            const auto luma = Add(MulHigh(ShiftLeft<7>(r), Set(di16, 9798)),
+                                  Add(MulHigh(ShiftLeft<7>(g), Set(di16, 19235)),
+                                      MulHigh(ShiftLeft<7>(b), Set(di16, 3736))));
+            const auto lumaQ3 = Add(ShiftRight<3>(luma), Set(di16, 1));
+            r = ShiftRight<3>(Add(MulHigh(ShiftLeft<1>(Sub(ShiftLeft<6>(r), luma)), vSaturation), lumaQ3));
+            g = ShiftRight<3>(Add(MulHigh(ShiftLeft<1>(Sub(ShiftLeft<6>(g), luma)), vSaturation), lumaQ3));
+            b = ShiftRight<3>(Add(MulHigh(ShiftLeft<1>(Sub(ShiftLeft<6>(b), luma)), vSaturation), lumaQ3));
+        });
+    }
+
+    // c * gain + offset with Q12 gain and Q3 offset
+    void AdjustmentRGBA(uint8_t *data, const int stride, const int width, const int height,
+                        const float gain, const float offset, const bool premultiplied) {
+        const int16_t gainQ12 = static_cast<int16_t>(std::lround(gain * 4096.f));
+        const int16_t offsetQ3 = static_cast<int16_t>(std::lround(offset * 8.f) + 1);
+        AdjustmentsRows(data, stride, width, height, premultiplied,
+                        [gainQ12, offsetQ3](auto di16, auto &r, auto &g, auto &b) {
+            const auto vGain = Set(di16, gainQ12);
+            const auto vOffset = Set(di16, offsetQ3);
+            r = ShiftRight<3>(SaturatedAdd(MulHigh(ShiftLeft<7>(r), vGain), vOffset));
+            g = ShiftRight<3>(SaturatedAdd(MulHigh(ShiftLeft<7>(g), vGain), vOffset));
+            b = ShiftRight<3>(SaturatedAdd(MulHigh(ShiftLeft<7>(b), vGain), vOffset));
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(SaturationRGBA);
+    HWY_EXPORT(AdjustmentRGBA);
 
     void colorMatrix(uint8_t *data, int stride, int width, int height, const Eigen::Matrix3f matrix) {
         concurrency::parallel_for(4, height, [&](int y) {
@@ -60,7 +176,43 @@ namespace aire {
         });
     }
 
-    void adjustment(uint8_t *data, int stride, int width, int height, float gain, float bias) {
+    void saturation(uint8_t *data, int stride, int width, int height, float saturation, bool premultiplied) {
+        // Q12 multiplier has to fit into i16
+        if (std::abs(saturation) < 7.9f) {
+            HWY_DYNAMIC_DISPATCH(SaturationRGBA)(data, stride, width, height, saturation, premultiplied);
+            return;
+        }
+        const Eigen::Vector3f lumaPrimaries = {0.299f, 0.587f, 0.114f};
+        concurrency::parallel_for(4, height, [&](int y) {
+            auto pixels = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
+            int x = 0;
+
+            for (; x < width; ++x) {
+                const float alpha = premultiplied ? pixels[3] / 255.f : 1.f;
+                Eigen::Vector3f rgb;
+                rgb << pixels[0], pixels[1], pixels[2];
+                if (alpha > 0.f) {
+                    rgb = (rgb / alpha).array().min(255.f);
+
+                    const float luma = rgb.dot(lumaPrimaries);
+                    rgb = ((rgb.array() - luma) * saturation + luma).max(0.f).min(255.f) * alpha;
+                }
+
+                pixels[0] = rgb.x();
+                pixels[1] = rgb.y();
+                pixels[2] = rgb.z();
+
+                pixels += 4;
+            }
+        });
+    }
+
+    void adjustment(uint8_t *data, int stride, int width, int height, float gain, float bias, bool premultiplied) {
+        const float offset = 255.f * (0.5f - 0.5f * gain + bias);
+        if (std::abs(gain) < 7.9f && std::abs(offset) < 4000.f) {
+            HWY_DYNAMIC_DISPATCH(AdjustmentRGBA)(data, stride, width, height, gain, offset, premultiplied);
+            return;
+        }
         const Eigen::Vector3f fBias = {bias, bias, bias};
         const Eigen::Vector3f balance = {0.5f, 0.5f, 0.5f};
         concurrency::parallel_for(4, height, [&](int y) {
@@ -68,12 +220,15 @@ namespace aire {
             int x = 0;
 
             for (; x < width; ++x) {
+                const float alpha = premultiplied ? pixels[3] / 255.f : 1.f;
                 Eigen::Vector3f rgb;
                 rgb << pixels[0], pixels[1], pixels[2];
-                rgb /= 255.f;
+                if (alpha > 0.f) {
+                    rgb = (rgb / (255.f * alpha)).array().min(1.f);
 
-                rgb = gain * (rgb - balance) + balance + fBias;
-                rgb = (rgb * 255.f).array().max(0.f).min(255.f);
+                    rgb = gain * (rgb - balance) + balance + fBias;
+                    rgb = (rgb * 255.f).array().max(0.f).min(255.f) * alpha;
+                }
 
                 pixels[0] = rgb.x();
                 pixels[1] = rgb.y();
@@ -83,5 +238,5 @@ namespace aire {
             }
         });
     }
-
-}
\ No newline at end of file
+}
+#endif
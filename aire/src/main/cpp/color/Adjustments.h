@@ -35,6 +35,8 @@
 
 namespace aire {
     void colorMatrix(uint8_t *data, int stride, int width, int height, const Eigen::Matrix3f matrix);
-    void saturation(uint8_t *data, int stride, int width, int height, float saturation);
-    void adjustment(uint8_t *data, int stride, int width, int height, float gain, float bias);
+    // Premultiplied pixels are unpremultiplied before the adjustment and premultiplied back in the same pass
+    void saturation(uint8_t *data, int stride, int width, int height, float saturation, bool premultiplied = false);
+    void adjustment(uint8_t *data, int stride, int width, int height, float gain, float bias,
+                    bool premultiplied = false);
 }
\ No newline at end of file
@@ -0,0 +1,285 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 28/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "color/AutoAdjust.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "AutoAdjust.h"
+#include "base/LUT8.h"
+#include "base/Histogram.h"
+#include "color/eotf-inl.h"
+#include "algo/math-inl.h"
+#include "concurrency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    /**
+     * Samples every step-th pixel of every step-th row, each thread reduces its segment of sampled rows
+     * in vectors and merges once. Moments are linear RGB sums, RGB sums of 6th powers and sum of log luminance.
+     * Sampled pixels are packed into rows of samples with linear luminance quantized
+     * to 8 bits in place of alpha, so histograms are collected by one channelHistograms pass over them
+     */
+    void AutoAdjustStatisticsRGBA(const uint8_t *data, const int stride, const int width, const int height, const int step,
+                                  double moments[7], uint8_t *samples, const int sampleStride) {
+        const ScalableTag<float> df;
+        const RebindToSigned<decltype(df)> di32;
+        using VF = Vec<decltype(df)>;
+        const int lanes = static_cast<int>(Lanes(df));
+
+        HWY_ALIGN float linear[256];
+        for (int i = 0; i < 256; i += lanes) {
+            const auto value = Mul(ConvertTo(df, Iota(di32, i)), Set(df, 1.f / 255.f));
+            StoreU(SRGBToLinear(df, value), df, linear + i);
+        }
+
+        const int columns = (width + step - 1) / step;
+        const int rows = (height + step - 1) / step;
+
+        std::fill(moments, moments + 7, 0.);
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    rows * columns / (256 * 256)), 1, 12);
+        std::mutex mergeMutex;
+
+        concurrency::parallel_for_segment(threadCount, rows, [&](int start, int end) {
+            double sum[7] = {};
+            HWY_ALIGN int32_t tail[HWY_MAX_LANES_D(decltype(di32))];
+
+            const auto vLastColumn = Set(di32, (columns - 1) * step);
+            const auto vColumnStep = Set(di32, lanes * step);
+            const auto vMask = Set(di32, 0xFF);
+            const auto vColorMask = Set(di32, 0xFFFFFF);
+            const auto vRedWeight = Set(df, 0.2126f);
+            const auto vGreenWeight = Set(df, 0.7152f);
+            const auto vBlueWeight = Set(df, 0.0722f);
+            const auto vLogOffset = Set(df, 1e-4f);
+            const auto vBinScale = Set(df, 255.f);
+
+            for (int j = start; j < end; ++j) {
+                const auto row = reinterpret_cast<const int32_t *>(data + static_cast<size_t>(j) * step * stride);
+                auto sampleRow = reinterpret_cast<int32_t *>(samples + static_cast<size_t>(j) * sampleStride);
+                VF sumR = Zero(df), sumG = Zero(df), sumB = Zero(df);
+                VF powerR = Zero(df), powerG = Zero(df), powerB = Zero(df);
+                VF logSum = Zero(df);
+                auto index = Mul(Iota(di32, 0), Set(di32, step));
+                for (int i = 0; i < columns; i += lanes) {
+                    const int count = std::min(lanes, columns - i);
+                    const auto valid = RebindMask(df, FirstN(di32, count));
+                    const auto pixel = GatherIndex(di32, row, Min(index, vLastColumn));
+                    index = Add(index, vColumnStep);
+
+                    const auto r = And(pixel, vMask);
+                    const auto g = And(ShiftRight<8>(pixel), vMask);
+                    const auto b = And(ShiftRight<16>(pixel), vMask);
+                    const auto lr = IfThenElseZero(valid, GatherIndex(df, linear, r));
+                    const auto lg = IfThenElseZero(valid, GatherIndex(df, linear, g));
+                    const auto lb = IfThenElseZero(valid, GatherIndex(df, linear, b));
+
+                    sumR = Add(sumR, lr);
+                    sumG = Add(sumG, lg);
+                    sumB = Add(sumB, lb);
+                    const auto r2 = Mul(lr, lr);
+                    const auto g2 = Mul(lg, lg);
+                    const auto b2 = Mul(lb, lb);
+                    powerR = MulAdd(Mul(r2, r2), r2, powerR);
+                    powerG = MulAdd(Mul(g2, g2), g2, powerG);
+                    powerB = MulAdd(Mul(b2, b2), b2, powerB);
+
+                    const auto luminance = MulAdd(lr, vRedWeight, MulAdd(lg, vGreenWeight, Mul(lb, vBlueWeight)));
+                    logSum = Add(logSum, IfThenElseZero(valid, Log(df, Add(luminance, vLogOffset))));
+
+                    const auto bin = Min(NearestInt(Mul(luminance, vBinScale)), vMask);
+                    const auto packed = Or(And(pixel, vColorMask), ShiftLeft<24>(bin));
+                    if (count < lanes) {
+                        Store(packed, di32, tail);
+                        std::copy(tail, tail + count, sampleRow + i);
+                    } else {
+                        StoreU(packed, di32, sampleRow + i);
+                    }
+                }
+                sum[0] += ReduceSum(df, sumR);
+                sum[1] += ReduceSum(df, sumG);
+                sum[2] += ReduceSum(df, sumB);
+                sum[3] += ReduceSum(df, powerR);
+                sum[4] += ReduceSum(df, powerG);
+                sum[5] += ReduceSum(df, powerB);
+                sum[6] += ReduceSum(df, logSum);
+            }
+
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            for (int i = 0; i < 7; ++i) {
+                moments[i] += sum[i];
+            }
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(AutoAdjustStatisticsRGBA);
+
+    struct AutoAdjustStatistics {
+        double sum[3];
+        double power[3];
+        double logLuminance;
+        uint64_t count;
+        uint32_t histograms[4][256];
+    };
+
+    // About 512 * 512 samples are enough for global estimates at any resolution
+    static void collectStatistics(const uint8_t *data, int stride, int width, int height, AutoAdjustStatistics &statistics) {
+        const int step = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(width) * height / (512. * 512.))));
+        const int columns = (width + step - 1) / step;
+        const int rows = (height + step - 1) / step;
+        const int sampleStride = columns * 4;
+        std::vector<uint8_t> samples(static_cast<size_t>(sampleStride) * rows);
+        double moments[7];
+        HWY_DYNAMIC_DISPATCH(AutoAdjustStatisticsRGBA)(data, stride, width, height, step, moments,
+                                                       samples.data(), sampleStride);
+        std::copy(moments, moments + 3, statistics.sum);
+        std::copy(moments + 3, moments + 6, statistics.power);
+        statistics.logLuminance = moments[6];
+        statistics.count = static_cast<uint64_t>(columns) * static_cast<uint64_t>(rows);
+
+        ChannelHistograms histograms;
+        channelHistograms(samples.data(), sampleStride, columns, rows, histograms);
+        std::copy(histograms.red, histograms.red + 256, statistics.histograms[0]);
+        std::copy(histograms.green, histograms.green + 256, statistics.histograms[1]);
+        std::copy(histograms.blue, histograms.blue + 256, statistics.histograms[2]);
+        // Alpha of samples carries quantized linear luminance
+        std::copy(histograms.alpha, histograms.alpha + 256, statistics.histograms[3]);
+    }
+
+    static int histogramPercentile(const uint32_t histogram[256], const uint64_t count, const float percentile) {
+        const auto target = static_cast<uint64_t>(std::ceil(static_cast<double>(count) * percentile));
+        uint64_t accumulated = 0;
+        for (int i = 0; i < 256; ++i) {
+            accumulated += histogram[i];
+            if (accumulated >= target) {
+                return i;
+            }
+        }
+        return 255;
+    }
+
+    static float autoAdjustLinear(const float v) {
+        return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float autoAdjustGamma(const float v) {
+        return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+    }
+
+    static WhiteBalanceGains whiteBalanceGains(const AutoAdjustStatistics &statistics, const WhiteBalanceEstimator estimator) {
+        double illuminant[3];
+        for (int c = 0; c < 3; ++c) {
+            switch (estimator) {
+                case WB_WHITE_PATCH:
+                    illuminant[c] = autoAdjustLinear(
+                            static_cast<float>(histogramPercentile(statistics.histograms[c], statistics.count, 0.99f)) / 255.f);
+                    break;
+                case WB_SHADES_OF_GRAY:
+                    illuminant[c] = std::pow(statistics.power[c] / static_cast<double>(statistics.count), 1. / 6.);
+                    break;
+                default:
+                    illuminant[c] = statistics.sum[c] / static_cast<double>(statistics.count);
+                    break;
+            }
+        }
+        auto gain = [&](const int c) -> float {
+            if (illuminant[c] < 1e-6 || illuminant[1] < 1e-6) {
+                return 1.f;
+            }
+            return std::clamp(static_cast<float>(illuminant[1] / illuminant[c]), 0.25f, 4.f);
+        };
+        return {gain(0), 1.f, gain(2)};
+    }
+
+    static float exposureMultiplier(const AutoAdjustStatistics &statistics, const float key) {
+        const double logAverage = std::exp(statistics.logLuminance / static_cast<double>(statistics.count));
+        float exposure = static_cast<float>(key / std::max(logAverage, 1e-4));
+        const int highlights = histogramPercentile(statistics.histograms[3], statistics.count, 0.99f);
+        if (highlights > 0) {
+            exposure = std::min(exposure, std::max(1.f, 255.f / static_cast<float>(highlights)));
+        }
+        return std::clamp(exposure, 1.f / 16.f, 16.f);
+    }
+
+    WhiteBalanceGains estimateWhiteBalance(const uint8_t *data, int stride, int width, int height,
+                                           WhiteBalanceEstimator estimator) {
+        AutoAdjustStatistics statistics;
+        collectStatistics(data, stride, width, height, statistics);
+        return whiteBalanceGains(statistics, estimator);
+    }
+
+    float estimateExposure(const uint8_t *data, int stride, int width, int height, float key) {
+        AutoAdjustStatistics statistics;
+        collectStatistics(data, stride, width, height, statistics);
+        return exposureMultiplier(statistics, key);
+    }
+
+    void autoAdjust(uint8_t *data, int stride, int width, int height, bool balance, WhiteBalanceEstimator estimator,
+                    bool exposure, float key) {
+        if (!balance && !exposure) {
+            return;
+        }
+        AutoAdjustStatistics statistics;
+        collectStatistics(data, stride, width, height, statistics);
+        WhiteBalanceGains gains = {1.f, 1.f, 1.f};
+        if (balance) {
+            gains = whiteBalanceGains(statistics, estimator);
+        }
+        const float multiplier = exposure ? exposureMultiplier(statistics, key) : 1.f;
+        // Diagonal gains in linear RGB keep channels independent, so whole transform is a table per channel
+        const float channelGains[3] = {gains.red * multiplier, gains.green * multiplier, gains.blue * multiplier};
+        uint8_t tables[3][256];
+        for (int c = 0; c < 3; ++c) {
+            for (int i = 0; i < 256; ++i) {
+                const float value = std::min(autoAdjustLinear(static_cast<float>(i) / 255.f) * channelGains[c], 1.f);
+                tables[c][i] = static_cast<uint8_t>(std::lround(autoAdjustGamma(value) * 255.f));
+            }
+        }
+        LUT8(tables[0], tables[1], tables[2]).apply(data, stride, width, height);
+    }
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 28/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace aire {
+
+    enum WhiteBalanceEstimator {
+        WB_GRAY_WORLD = 0,
+        WB_WHITE_PATCH = 1,
+        WB_SHADES_OF_GRAY = 2,
+    };
+
+    // Per channel gains in linear RGB, green is kept at 1
+    struct WhiteBalanceGains {
+        float red;
+        float green;
+        float blue;
+    };
+
+    /**
+     * Estimates illuminant of RGBA8888 on a decimated sample grid. White patch takes
+     * 99th percentile of each channel, shades of gray is Minkowski norm with p = 6
+     */
+    WhiteBalanceGains estimateWhiteBalance(const uint8_t *data, int stride, int width, int height,
+                                           WhiteBalanceEstimator estimator);
+
+    /**
+     * Linear exposure multiplier mapping log average luminance to key value,
+     * limited so that 99th percentile of luminance is not pushed to clipping
+     */
+    float estimateExposure(const uint8_t *data, int stride, int width, int height, float key = 0.18f);
+
+    // Applies estimated white balance and exposure in place, both fold into one table per channel
+    void autoAdjust(uint8_t *data, int stride, int width, int height, bool balance, WhiteBalanceEstimator estimator,
+                    bool exposure, float key = 0.18f);
+}
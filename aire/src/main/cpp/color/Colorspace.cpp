@@ -0,0 +1,322 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 25/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "color/Colorspace.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "Colorspace.h"
+#include "colorspace-inl.h"
+#include "concurrency.hpp"
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    template<ColorSpace space, class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void ColorspaceForward(const D df, V &r, V &g, V &b) {
+        if constexpr (space == COLORSPACE_OKLAB) {
+            SRGBToOklab(df, r, g, b);
+        } else if constexpr (space == COLORSPACE_OKLCH) {
+            SRGBToOklch(df, r, g, b);
+        } else if constexpr (space == COLORSPACE_LAB) {
+            SRGBToLab(df, r, g, b);
+        } else if constexpr (space == COLORSPACE_LUV) {
+            SRGBToLuv(df, r, g, b);
+        } else if constexpr (space == COLORSPACE_HSV) {
+            SRGBToHSV(df, r, g, b);
+        } else if constexpr (space == COLORSPACE_HSL) {
+            SRGBToHSL(df, r, g, b);
+        } else {
+            SRGBToJzazbz(df, r, g, b);
+        }
+    }
+
+    template<ColorSpace space, class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void ColorspaceInverse(const D df, V &c0, V &c1, V &c2) {
+        if constexpr (space == COLORSPACE_OKLAB) {
+            OklabToSRGB(df, c0, c1, c2);
+        } else if constexpr (space == COLORSPACE_OKLCH) {
+            OklchToSRGB(df, c0, c1, c2);
+        } else if constexpr (space == COLORSPACE_LAB) {
+            LabToSRGB(df, c0, c1, c2);
+        } else if constexpr (space == COLORSPACE_LUV) {
+            LuvToSRGB(df, c0, c1, c2);
+        } else if constexpr (space == COLORSPACE_HSV) {
+            HSVToSRGB(df, c0, c1, c2);
+        } else if constexpr (space == COLORSPACE_HSL) {
+            HSLToSRGB(df, c0, c1, c2);
+        } else {
+            JzazbzToSRGB(df, c0, c1, c2);
+        }
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void ColorspaceStorePlane(const D df, V v, float *dst) {
+        StoreU(v, df, dst);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void ColorspaceStorePlane(const D, V v, uint16_t *dst) {
+        const Rebind<hwy::float16_t, D> dh;
+        const Rebind<uint16_t, D> du16;
+        StoreU(BitCast(du16, DemoteTo(dh, v)), du16, dst);
+    }
+
+    template<class D>
+    HWY_INLINE Vec<D> ColorspaceLoadPlane(const D df, const float *src) {
+        return LoadU(df, src);
+    }
+
+    template<class D>
+    HWY_INLINE Vec<D> ColorspaceLoadPlane(const D df, const uint16_t *src) {
+        const Rebind<hwy::float16_t, D> dh;
+        const Rebind<uint16_t, D> du16;
+        return PromoteTo(df, BitCast(dh, LoadU(du16, src)));
+    }
+
+    template<ColorSpace space, typename T>
+    void RgbaToPlanarRow(const uint8_t *src, T *c0, T *c1, T *c2, const int width) {
+        const ScalableTag<float> df;
+        const Rebind<uint8_t, decltype(df)> du8;
+        const Rebind<int32_t, decltype(df)> di32;
+        const int lanes = static_cast<int>(Lanes(df));
+        const auto vRevertScale = Set(df, 1.f / 255.f);
+        uint8_t srcTail[HWY_MAX_BYTES * 4 / sizeof(float)];
+        T dstTail[3][HWY_MAX_BYTES / sizeof(float)];
+
+        for (int x = 0; x < width; x += lanes) {
+            const int count = std::min(lanes, width - x);
+            const uint8_t *s = src + x * 4;
+            T *d[3] = {c0 + x, c1 + x, c2 + x};
+            if (count < lanes) {
+                std::fill(srcTail, srcTail + lanes * 4, 0);
+                std::copy(s, s + count * 4, srcTail);
+                s = srcTail;
+                d[0] = dstTail[0];
+                d[1] = dstTail[1];
+                d[2] = dstTail[2];
+            }
+            Vec<decltype(du8)> ru, gu, bu, au;
+            LoadInterleaved4(du8, s, ru, gu, bu, au);
+            auto r = Mul(ConvertTo(df, PromoteTo(di32, ru)), vRevertScale);
+            auto g = Mul(ConvertTo(df, PromoteTo(di32, gu)), vRevertScale);
+            auto b = Mul(ConvertTo(df, PromoteTo(di32, bu)), vRevertScale);
+            ColorspaceForward<space>(df, r, g, b);
+            ColorspaceStorePlane(df, r, d[0]);
+            ColorspaceStorePlane(df, g, d[1]);
+            ColorspaceStorePlane(df, b, d[2]);
+            if (count < lanes) {
+                std::copy(dstTail[0], dstTail[0] + count, c0 + x);
+                std::copy(dstTail[1], dstTail[1] + count, c1 + x);
+                std::copy(dstTail[2], dstTail[2] + count, c2 + x);
+            }
+        }
+    }
+
+    template<ColorSpace space, typename T>
+    void PlanarToRgbaRow(const T *c0, const T *c1, const T *c2, uint8_t *dst, const int width) {
+        const ScalableTag<float> df;
+        const Rebind<uint8_t, decltype(df)> du8;
+        const int lanes = static_cast<int>(Lanes(df));
+        const auto zeros = Zero(df);
+        const auto vScale = Set(df, 255.f);
+        T srcTail[3][HWY_MAX_BYTES / sizeof(float)];
+        uint8_t dstTail[HWY_MAX_BYTES * 4 / sizeof(float)];
+
+        for (int x = 0; x < width; x += lanes) {
+            const int count = std::min(lanes, width - x);
+            const T *s[3] = {c0 + x, c1 + x, c2 + x};
+            uint8_t *d = dst + x * 4;
+            if (count < lanes) {
+                for (int c = 0; c < 3; ++c) {
+                    std::fill(srcTail[c], srcTail[c] + lanes, T(0));
+                    std::copy(s[c], s[c] + count, srcTail[c]);
+                    s[c] = srcTail[c];
+                }
+                std::copy(d, d + count * 4, dstTail);
+                d = dstTail;
+            }
+            auto r = ColorspaceLoadPlane(df, s[0]);
+            auto g = ColorspaceLoadPlane(df, s[1]);
+            auto b = ColorspaceLoadPlane(df, s[2]);
+            ColorspaceInverse<space>(df, r, g, b);
+            Vec<decltype(du8)> ru, gu, bu, au;
+            LoadInterleaved4(du8, d, ru, gu, bu, au);
+            ru = DemoteTo(du8, NearestInt(Clamp(Mul(r, vScale), zeros, vScale)));
+            gu = DemoteTo(du8, NearestInt(Clamp(Mul(g, vScale), zeros, vScale)));
+            bu = DemoteTo(du8, NearestInt(Clamp(Mul(b, vScale), zeros, vScale)));
+            StoreInterleaved4(ru, gu, bu, au, du8, d);
+            if (count < lanes) {
+                std::copy(dstTail, dstTail + count * 4, dst + x * 4);
+            }
+        }
+    }
+
+    template<typename F>
+    HWY_INLINE void ColorspaceSelect(const ColorSpace colorSpace, F &&f) {
+        switch (colorSpace) {
+            case COLORSPACE_OKLAB:
+                f(std::integral_constant<ColorSpace, COLORSPACE_OKLAB>());
+                break;
+            case COLORSPACE_OKLCH:
+                f(std::integral_constant<ColorSpace, COLORSPACE_OKLCH>());
+                break;
+            case COLORSPACE_LAB:
+                f(std::integral_constant<ColorSpace, COLORSPACE_LAB>());
+                break;
+            case COLORSPACE_LUV:
+                f(std::integral_constant<ColorSpace, COLORSPACE_LUV>());
+                break;
+            case COLORSPACE_HSV:
+                f(std::integral_constant<ColorSpace, COLORSPACE_HSV>());
+                break;
+            case COLORSPACE_HSL:
+                f(std::integral_constant<ColorSpace, COLORSPACE_HSL>());
+                break;
+            case COLORSPACE_JZAZBZ:
+                f(std::integral_constant<ColorSpace, COLORSPACE_JZAZBZ>());
+                break;
+        }
+    }
+
+    static int ColorspaceThreadCount(const int width, const int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   height * width / (256 * 256)), 1, 12);
+    }
+
+    template<typename T>
+    void RgbaToPlanarImpl(const uint8_t *data, const int stride, T *planes, const int planeStride,
+                          const int width, const int height, const ColorSpace colorSpace) {
+        const size_t planeSize = static_cast<size_t>(planeStride) * height;
+        ColorspaceSelect(colorSpace, [&](auto space) {
+            concurrency::parallel_for(ColorspaceThreadCount(width, height), height, [&](int y) {
+                T *row = planes + static_cast<size_t>(y) * planeStride;
+                RgbaToPlanarRow<decltype(space)::value>(data + y * stride, row, row + planeSize,
+                                                        row + planeSize * 2, width);
+            });
+        });
+    }
+
+    template<typename T>
+    void PlanarToRgbaImpl(uint8_t *data, const int stride, const T *planes, const int planeStride,
+                          const int width, const int height, const ColorSpace colorSpace) {
+        const size_t planeSize = static_cast<size_t>(planeStride) * height;
+        ColorspaceSelect(colorSpace, [&](auto space) {
+            concurrency::parallel_for(ColorspaceThreadCount(width, height), height, [&](int y) {
+                const T *row = planes + static_cast<size_t>(y) * planeStride;
+                PlanarToRgbaRow<decltype(space)::value>(row, row + planeSize, row + planeSize * 2,
+                                                        data + y * stride, width);
+            });
+        });
+    }
+
+    void RgbaToPlanarF32(const uint8_t *data, const int stride, float *planes, const int planeStride,
+                         const int width, const int height, const ColorSpace colorSpace) {
+        RgbaToPlanarImpl(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void RgbaToPlanarF16(const uint8_t *data, const int stride, uint16_t *planes, const int planeStride,
+                         const int width, const int height, const ColorSpace colorSpace) {
+        RgbaToPlanarImpl(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void PlanarF32ToRgba(uint8_t *data, const int stride, const float *planes, const int planeStride,
+                         const int width, const int height, const ColorSpace colorSpace) {
+        PlanarToRgbaImpl(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void PlanarF16ToRgba(uint8_t *data, const int stride, const uint16_t *planes, const int planeStride,
+                         const int width, const int height, const ColorSpace colorSpace) {
+        PlanarToRgbaImpl(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void ColorspaceRoundTripRGBA(uint8_t *data, const int stride, const int width, const int height,
+                                 const ColorSpace colorSpace, const ColorspaceRowFunction &rowOp) {
+        ColorspaceSelect(colorSpace, [&](auto space) {
+            concurrency::parallel_for_segment(ColorspaceThreadCount(width, height), height, [&](int start, int end) {
+                std::vector<float> row(width * 3);
+                float *c0 = row.data();
+                float *c1 = c0 + width;
+                float *c2 = c1 + width;
+                for (int y = start; y < end; ++y) {
+                    uint8_t *rgba = data + y * stride;
+                    RgbaToPlanarRow<decltype(space)::value>(rgba, c0, c1, c2, width);
+                    rowOp(y, c0, c1, c2, width);
+                    PlanarToRgbaRow<decltype(space)::value>(c0, c1, c2, rgba, width);
+                }
+            });
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(RgbaToPlanarF32);
+    HWY_EXPORT(RgbaToPlanarF16);
+    HWY_EXPORT(PlanarF32ToRgba);
+    HWY_EXPORT(PlanarF16ToRgba);
+    HWY_EXPORT(ColorspaceRoundTripRGBA);
+
+    void rgbaToPlanar(const uint8_t *data, int stride, float *planes, int planeStride, int width, int height,
+                      ColorSpace colorSpace) {
+        HWY_DYNAMIC_DISPATCH(RgbaToPlanarF32)(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void planarToRgba(uint8_t *data, int stride, const float *planes, int planeStride, int width, int height,
+                      ColorSpace colorSpace) {
+        HWY_DYNAMIC_DISPATCH(PlanarF32ToRgba)(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void rgbaToPlanarF16(const uint8_t *data, int stride, uint16_t *planes, int planeStride, int width, int height,
+                         ColorSpace colorSpace) {
+        HWY_DYNAMIC_DISPATCH(RgbaToPlanarF16)(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void planarF16ToRgba(uint8_t *data, int stride, const uint16_t *planes, int planeStride, int width, int height,
+                         ColorSpace colorSpace) {
+        HWY_DYNAMIC_DISPATCH(PlanarF16ToRgba)(data, stride, planes, planeStride, width, height, colorSpace);
+    }
+
+    void colorspaceRoundTrip(uint8_t *data, int stride, int width, int height, ColorSpace colorSpace,
+                             const ColorspaceRowFunction &rowOp) {
+        HWY_DYNAMIC_DISPATCH(ColorspaceRoundTripRGBA)(data, stride, width, height, colorSpace, rowOp);
+    }
+}
+#endif
@@ -0,0 +1,68 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 25/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace aire {
+
+    enum ColorSpace {
+        COLORSPACE_OKLAB = 0,
+        COLORSPACE_OKLCH = 1,
+        COLORSPACE_LAB = 2,
+        COLORSPACE_LUV = 3,
+        COLORSPACE_HSV = 4,
+        COLORSPACE_HSL = 5,
+        COLORSPACE_JZAZBZ = 6
+    };
+
+    // Row callback of fused round trip, receives three planar channels of one row
+    typedef std::function<void(int y, float *c0, float *c1, float *c2, int width)> ColorspaceRowFunction;
+
+    // Planes of planeStride * height elements follow each other, alpha is not stored
+    void rgbaToPlanar(const uint8_t *data, int stride, float *planes, int planeStride, int width, int height,
+                      ColorSpace colorSpace);
+
+    // Alpha is kept from destination
+    void planarToRgba(uint8_t *data, int stride, const float *planes, int planeStride, int width, int height,
+                      ColorSpace colorSpace);
+
+    void rgbaToPlanarF16(const uint8_t *data, int stride, uint16_t *planes, int planeStride, int width, int height,
+                         ColorSpace colorSpace);
+
+    void planarF16ToRgba(uint8_t *data, int stride, const uint16_t *planes, int planeStride, int width, int height,
+                         ColorSpace colorSpace);
+
+    // Converts each row into color space, calls rowOp and converts it back in place without full size planes
+    void colorspaceRoundTrip(uint8_t *data, int stride, int width, int height, ColorSpace colorSpace,
+                             const ColorspaceRowFunction &rowOp);
+}
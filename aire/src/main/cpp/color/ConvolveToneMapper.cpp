@@ -44,8 +44,11 @@
 #include "tone/DragoToneMapper.hpp"
 #include "concurrency.hpp"
 #include "algo/support-inl.h"
-#include "Eigen/Eigen"
-#include "color/Blend.h"
+#include "conversion/pixel-storage-inl.h"
+#include "jni/JNIUtils.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace aire {
 
@@ -53,174 +56,258 @@ namespace aire {
     using namespace hwy::HWY_NAMESPACE;
     using namespace aire::HWY_NAMESPACE;
 
-    void convolveToneMapper(uint8_t *data, int stride, int width, int height, ToneMapper<FixedTag<float32_t, 4>> *toneMapper) {
-        const FixedTag<uint8_t, 4> du;
-        const FixedTag<uint32_t, 4> du32x4;
-        const FixedTag<float32_t, 4> dfx4;
-        const FixedTag<uint8_t, 4> du16;
-        using VF = Vec<decltype(dfx4)>;
-        using VU = Vec<decltype(du)>;
-        using VU4 = Vec<decltype(du16)>;
+    /**
+     * Decodes transfer to linear light where 1.0 is SDR diffuse white,
+     * PQ and HLG are BT.2020 so they are converted to BT.709 primaries
+     */
+    template<ToneTransfer Transfer, class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void ToneLinearize(const D df, V &r, V &g, V &b) {
+        if constexpr (Transfer == TONE_TRANSFER_SRGB) {
+            r = aire::HWY_NAMESPACE::SRGBToLinear(df, r);
+            g = aire::HWY_NAMESPACE::SRGBToLinear(df, g);
+            b = aire::HWY_NAMESPACE::SRGBToLinear(df, b);
+            return;
+        } else if constexpr (Transfer == TONE_TRANSFER_LINEAR) {
+            return;
+        } else {
+            if constexpr (Transfer == TONE_TRANSFER_PQ) {
+                r = aire::HWY_NAMESPACE::ToLinearPQ(df, r, 203.f);
+                g = aire::HWY_NAMESPACE::ToLinearPQ(df, g, 203.f);
+                b = aire::HWY_NAMESPACE::ToLinearPQ(df, b, 203.f);
+            } else {
+                // BT.2100 OOTF for 1000 nits display: gamma is applied to scene luminance only,
+                // so hue and saturation are kept, signal 0.75 lands at 203 nits
+                r = aire::HWY_NAMESPACE::HLGEotf(df, r);
+                g = aire::HWY_NAMESPACE::HLGEotf(df, g);
+                b = aire::HWY_NAMESPACE::HLGEotf(df, b);
+                const auto luma = MulAdd(Set(df, 0.2627f), r, MulAdd(Set(df, 0.6780f), g, Mul(Set(df, 0.0593f), b)));
+                const auto systemGamma = Set(df, 1.2f - 1.f);
+                const auto gain = Mul(aire::HWY_NAMESPACE::Pow(df, Max(luma, Set(df, 1e-6f)), systemGamma),
+                                      Set(df, 1000.f / 203.f));
+                r = Mul(r, gain);
+                g = Mul(g, gain);
+                b = Mul(b, gain);
+            }
 
-        const auto vScale = Set(dfx4, 255.f);
-        const auto vRevertScale = ApproximateReciprocal(vScale);
+            const auto zeros = Zero(df);
+            const auto r709 = MulAdd(Set(df, 1.6605f), r, MulAdd(Set(df, -0.5876f), g, Mul(Set(df, -0.0728f), b)));
+            const auto g709 = MulAdd(Set(df, -0.1246f), r, MulAdd(Set(df, 1.1329f), g, Mul(Set(df, -0.0083f), b)));
+            const auto b709 = MulAdd(Set(df, -0.0182f), r, MulAdd(Set(df, -0.1006f), g, Mul(Set(df, 1.1187f), b)));
+            r = Max(r709, zeros);
+            g = Max(g709, zeros);
+            b = Max(b709, zeros);
+        }
+    }
 
-        const auto zeros = Zero(dfx4);
+    /**
+     * Tone mapper type, transfer and both storages are known at compile time, so Execute, loads and stores
+     * are inlined into the loop and their constants are hoisted out of it
+     */
+    template<PixelStorage Source, PixelStorage Destination, ToneTransfer Transfer, class ToneMapperType>
+    void convolveToneMapper(const ToneSurface &surface, ToneMapperType &toneMapper) {
+        const ScalableTag<float32_t> df;
+        const int width = surface.width;
+        const int height = surface.height;
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        const bool premultiplied = surface.premultiplied;
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto src = surface.source + y * surface.sourceStride;
+            auto dst = surface.destination + y * surface.destinationStride;
+            TransformPixelRow<Source, Destination>(df, src, dst, width, [&](Vec<decltype(df)> &r, Vec<decltype(df)> &g,
+                                                                           Vec<decltype(df)> &b, Vec<decltype(df)> &a) {
+                if (premultiplied) {
+                    UnpremultiplyPixels(df, r, g, b, a);
+                }
+                if constexpr (Source == PIXEL_RGBA_F16) {
+                    // Extended range half floats may hold negative values
+                    const auto zeros = Zero(df);
+                    r = Max(r, zeros);
+                    g = Max(g, zeros);
+                    b = Max(b, zeros);
+                }
+
+                ToneLinearize<Transfer>(df, r, g, b);
+
+                toneMapper.Execute(r, g, b);
+
+                r = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, r);
+                g = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, g);
+                b = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, b);
+                if (premultiplied) {
+                    PremultiplyPixels<Destination>(df, r, g, b, a);
+                }
+            });
+        });
+    }
 
-        concurrency::parallel_for(4, height, [&](int y) {
-            auto pixels = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-            int x = 0;
+    template<PixelStorage Source, PixelStorage Destination, class ToneMapperType>
+    void convolveToneMapper(const ToneSurface &surface, ToneMapperType &toneMapper) {
+        switch (surface.transfer) {
+            case TONE_TRANSFER_LINEAR:
+                convolveToneMapper<Source, Destination, TONE_TRANSFER_LINEAR>(surface, toneMapper);
+                break;
+            case TONE_TRANSFER_PQ:
+                convolveToneMapper<Source, Destination, TONE_TRANSFER_PQ>(surface, toneMapper);
+                break;
+            case TONE_TRANSFER_HLG:
+                convolveToneMapper<Source, Destination, TONE_TRANSFER_HLG>(surface, toneMapper);
+                break;
+            default:
+                convolveToneMapper<Source, Destination, TONE_TRANSFER_SRGB>(surface, toneMapper);
+                break;
+        }
+    }
 
-            for (; x + 4 < width; x += 4) {
-                VU4 ru4, gu4, bu4, au4;
-                LoadInterleaved4(du16, &pixels[0], ru4, gu4, bu4, au4);
-                VF rf4 = Mul(PromoteTo(dfx4, ru4), vRevertScale);
-                VF gf4 = Mul(PromoteTo(dfx4, gu4), vRevertScale);
-                VF bf4 = Mul(PromoteTo(dfx4, bu4), vRevertScale);
+    // Destination is either in the source storage or RGBA8888
+    template<class ToneMapperType>
+    void convolveToneMapper(const ToneSurface &surface, ToneMapperType &toneMapper) {
+        const auto destination = static_cast<PixelStorage>(surface.destinationFormat);
+        DispatchPixelStorage(static_cast<PixelStorage>(surface.sourceFormat), [&](auto source) {
+            constexpr PixelStorage Source = decltype(source)::value;
+            if (destination == Source) {
+                convolveToneMapper<Source, Source>(surface, toneMapper);
+            } else if (destination == PIXEL_RGBA8888) {
+                convolveToneMapper<Source, PIXEL_RGBA8888>(surface, toneMapper);
+            } else {
+                std::string msg = "Tone mapping can write only in source pixel format or RGBA8888";
+                throw AireError(msg);
+            }
+        });
+    }
 
-                rf4 = aire::HWY_NAMESPACE::SRGBToLinear(dfx4, rf4);
-                gf4 = aire::HWY_NAMESPACE::SRGBToLinear(dfx4, gf4);
-                bf4 = aire::HWY_NAMESPACE::SRGBToLinear(dfx4, bf4);
+    static ToneSurface rgba8888Surface(uint8_t *data, int stride, int width, int height, bool premultiplied) {
+        return {
+                .source = data,
+                .sourceStride = stride,
+                .sourceFormat = TONE_RGBA8888,
+                .transfer = TONE_TRANSFER_SRGB,
+                .destination = data,
+                .destinationStride = stride,
+                .destinationFormat = TONE_RGBA8888,
+                .width = width,
+                .height = height,
+                .premultiplied = premultiplied
+        };
+    }
 
-                toneMapper->Execute(rf4, gf4, bf4);
+    void logarithmic(const ToneSurface &surface, float exposure) {
+        const float rPrimary = 0.299f;
+        const float gPrimary = 0.587f;
+        const float bPrimary = 0.114f;
 
-                rf4 = aire::HWY_NAMESPACE::LinearSRGBTosRGB(dfx4, rf4);
-                gf4 = aire::HWY_NAMESPACE::LinearSRGBTosRGB(dfx4, gf4);
-                bf4 = aire::HWY_NAMESPACE::LinearSRGBTosRGB(dfx4, bf4);
+        const float coeffs[3] = {rPrimary, gPrimary, bPrimary};
+        LogarithmicToneMapper<ScalableTag<float32_t>> toneMapper(coeffs, exposure);
+        convolveToneMapper(surface, toneMapper);
+    }
 
-                rf4 = Clamp(Mul(rf4, vScale), zeros, vScale);
-                gf4 = Clamp(Mul(gf4, vScale), zeros, vScale);
-                bf4 = Clamp(Mul(bf4, vScale), zeros, vScale);
+    void logarithmic(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        logarithmic(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
+    }
 
-                ru4 = DemoteTo(du, rf4);
-                gu4 = DemoteTo(du, gf4);
-                bu4 = DemoteTo(du, bf4);
+    void acesFilm(const ToneSurface &surface, float exposure) {
+        AcesFilmicToneMapper<ScalableTag<float32_t>> toneMapper(exposure);
+        convolveToneMapper(surface, toneMapper);
+    }
 
-                StoreInterleaved4(ru4, gu4, bu4, au4, du16, &pixels[0]);
+    void acesFilm(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        acesFilm(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
+    }
 
-                pixels += 16;
-            }
+    void mobius(const ToneSurface &surface, float exposure, float transition, float peak) {
+        MobiusToneMapper<ScalableTag<float32_t>> toneMapper(exposure, transition, peak);
+        convolveToneMapper(surface, toneMapper);
+    }
 
-            for (; x < width; ++x) {
-                VF local = Mul(ConvertTo(dfx4, PromoteTo(du32x4, LoadU(du, &pixels[0]))), vRevertScale);
-                VF color = aire::HWY_NAMESPACE::SRGBToLinear(dfx4, local);
-                float r = ExtractLane(color, 0);
-                float g = ExtractLane(color, 1);
-                float b = ExtractLane(color, 2);
-                toneMapper->Execute(r, g, b);
-                pixels[0] = std::clamp(LinearSRGBTosRGB(r) * 255.f, 0.f, 255.f);
-                pixels[1] = std::clamp(LinearSRGBTosRGB(g) * 255.f, 0.f, 255.f);
-                pixels[2] = std::clamp(LinearSRGBTosRGB(b) * 255.f, 0.f, 255.f);
-                pixels += 4;
-            }
-        });
+    void mobius(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak,
+                bool premultiplied) {
+        mobius(rgba8888Surface(data, stride, width, height, premultiplied), exposure, transition, peak);
+    }
+
+    void aldridge(const ToneSurface &surface, float exposure, float cutoff) {
+        AldridgeToneMapper<ScalableTag<float32_t>> toneMapper(exposure, cutoff);
+        convolveToneMapper(surface, toneMapper);
     }
 
-    void logarithmic(uint8_t *data, int stride, int width, int height, float exposure) {
+    void aldridge(uint8_t *data, int stride, int width, int height, float exposure, float cutoff, bool premultiplied) {
+        aldridge(rgba8888Surface(data, stride, width, height, premultiplied), exposure, cutoff);
+    }
+
+    void drago(const ToneSurface &surface, float exposure, float sdrWhitePoint) {
         const float rPrimary = 0.299f;
         const float gPrimary = 0.587f;
         const float bPrimary = 0.114f;
 
         const float coeffs[3] = {rPrimary, gPrimary, bPrimary};
-        LogarithmicToneMapper<FixedTag<float32_t, 4>> toneMapper(coeffs, exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+        DragoToneMapper<ScalableTag<float32_t>> toneMapper(coeffs, exposure, sdrWhitePoint);
+        convolveToneMapper(surface, toneMapper);
     }
 
-    void acesFilm(uint8_t *data, int stride, int width, int height, float exposure) {
-        AcesFilmicToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void drago(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint,
+               bool premultiplied) {
+        drago(rgba8888Surface(data, stride, width, height, premultiplied), exposure, sdrWhitePoint);
     }
 
-    void mobius(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak) {
-        MobiusToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure, transition, peak);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void uchimura(const ToneSurface &surface, float exposure) {
+        UchimuraToneMapper<ScalableTag<float32_t>> toneMapper(exposure);
+        convolveToneMapper(surface, toneMapper);
     }
 
-    void aldridge(uint8_t *data, int stride, int width, int height, float exposure, float cutoff) {
-        AldridgeToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure, cutoff);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void uchimura(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        uchimura(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
     }
 
-    void drago(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint) {
-        const float rPrimary = 0.299f;
-        const float gPrimary = 0.587f;
-        const float bPrimary = 0.114f;
+    void exposure(const ToneSurface &surface, float exposure) {
+        ExposureToneMapper<ScalableTag<float32_t>> toneMapper(exposure);
+        convolveToneMapper(surface, toneMapper);
+    }
 
-        const float coeffs[3] = {rPrimary, gPrimary, bPrimary};
-        DragoToneMapper<FixedTag<float32_t, 4>> toneMapper(coeffs, exposure, sdrWhitePoint);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void exposure(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        aire::exposure(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
+    }
+
+    void hejlBurgess(const ToneSurface &surface, float exposure) {
+        HejlBurgessToneMapper<ScalableTag<float32_t>> toneMapper(exposure);
+        convolveToneMapper(surface, toneMapper);
     }
 
-    void uchimura(uint8_t *data, int stride, int width, int height, float exposure) {
-        UchimuraToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void hejlBurgess(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        hejlBurgess(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
     }
 
-    void exposure(uint8_t *data, int stride, int width, int height, float exposure) {
-        ExposureToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void hableFilmic(const ToneSurface &surface, float exposure) {
+        HableFilmicToneMapper<ScalableTag<float32_t>> toneMapper(exposure);
+        convolveToneMapper(surface, toneMapper);
     }
 
-    void hejlBurgess(uint8_t *data, int stride, int width, int height, float exposure) {
-        HejlBurgessToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void hableFilmic(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        hableFilmic(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
     }
 
-    void hableFilmic(uint8_t *data, int stride, int width, int height, float exposure) {
-        HableFilmicToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void acesHill(const ToneSurface &surface, float exposure) {
+        AcesFilmicToneMapper<ScalableTag<float32_t>> toneMapper(exposure);
+        convolveToneMapper(surface, toneMapper);
     }
 
-    void acesHill(uint8_t *data, int stride, int width, int height, float exposure) {
-        AcesFilmicToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
+    void acesHill(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied) {
+        acesHill(rgba8888Surface(data, stride, width, height, premultiplied), exposure);
     }
 
-    void monochrome(uint8_t *data, int stride, int width, int height, float colors[4], float exposure) {
+    void monochrome(const ToneSurface &surface, float colors[4], float exposure) {
         const float rPrimary = 0.299f;
         const float gPrimary = 0.587f;
         const float bPrimary = 0.114f;
 
         const float coeffs[3] = {rPrimary, gPrimary, bPrimary};
-        MonochromeToneMapper<FixedTag<float32_t, 4>> toneMapper(colors, coeffs, exposure);
-        convolveToneMapper(data, stride, width, height, &toneMapper);
-    }
-
-    void whiteBalance(uint8_t *data, int stride, int width, int height, const float temperature, const float tnt) {
-        Eigen::Matrix3f RGBtoYIG;
-        RGBtoYIG << 0.299, 0.587, 0.114, 0.596, -0.274, -0.322, 0.212, -0.523, 0.311;
-        Eigen::Matrix3f YIQtoRGB = RGBtoYIG.inverse();
-        const Eigen::Vector3f filter = {0.93, 0.54, 0.0};
-        const float tmpr = temperature;
-        const float tint = tnt / 100.f;
-        const Eigen::Vector3f temp = {tmpr, tmpr, tmpr};
-
-        concurrency::parallel_for(2, height, [&](int y) {
-            auto pixels = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-            int x = 0;
-
-            for (; x < width; ++x) {
-                Eigen::Vector3f rgb;
-                rgb << pixels[0], pixels[1], pixels[2];
-                rgb /= 255.f;
-                Eigen::Vector3f yiq = RGBtoYIG * rgb;
-                yiq.z() = clamp(yiq.z() + tint * 0.5226 * 0.1, -0.5226, 0.5226);
-                rgb = YIQtoRGB * yiq;
-
-                Eigen::Vector3f processed;
-                processed[0] = (rgb[0] < 0.5 ? (2.0 * rgb[0] * filter[0]) : (1.0 - 2.0 * (1.0 - rgb[0]) * (1.0 - filter[0])));
-                processed[1] = (rgb[1] < 0.5 ? (2.0 * rgb[1] * filter[1]) : (1.0 - 2.0 * (1.0 - rgb[1]) * (1.0 - filter[1])));
-                processed[2] = (rgb[2] < 0.5 ? (2.0 * rgb[2] * filter[2]) : (1.0 - 2.0 * (1.0 - rgb[2]) * (1.0 - filter[2])));
-
-                Eigen::Vector3f rs = mix(rgb, processed, tmpr);
-                rs = (rs * 255.f).array().max(0.f).min(255.f);
-
-                pixels[0] = rs.x();
-                pixels[1] = rs.y();
-                pixels[2] = rs.z();
-
-                pixels += 4;
-            }
-        });
+        MonochromeToneMapper<ScalableTag<float32_t>> toneMapper(colors, coeffs, exposure);
+        convolveToneMapper(surface, toneMapper);
+    }
+
+    void monochrome(uint8_t *data, int stride, int width, int height, float colors[4], float exposure,
+                    bool premultiplied) {
+        monochrome(rgba8888Surface(data, stride, width, height, premultiplied), colors, exposure);
     }
-}
\ No newline at end of file
+}
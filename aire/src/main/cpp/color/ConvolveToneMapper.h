@@ -33,27 +33,85 @@
 #include <cstdint>
 
 namespace aire {
-    void logarithmic(uint8_t *data, int stride, int width, int height, float exposure);
 
-    void acesFilm(uint8_t *data, int stride, int width, int height, float exposure);
+    enum TonePixelFormat {
+        TONE_RGBA8888 = 0,
+        TONE_RGBA_F16 = 1,
+        TONE_RGBA1010102 = 2,
+        TONE_RGB565 = 3
+    };
 
-    void hejlBurgess(uint8_t *data, int stride, int width, int height, float exposure);
+    enum ToneTransfer {
+        TONE_TRANSFER_SRGB = 0,
+        TONE_TRANSFER_LINEAR = 1,
+        TONE_TRANSFER_PQ = 2,
+        TONE_TRANSFER_HLG = 3
+    };
 
-    void hableFilmic(uint8_t *data, int stride, int width, int height, float exposure);
+    /**
+     * Source is decoded by transfer to linear light where 1.0 is SDR white, PQ and HLG sources are BT.2020
+     * and reference white is 203 nits. Result is always sRGB encoded, source and destination may be the same
+     * memory when pixel formats are equal. Premultiplied pixels are unpremultiplied around the tone mapper
+     */
+    struct ToneSurface {
+        const uint8_t *source;
+        int sourceStride;
+        TonePixelFormat sourceFormat;
+        ToneTransfer transfer;
+        uint8_t *destination;
+        int destinationStride;
+        TonePixelFormat destinationFormat;
+        int width;
+        int height;
+        bool premultiplied = false;
+    };
 
-    void acesHill(uint8_t *data, int stride, int width, int height, float exposure);
+    void logarithmic(const ToneSurface &surface, float exposure);
 
-    void monochrome(uint8_t *data, int stride, int width, int height, float colors[4], float exposure);
+    void acesFilm(const ToneSurface &surface, float exposure);
 
-    void exposure(uint8_t *data, int stride, int width, int height, float exposure);
+    void hejlBurgess(const ToneSurface &surface, float exposure);
 
-    void whiteBalance(uint8_t *data, int stride, int width, int height, const float temperature = 1.f, const float tint = 0.f);
+    void hableFilmic(const ToneSurface &surface, float exposure);
 
-    void mobius(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak);
+    void acesHill(const ToneSurface &surface, float exposure);
 
-    void uchimura(uint8_t *data, int stride, int width, int height, float exposure);
+    void monochrome(const ToneSurface &surface, float colors[4], float exposure);
 
-    void aldridge(uint8_t *data, int stride, int width, int height, float exposure, float cutoff);
+    void exposure(const ToneSurface &surface, float exposure);
 
-    void drago(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint = 250.f);
+    void mobius(const ToneSurface &surface, float exposure, float transition, float peak);
+
+    void uchimura(const ToneSurface &surface, float exposure);
+
+    void aldridge(const ToneSurface &surface, float exposure, float cutoff);
+
+    void drago(const ToneSurface &surface, float exposure, float sdrWhitePoint = 250.f);
+
+    // RGBA8888 in place, premultiplied pixels are unpremultiplied and premultiplied back in registers
+    void logarithmic(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void acesFilm(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void hejlBurgess(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void hableFilmic(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void acesHill(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void monochrome(uint8_t *data, int stride, int width, int height, float colors[4], float exposure,
+                    bool premultiplied = false);
+
+    void exposure(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void mobius(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak,
+                bool premultiplied = false);
+
+    void uchimura(uint8_t *data, int stride, int width, int height, float exposure, bool premultiplied = false);
+
+    void aldridge(uint8_t *data, int stride, int width, int height, float exposure, float cutoff,
+                  bool premultiplied = false);
+
+    void drago(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint = 250.f,
+               bool premultiplied = false);
 }
\ No newline at end of file
@@ -29,60 +29,333 @@
  */
 
 #include "Gamut.h"
+#include "hwy/highway.h"
 #include "eotf-inl.h"
+#include "conversion/pixel-storage-inl.h"
 #include "concurrency.hpp"
+#include <thread>
+#include <vector>
 
 namespace aire {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
     using namespace aire::HWY_NAMESPACE;
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void
+    GamutLoadRGB(const D df, const uint8_t *src, const TransferFunction function, V &r, V &g, V &b) {
+        const Rebind<uint8_t, decltype(df)> du8;
+        const Rebind<int32_t, decltype(df)> di32;
+        const auto vRevertScale = Set(df, 1.f / 255.f);
+        Vec<decltype(du8)> ru, gu, bu, au;
+        LoadInterleaved4(du8, src, ru, gu, bu, au);
+        r = Mul(ConvertTo(df, PromoteTo(di32, ru)), vRevertScale);
+        g = Mul(ConvertTo(df, PromoteTo(di32, gu)), vRevertScale);
+        b = Mul(ConvertTo(df, PromoteTo(di32, bu)), vRevertScale);
+        if (function == TRANSFER_SRGB) {
+            r = aire::HWY_NAMESPACE::SRGBToLinear(df, r);
+            g = aire::HWY_NAMESPACE::SRGBToLinear(df, g);
+            b = aire::HWY_NAMESPACE::SRGBToLinear(df, b);
+        }
+    }
+
+    // Alpha is taken from the destination, so it's kept as is
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void
+    GamutStoreRGB(const D df, uint8_t *dst, const TransferFunction function, V r, V g, V b) {
+        const Rebind<uint8_t, decltype(df)> du8;
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        const auto vScale = Set(df, 255.f);
+        r = Clamp(r, zeros, ones);
+        g = Clamp(g, zeros, ones);
+        b = Clamp(b, zeros, ones);
+        if (function == TRANSFER_SRGB) {
+            r = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, r);
+            g = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, g);
+            b = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, b);
+        }
+        Vec<decltype(du8)> ru, gu, bu, au;
+        LoadInterleaved4(du8, dst, ru, gu, bu, au);
+        ru = DemoteTo(du8, NearestInt(Clamp(Mul(r, vScale), zeros, vScale)));
+        gu = DemoteTo(du8, NearestInt(Clamp(Mul(g, vScale), zeros, vScale)));
+        bu = DemoteTo(du8, NearestInt(Clamp(Mul(b, vScale), zeros, vScale)));
+        StoreInterleaved4(ru, gu, bu, au, du8, dst);
+    }
+
+    template<class D, typename V = Vec<D>>
+    struct GamutMatrix {
+        V m[9];
+
+        GamutMatrix(const D df, const Eigen::Matrix3f &matrix) {
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    m[i * 3 + j] = Set(df, matrix(i, j));
+                }
+            }
+        }
+
+        HWY_FAST_MATH_INLINE void transform(V &a, V &b, V &c) const {
+            const V na = MulAdd(m[0], a, MulAdd(m[1], b, Mul(m[2], c)));
+            const V nb = MulAdd(m[3], a, MulAdd(m[4], b, Mul(m[5], c)));
+            const V nc = MulAdd(m[6], a, MulAdd(m[7], b, Mul(m[8], c)));
+            a = na;
+            b = nb;
+            c = nc;
+        }
+    };
+
+    static int gamutThreadCount(const int width, const int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   height * width / (256 * 256)), 1, 12);
+    }
+
     void bitmapToXYZ(uint8_t *data, int stride, float *xyzBitmap, int xyzStride, int width, int height, TransferFunction function,
                      Eigen::Matrix3f conversionMatrix) {
-        concurrency::parallel_for(2, height, [&](int y) {
+        const ScalableTag<float> df;
+        const int lanes = static_cast<int>(Lanes(df));
+        const GamutMatrix matrix(df, conversionMatrix);
+
+        concurrency::parallel_for(gamutThreadCount(width, height), height, [&](int y) {
             auto src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
             auto dst = reinterpret_cast<float *>(reinterpret_cast<uint8_t *>(xyzBitmap) + xyzStride * y);
-            for (int x = 0; x < width; ++x) {
-                float r, g, b;
-                r = src[0];
-                g = src[1];
-                b = src[2];
-                if (function == TRANSFER_SRGB) {
-                    r = SRGBToLinear(r / 255.f);
-                    g = SRGBToLinear(g / 255.f);
-                    b = SRGBToLinear(b / 255.f);
+            HWY_ALIGN uint8_t srcTail[HWY_MAX_LANES_D(decltype(df)) * 4] = {};
+            HWY_ALIGN float dstTail[HWY_MAX_LANES_D(decltype(df)) * 3];
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                const uint8_t *s = src + x * 4;
+                float *d = dst + x * 3;
+                if (count < lanes) {
+                    std::copy(s, s + count * 4, srcTail);
+                    s = srcTail;
+                    d = dstTail;
+                }
+                Vec<decltype(df)> r, g, b;
+                GamutLoadRGB(df, s, function, r, g, b);
+                matrix.transform(r, g, b);
+                StoreInterleaved3(r, g, b, df, d);
+                if (count < lanes) {
+                    std::copy(dstTail, dstTail + count * 3, dst + x * 3);
                 }
-                Eigen::Vector3f vec3 = {r, g, b};
-                auto result = conversionMatrix * vec3;
-                dst[0] = result.x();
-                dst[1] = result.y();
-                dst[2] = result.z();
-                dst += 3;
-                src += 4;
             }
         });
     }
 
     void xyzToBitmap(uint8_t *data, int stride, float *xyzBitmap, int xyzStride, int width, int height, TransferFunction function,
                      Eigen::Matrix3f conversionMatrix) {
-        concurrency::parallel_for(2, height, [&](int y) {
+        const ScalableTag<float> df;
+        const int lanes = static_cast<int>(Lanes(df));
+        const GamutMatrix matrix(df, conversionMatrix);
+
+        concurrency::parallel_for(gamutThreadCount(width, height), height, [&](int y) {
             auto src = reinterpret_cast<float *>(reinterpret_cast<uint8_t *>(xyzBitmap) + xyzStride * y);
             auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + stride * y);
-            for (int x = 0; x < width; ++x) {
-                float r, g, b;
-                r = src[0];
-                g = src[1];
-                b = src[2];
-                if (function == TRANSFER_SRGB) {
-                    r = LinearSRGBTosRGB(r);
-                    g = LinearSRGBTosRGB(g);
-                    b = LinearSRGBTosRGB(b);
+            HWY_ALIGN float srcTail[HWY_MAX_LANES_D(decltype(df)) * 3] = {};
+            HWY_ALIGN uint8_t dstTail[HWY_MAX_LANES_D(decltype(df)) * 4] = {};
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                const float *s = src + x * 3;
+                uint8_t *d = dst + x * 4;
+                if (count < lanes) {
+                    std::copy(s, s + count * 3, srcTail);
+                    std::copy(d, d + count * 4, dstTail);
+                    s = srcTail;
+                    d = dstTail;
+                }
+                Vec<decltype(df)> r, g, b;
+                LoadInterleaved3(df, s, r, g, b);
+                matrix.transform(r, g, b);
+                GamutStoreRGB(df, d, function, r, g, b);
+                if (count < lanes) {
+                    std::copy(dstTail, dstTail + count * 4, dst + x * 4);
+                }
+            }
+        });
+    }
+
+    void bitmapToXYZF16(const uint8_t *data, int stride, uint16_t *xyzPlanes, int planeStride, int width, int height,
+                        TransferFunction function, Eigen::Matrix3f conversionMatrix) {
+        const ScalableTag<float> df;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        const Rebind<uint16_t, decltype(df)> du16;
+        const int lanes = static_cast<int>(Lanes(df));
+        const GamutMatrix matrix(df, conversionMatrix);
+        const size_t planeSize = static_cast<size_t>(planeStride) * height;
+
+        concurrency::parallel_for(gamutThreadCount(width, height), height, [&](int y) {
+            auto src = data + y * stride;
+            uint16_t *planes[3] = {xyzPlanes + y * planeStride,
+                                   xyzPlanes + planeSize + y * planeStride,
+                                   xyzPlanes + planeSize * 2 + y * planeStride};
+            HWY_ALIGN uint8_t srcTail[HWY_MAX_LANES_D(decltype(df)) * 4] = {};
+            HWY_ALIGN uint16_t dstTail[HWY_MAX_LANES_D(decltype(df)) * 3];
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                const uint8_t *s = src + x * 4;
+                uint16_t *d[3] = {planes[0] + x, planes[1] + x, planes[2] + x};
+                if (count < lanes) {
+                    std::copy(s, s + count * 4, srcTail);
+                    s = srcTail;
+                    for (int c = 0; c < 3; ++c) {
+                        d[c] = dstTail + c * lanes;
+                    }
+                }
+                Vec<decltype(df)> r, g, b;
+                GamutLoadRGB(df, s, function, r, g, b);
+                matrix.transform(r, g, b);
+                StoreU(BitCast(du16, DemoteTo(dh, r)), du16, d[0]);
+                StoreU(BitCast(du16, DemoteTo(dh, g)), du16, d[1]);
+                StoreU(BitCast(du16, DemoteTo(dh, b)), du16, d[2]);
+                if (count < lanes) {
+                    for (int c = 0; c < 3; ++c) {
+                        std::copy(d[c], d[c] + count, planes[c] + x);
+                    }
                 }
-                Eigen::Vector3f vec3 = {r, g, b};
-                auto result = (conversionMatrix * vec3 * 255.f).array().max(0.f).min(255.f);
-                dst[0] = result.x();
-                dst[1] = result.y();
-                dst[2] = result.z();
-                src += 3;
-                dst += 4;
             }
         });
     }
-}
\ No newline at end of file
+
+    void xyzF16ToBitmap(uint8_t *data, int stride, const uint16_t *xyzPlanes, int planeStride, int width, int height,
+                        TransferFunction function, Eigen::Matrix3f conversionMatrix) {
+        const ScalableTag<float> df;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        const Rebind<uint16_t, decltype(df)> du16;
+        const int lanes = static_cast<int>(Lanes(df));
+        const GamutMatrix matrix(df, conversionMatrix);
+        const size_t planeSize = static_cast<size_t>(planeStride) * height;
+
+        concurrency::parallel_for(gamutThreadCount(width, height), height, [&](int y) {
+            auto dst = data + y * stride;
+            const uint16_t *planes[3] = {xyzPlanes + y * planeStride,
+                                         xyzPlanes + planeSize + y * planeStride,
+                                         xyzPlanes + planeSize * 2 + y * planeStride};
+            HWY_ALIGN uint16_t srcTail[HWY_MAX_LANES_D(decltype(df)) * 3] = {};
+            HWY_ALIGN uint8_t dstTail[HWY_MAX_LANES_D(decltype(df)) * 4] = {};
+            for (int x = 0; x < width; x += lanes) {
+                const int count = std::min(lanes, width - x);
+                const uint16_t *s[3] = {planes[0] + x, planes[1] + x, planes[2] + x};
+                uint8_t *d = dst + x * 4;
+                if (count < lanes) {
+                    for (int c = 0; c < 3; ++c) {
+                        std::copy(s[c], s[c] + count, srcTail + c * lanes);
+                        s[c] = srcTail + c * lanes;
+                    }
+                    std::copy(d, d + count * 4, dstTail);
+                    d = dstTail;
+                }
+                auto r = PromoteTo(df, BitCast(dh, LoadU(du16, s[0])));
+                auto g = PromoteTo(df, BitCast(dh, LoadU(du16, s[1])));
+                auto b = PromoteTo(df, BitCast(dh, LoadU(du16, s[2])));
+                matrix.transform(r, g, b);
+                GamutStoreRGB(df, d, function, r, g, b);
+                if (count < lanes) {
+                    std::copy(dstTail, dstTail + count * 4, dst + x * 4);
+                }
+            }
+        });
+    }
+
+    template<PixelStorage Storage>
+    static void linearRGBTransformImpl(uint8_t *data, int stride, int width, int height, TransferFunction function,
+                                       const Eigen::Matrix3f &transform) {
+        const ScalableTag<float> df;
+        const GamutMatrix matrix(df, transform);
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+
+        concurrency::parallel_for(gamutThreadCount(width, height), height, [&](int y) {
+            auto row = data + y * stride;
+            TransformPixelRow<Storage, Storage>(df, row, row, width, [&](Vec<decltype(df)> &r, Vec<decltype(df)> &g,
+                                                                     Vec<decltype(df)> &b, Vec<decltype(df)> &) {
+                if (function == TRANSFER_SRGB) {
+                    r = aire::HWY_NAMESPACE::SRGBToLinear(df, r);
+                    g = aire::HWY_NAMESPACE::SRGBToLinear(df, g);
+                    b = aire::HWY_NAMESPACE::SRGBToLinear(df, b);
+                }
+                matrix.transform(r, g, b);
+                if constexpr (Storage != PIXEL_RGBA_F16) {
+                    r = Clamp(r, zeros, ones);
+                    g = Clamp(g, zeros, ones);
+                    b = Clamp(b, zeros, ones);
+                }
+                if (function == TRANSFER_SRGB) {
+                    r = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, r);
+                    g = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, g);
+                    b = aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, b);
+                }
+            });
+        });
+    }
+
+    void linearRGBTransform(uint8_t *data, int stride, int width, int height, PixelStorage storage,
+                            TransferFunction function, Eigen::Matrix3f transform) {
+        DispatchPixelStorage(storage, [&](auto tag) {
+            linearRGBTransformImpl<decltype(tag)::value>(data, stride, width, height, function, transform);
+        });
+    }
+
+    void linearRGBTransform(uint8_t *data, int stride, int width, int height, TransferFunction function,
+                            Eigen::Matrix3f transform) {
+        linearRGBTransformImpl<PIXEL_RGBA8888>(data, stride, width, height, function, transform);
+    }
+
+    void chromaticAdaptation(uint8_t *data, int stride, int width, int height, float sourceTemperature,
+                             float destinationTemperature, PixelStorage storage, TransferFunction function) {
+        const Eigen::Matrix3f rgbToXYZ = GamutRgbToXYZ(SRGBPrimaries, IlluminantD65);
+        const Eigen::Matrix3f adaptation = BradfordAdaptation(TemperatureToXy(sourceTemperature),
+                                                              TemperatureToXy(destinationTemperature));
+        const Eigen::Matrix3f transform = rgbToXYZ.inverse() * adaptation * rgbToXYZ;
+        linearRGBTransform(data, stride, width, height, storage, function, transform);
+    }
+
+    void whiteBalance(uint8_t *data, int stride, int width, int height, const float temperature, const float tint,
+                      const bool premultiplied) {
+        Eigen::Matrix3f rgbToYiq;
+        rgbToYiq << 0.299f, 0.587f, 0.114f, 0.596f, -0.274f, -0.322f, 0.212f, -0.523f, 0.311f;
+        const Eigen::Matrix3f yiqToRgb = rgbToYiq.inverse();
+
+        const ScalableTag<float> df;
+        const GamutMatrix toYiq(df, rgbToYiq);
+        const GamutMatrix toRgb(df, yiqToRgb);
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        const auto half = Set(df, 0.5f);
+        const auto two = Set(df, 2.f);
+        const auto qLimit = Set(df, 0.5226f);
+        const auto qShift = Set(df, tint / 100.f * 0.5226f * 0.1f);
+        const auto strength = Set(df, temperature);
+        // Overlay with warm filter color
+        const Vec<decltype(df)> filter[3] = {Set(df, 0.93f), Set(df, 0.54f), Set(df, 0.f)};
+
+        auto overlay = [&](const Vec<decltype(df)> v, const Vec<decltype(df)> f) {
+            const auto low = Mul(Mul(two, v), f);
+            const auto high = NegMulAdd(Mul(two, Sub(ones, v)), Sub(ones, f), ones);
+            return IfThenElse(Lt(v, half), low, high);
+        };
+
+        concurrency::parallel_for(gamutThreadCount(width, height), height, [&](int y) {
+            auto row = data + y * stride;
+            TransformPixelRow<PIXEL_RGBA8888, PIXEL_RGBA8888>(df, row, row, width, [&](Vec<decltype(df)> &r,
+                                                                                     Vec<decltype(df)> &g,
+                                                                                     Vec<decltype(df)> &b,
+                                                                                     Vec<decltype(df)> &a) {
+                if (premultiplied) {
+                    UnpremultiplyPixels(df, r, g, b, a);
+                }
+                toYiq.transform(r, g, b);
+                b = Clamp(Add(b, qShift), Neg(qLimit), qLimit);
+                toRgb.transform(r, g, b);
+                r = MulAdd(Sub(overlay(r, filter[0]), r), strength, r);
+                g = MulAdd(Sub(overlay(g, filter[1]), g), strength, g);
+                b = MulAdd(Sub(overlay(b, filter[2]), b), strength, b);
+                r = Clamp(r, zeros, ones);
+                g = Clamp(g, zeros, ones);
+                b = Clamp(b, zeros, ones);
+                if (premultiplied) {
+                    PremultiplyPixels<PIXEL_RGBA8888>(df, r, g, b, a);
+                }
+            });
+        });
+    }
+}
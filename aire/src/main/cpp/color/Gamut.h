@@ -31,6 +31,9 @@
 #pragma once
 
 #include "Eigen/Eigen"
+#include <algorithm>
+#include <cstdint>
+#include "conversion/PixelStorage.h"
 
 static const Eigen::Vector2f IlluminantD65 = {0.31272, 0.32903};
 
@@ -43,7 +46,7 @@ static Eigen::Matrix<float, 3, 2> getSRGBPrimaries() {
     Eigen::Vector2f rPrimary = {0.640f, 0.330f};
     Eigen::Vector2f gPrimary = {0.300f, 0.600f};
     Eigen::Vector2f bPrimary = {0.150f, 0.060f};
-    m << rPrimary, gPrimary, bPrimary;
+    m << rPrimary.transpose(), gPrimary.transpose(), bPrimary.transpose();
     return m;
 }
 
@@ -81,14 +84,79 @@ GamutRgbToXYZ(const Eigen::Matrix<float, 3, 2> primariesXy, const Eigen::Vector2
     return conversion;
 }
 
+static const Eigen::Matrix3f BradfordMatrix({{0.8951f, 0.2664f, -0.1614f},
+                                              {-0.7502f, 1.7135f, 0.0367f},
+                                              {0.0389f, -0.0685f, 1.0296f}});
+
+// Bradford chromatic adaptation in XYZ from source to destination white point
+static Eigen::Matrix3f BradfordAdaptation(const Eigen::Vector2f sourceWhite, const Eigen::Vector2f destinationWhite) {
+    const Eigen::Vector3f sourceLms = BradfordMatrix * getWhitePoint(sourceWhite);
+    const Eigen::Vector3f destinationLms = BradfordMatrix * getWhitePoint(destinationWhite);
+    const Eigen::Matrix3f scale = (destinationLms.array() / sourceLms.array()).matrix().asDiagonal();
+    return BradfordMatrix.inverse() * scale * BradfordMatrix;
+}
+
+// CIE xy of a correlated color temperature: Planckian locus approximation below 4000K, daylight locus above
+static Eigen::Vector2f TemperatureToXy(const float kelvin) {
+    const float t = std::clamp(kelvin, 1667.f, 25000.f);
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    float x, y;
+    if (t < 4000.f) {
+        x = -0.2661239e9f / t3 - 0.2343589e6f / t2 + 0.8776956e3f / t + 0.179910f;
+        if (t < 2222.f) {
+            y = -1.1063814f * x * x * x - 1.34811020f * x * x + 2.18555832f * x - 0.20219683f;
+        } else {
+            y = -0.9549476f * x * x * x - 1.37418593f * x * x + 2.09137015f * x - 0.16748867f;
+        }
+    } else {
+        if (t <= 7000.f) {
+            x = -4.6070e9f / t3 + 2.9678e6f / t2 + 0.09911e3f / t + 0.244063f;
+        } else {
+            x = -2.0064e9f / t3 + 1.9018e6f / t2 + 0.24748e3f / t + 0.237040f;
+        }
+        y = -3.f * x * x + 2.870f * x - 0.275f;
+    }
+    return {x, y};
+}
+
 enum TransferFunction {
+    TRANSFER_LINEAR = 0,
     TRANSFER_SRGB = 1
 };
 
 namespace aire {
+    // Interleaved XYZ, 3 floats per pixel
     void bitmapToXYZ(uint8_t *data, int stride, float *xyzBitmap, int xyzStride, int width, int height, TransferFunction function,
                      Eigen::Matrix3f conversionMatrix);
 
     void xyzToBitmap(uint8_t *data, int stride, float *xyzBitmap, int xyzStride, int width, int height, TransferFunction function,
                      Eigen::Matrix3f conversionMatrix);
-}
\ No newline at end of file
+
+    // Planar half float XYZ, X, Y and Z planes of planeStride * height elements follow each other.
+    // Takes half of interleaved float XYZ memory for ops that need whole XYZ image
+    void bitmapToXYZF16(const uint8_t *data, int stride, uint16_t *xyzPlanes, int planeStride, int width, int height,
+                        TransferFunction function, Eigen::Matrix3f conversionMatrix);
+
+    void xyzF16ToBitmap(uint8_t *data, int stride, const uint16_t *xyzPlanes, int planeStride, int width, int height,
+                        TransferFunction function, Eigen::Matrix3f conversionMatrix);
+
+    // Decodes transfer, applies matrix to linear RGB and encodes back in place without intermediate buffers
+    void linearRGBTransform(uint8_t *data, int stride, int width, int height, TransferFunction function,
+                            Eigen::Matrix3f matrix);
+
+    // Same transform over any pixel storage, alpha is kept
+    void linearRGBTransform(uint8_t *data, int stride, int width, int height, PixelStorage storage,
+                            TransferFunction function, Eigen::Matrix3f matrix);
+
+    // White balance by Bradford adaptation of sRGB primaries lit by source temperature to destination temperature,
+    // function is the transfer the pixels are encoded with, F16 values outside of [0, 1] are kept
+    void chromaticAdaptation(uint8_t *data, int stride, int width, int height, float sourceTemperature,
+                             float destinationTemperature = 6504.f, PixelStorage storage = PIXEL_RGBA8888,
+                             TransferFunction function = TRANSFER_SRGB);
+
+    // Tint shifts Q axis of YIQ, temperature blends towards overlay with warm filter,
+    // premultiplied pixels are unpremultiplied and premultiplied back in registers
+    void whiteBalance(uint8_t *data, int stride, int width, int height, float temperature = 1.f, float tint = 0.f,
+                      bool premultiplied = false);
+}
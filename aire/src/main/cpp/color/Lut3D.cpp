@@ -0,0 +1,478 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 22/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "color/Lut3D.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "Lut3D.h"
+#include "conversion/attenuate-inl.h"
+#include "concurrency.hpp"
+#include "jni/JNIUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    /**
+     * Tetrahedral interpolation: fractions sorted descending as x1 >= x2 >= x3 pick the tetrahedron
+     * c000 -> A -> B -> c111 where A steps along the largest axis and B along the two largest ones
+     */
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void
+    Lut3DTetrahedral(const D df, const float *HWY_RESTRICT table, const int lutSize, V &r, V &g, V &b) {
+        const RebindToSigned<D> di;
+        const auto zeros = Zero(df);
+        const auto vMax = Set(df, static_cast<float>(lutSize - 1));
+        const auto vLast = Set(di, lutSize - 2);
+
+        const auto sr = Clamp(Mul(r, vMax), zeros, vMax);
+        const auto sg = Clamp(Mul(g, vMax), zeros, vMax);
+        const auto sb = Clamp(Mul(b, vMax), zeros, vMax);
+
+        const auto ir = Min(ConvertTo(di, sr), vLast);
+        const auto ig = Min(ConvertTo(di, sg), vLast);
+        const auto ib = Min(ConvertTo(di, sb), vLast);
+
+        const auto fr = Sub(sr, ConvertTo(df, ir));
+        const auto fg = Sub(sg, ConvertTo(df, ig));
+        const auto fb = Sub(sb, ConvertTo(df, ib));
+
+        const auto strideR = Set(di, 4);
+        const auto strideG = Set(di, lutSize * 4);
+        const auto strideB = Set(di, lutSize * lutSize * 4);
+        const auto strideAll = Add(strideR, Add(strideG, strideB));
+
+        const auto base = Add(ShiftLeft<2>(ir), Add(Mul(ig, strideG), Mul(ib, strideB)));
+
+        const auto rIsMax = And(Ge(fr, fg), Ge(fr, fb));
+        const auto gIsMax = AndNot(rIsMax, Ge(fg, fb));
+        const auto bIsMin = And(Le(fb, fg), Le(fb, fr));
+        const auto gIsMin = AndNot(bIsMin, Le(fg, fr));
+
+        const auto offsetA = IfThenElse(RebindMask(di, rIsMax), strideR,
+                                        IfThenElse(RebindMask(di, gIsMax), strideG, strideB));
+        const auto offsetMin = IfThenElse(RebindMask(di, bIsMin), strideB,
+                                          IfThenElse(RebindMask(di, gIsMin), strideG, strideR));
+
+        const auto index0 = base;
+        const auto indexA = Add(base, offsetA);
+        const auto indexB = Add(base, Sub(strideAll, offsetMin));
+        const auto index1 = Add(base, strideAll);
+
+        const auto x1 = Max(fr, Max(fg, fb));
+        const auto x3 = Min(fr, Min(fg, fb));
+        const auto x2 = Sub(Sub(Add(fr, Add(fg, fb)), x1), x3);
+
+        const auto w0 = Sub(Set(df, 1.f), x1);
+        const auto wA = Sub(x1, x2);
+        const auto wB = Sub(x2, x3);
+        const auto w1 = x3;
+
+        V channels[3];
+        for (int c = 0; c < 3; ++c) {
+            const float *plane = table + c;
+            channels[c] = MulAdd(w0, GatherIndex(df, plane, index0),
+                                 MulAdd(wA, GatherIndex(df, plane, indexA),
+                                        MulAdd(wB, GatherIndex(df, plane, indexB),
+                                               Mul(w1, GatherIndex(df, plane, index1)))));
+        }
+        r = channels[0];
+        g = channels[1];
+        b = channels[2];
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void
+    Lut3DNormalize(const D df, const float *domainMin, const float *domainScale, V &r, V &g, V &b) {
+        r = Mul(Sub(r, Set(df, domainMin[0])), Set(df, domainScale[0]));
+        g = Mul(Sub(g, Set(df, domainMin[1])), Set(df, domainScale[1]));
+        b = Mul(Sub(b, Set(df, domainMin[2])), Set(df, domainScale[2]));
+    }
+
+    template<class D>
+    HWY_INLINE void
+    Lut3DPixelsRGBA8888(const D df, const float *HWY_RESTRICT table, const int lutSize,
+                        const float *domainMin, const float *domainScale, const bool premultiplied,
+                        const uint8_t *src, uint8_t *dst) {
+        const Rebind<uint8_t, decltype(df)> du8;
+        const Rebind<int32_t, decltype(df)> di32;
+        const auto vScale = Set(df, 255.f);
+        const auto vRevertScale = Set(df, 1.f / 255.f);
+        const auto zeros = Zero(df);
+        Vec<decltype(du8)> ru, gu, bu, au;
+        LoadInterleaved4(du8, src, ru, gu, bu, au);
+        auto r = Mul(ConvertTo(df, PromoteTo(di32, ru)), vRevertScale);
+        auto g = Mul(ConvertTo(df, PromoteTo(di32, gu)), vRevertScale);
+        auto b = Mul(ConvertTo(df, PromoteTo(di32, bu)), vRevertScale);
+        auto scale = vScale;
+        if (premultiplied) {
+            const auto a = Mul(ConvertTo(df, PromoteTo(di32, au)), vRevertScale);
+            r = Min(UnattenuateVec(df, r, a), Set(df, 1.f));
+            g = Min(UnattenuateVec(df, g, a), Set(df, 1.f));
+            b = Min(UnattenuateVec(df, b, a), Set(df, 1.f));
+            scale = Mul(a, vScale);
+        }
+        Lut3DNormalize(df, domainMin, domainScale, r, g, b);
+        Lut3DTetrahedral(df, table, lutSize, r, g, b);
+        r = Clamp(Round(Mul(Clamp(r, zeros, Set(df, 1.f)), scale)), zeros, vScale);
+        g = Clamp(Round(Mul(Clamp(g, zeros, Set(df, 1.f)), scale)), zeros, vScale);
+        b = Clamp(Round(Mul(Clamp(b, zeros, Set(df, 1.f)), scale)), zeros, vScale);
+        StoreInterleaved4(DemoteTo(du8, r), DemoteTo(du8, g), DemoteTo(du8, b), au, du8, dst);
+    }
+
+    template<class D>
+    HWY_INLINE void
+    Lut3DPixelsRGBAF16(const D df, const float *HWY_RESTRICT table, const int lutSize,
+                       const float *domainMin, const float *domainScale, const bool premultiplied,
+                       const uint16_t *src, uint16_t *dst) {
+        const Rebind<uint16_t, decltype(df)> du16;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        Vec<decltype(du16)> ru, gu, bu, au;
+        LoadInterleaved4(du16, src, ru, gu, bu, au);
+        auto r = PromoteTo(df, BitCast(dh, ru));
+        auto g = PromoteTo(df, BitCast(dh, gu));
+        auto b = PromoteTo(df, BitCast(dh, bu));
+        const auto a = PromoteTo(df, BitCast(dh, au));
+        if (premultiplied) {
+            r = UnattenuateVec(df, r, a);
+            g = UnattenuateVec(df, g, a);
+            b = UnattenuateVec(df, b, a);
+        }
+        Lut3DNormalize(df, domainMin, domainScale, r, g, b);
+        Lut3DTetrahedral(df, table, lutSize, r, g, b);
+        if (premultiplied) {
+            r = Mul(r, a);
+            g = Mul(g, a);
+            b = Mul(b, a);
+        }
+        StoreInterleaved4(BitCast(du16, DemoteTo(dh, r)), BitCast(du16, DemoteTo(dh, g)),
+                          BitCast(du16, DemoteTo(dh, b)), au, du16, dst);
+    }
+
+    template<typename T>
+    void ApplyLut3DImpl(const float *table, const int lutSize, const float *domainMin, const float *domainScale,
+                        T *data, const int stride, const int width, const int height, const bool premultiplied) {
+        const ScalableTag<float32_t> df;
+        const int lanes = static_cast<int>(Lanes(df));
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto row = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(data) + y * stride);
+            int x = 0;
+
+            for (; x + lanes <= width; x += lanes) {
+                T *px = row + x * 4;
+                if constexpr (std::is_same<T, uint16_t>::value) {
+                    Lut3DPixelsRGBAF16(df, table, lutSize, domainMin, domainScale, premultiplied, px, px);
+                } else {
+                    Lut3DPixelsRGBA8888(df, table, lutSize, domainMin, domainScale, premultiplied, px, px);
+                }
+            }
+
+            if (x < width) {
+                const int remaining = width - x;
+                HWY_ALIGN T tail[HWY_MAX_LANES_D(decltype(df)) * 4] = {};
+                std::copy(row + x * 4, row + width * 4, tail);
+                if constexpr (std::is_same<T, uint16_t>::value) {
+                    Lut3DPixelsRGBAF16(df, table, lutSize, domainMin, domainScale, premultiplied, tail, tail);
+                } else {
+                    Lut3DPixelsRGBA8888(df, table, lutSize, domainMin, domainScale, premultiplied, tail, tail);
+                }
+                std::copy(tail, tail + remaining * 4, row + x * 4);
+            }
+        });
+    }
+
+    void ApplyLut3DRGBA8888(const float *table, const int lutSize, const float *domainMin, const float *domainScale,
+                            uint8_t *data, const int stride, const int width, const int height,
+                            const bool premultiplied) {
+        ApplyLut3DImpl(table, lutSize, domainMin, domainScale, data, stride, width, height, premultiplied);
+    }
+
+    void ApplyLut3DRGBAF16(const float *table, const int lutSize, const float *domainMin, const float *domainScale,
+                           uint16_t *data, const int stride, const int width, const int height,
+                           const bool premultiplied) {
+        ApplyLut3DImpl(table, lutSize, domainMin, domainScale, data, stride, width, height, premultiplied);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(ApplyLut3DRGBA8888);
+    HWY_EXPORT(ApplyLut3DRGBAF16);
+
+    Lut3D::Lut3D(int size, std::vector<float> table, const float domainMin[3], const float domainMax[3])
+            : size(size), table(std::move(table)) {
+        for (int i = 0; i < 3; ++i) {
+            this->domainMin[i] = domainMin[i];
+            const float range = domainMax[i] - domainMin[i];
+            this->domainScale[i] = range != 0.f ? 1.f / range : 1.f;
+        }
+    }
+
+    void Lut3D::applyRGBA8888(uint8_t *data, int stride, int width, int height, bool premultiplied) const {
+        HWY_DYNAMIC_DISPATCH(ApplyLut3DRGBA8888)(table.data(), size, domainMin, domainScale,
+                                                 data, stride, width, height, premultiplied);
+    }
+
+    void Lut3D::applyRGBAF16(uint16_t *data, int stride, int width, int height, bool premultiplied) const {
+        HWY_DYNAMIC_DISPATCH(ApplyLut3DRGBAF16)(table.data(), size, domainMin, domainScale,
+                                                data, stride, width, height, premultiplied);
+    }
+
+    static bool isLut3DNumber(const std::string &token) {
+        if (token.empty()) {
+            return false;
+        }
+        const char c = token[0];
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+    }
+
+    static std::vector<std::string> splitLut3DLine(const std::string &line) {
+        std::istringstream stream(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (stream >> token) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    static std::shared_ptr<Lut3D> parseCube(const std::string &text) {
+        std::istringstream stream(text);
+        std::string line;
+        int size = 0;
+        float domainMin[3] = {0.f, 0.f, 0.f};
+        float domainMax[3] = {1.f, 1.f, 1.f};
+        std::vector<float> table;
+        int entries = 0;
+
+        while (std::getline(stream, line)) {
+            const auto tokens = splitLut3DLine(line);
+            if (tokens.empty() || tokens[0][0] == '#') {
+                continue;
+            }
+            const std::string &keyword = tokens[0];
+            if (isLut3DNumber(keyword)) {
+                if (size == 0) {
+                    throw AireError("LUT_3D_SIZE must precede .cube table data");
+                }
+                if (tokens.size() < 3 || entries >= size * size * size) {
+                    throw AireError("Malformed .cube table data");
+                }
+                float *node = table.data() + entries * 4;
+                node[0] = std::strtof(tokens[0].c_str(), nullptr);
+                node[1] = std::strtof(tokens[1].c_str(), nullptr);
+                node[2] = std::strtof(tokens[2].c_str(), nullptr);
+                entries += 1;
+            } else if (keyword == "LUT_3D_SIZE" && tokens.size() > 1) {
+                size = std::atoi(tokens[1].c_str());
+                if (size < 2 || size > 256) {
+                    throw AireError("LUT_3D_SIZE must be in range [2, 256], but received " + tokens[1]);
+                }
+                table.resize(size * size * size * 4, 0.f);
+            } else if (keyword == "LUT_1D_SIZE") {
+                throw AireError("1D .cube LUTs are not supported");
+            } else if (keyword == "DOMAIN_MIN" && tokens.size() > 3) {
+                for (int i = 0; i < 3; ++i) {
+                    domainMin[i] = std::strtof(tokens[i + 1].c_str(), nullptr);
+                }
+            } else if (keyword == "DOMAIN_MAX" && tokens.size() > 3) {
+                for (int i = 0; i < 3; ++i) {
+                    domainMax[i] = std::strtof(tokens[i + 1].c_str(), nullptr);
+                }
+            } else if (keyword == "LUT_3D_INPUT_RANGE" && tokens.size() > 2) {
+                const float low = std::strtof(tokens[1].c_str(), nullptr);
+                const float high = std::strtof(tokens[2].c_str(), nullptr);
+                std::fill(domainMin, domainMin + 3, low);
+                std::fill(domainMax, domainMax + 3, high);
+            }
+        }
+
+        if (size == 0 || entries != size * size * size) {
+            throw AireError("Incomplete .cube LUT, expected " + std::to_string(size * size * size) +
+                            " entries, but received " + std::to_string(entries));
+        }
+        return std::make_shared<Lut3D>(size, std::move(table), domainMin, domainMax);
+    }
+
+    /**
+     * .3dl stores input shaper ticks on the first numeric line and integer output nodes
+     * where blue changes fastest, output bit depth is taken from Mesh header or from the largest value
+     */
+    static std::shared_ptr<Lut3D> parse3dl(const std::string &text) {
+        std::istringstream stream(text);
+        std::string line;
+        int size = 0;
+        int outputDepth = 0;
+        std::vector<int> nodes;
+
+        while (std::getline(stream, line)) {
+            const auto tokens = splitLut3DLine(line);
+            if (tokens.empty() || tokens[0][0] == '#') {
+                continue;
+            }
+            if (tokens[0] == "Mesh" && tokens.size() > 2) {
+                size = (1 << std::atoi(tokens[1].c_str())) + 1;
+                outputDepth = std::atoi(tokens[2].c_str());
+                continue;
+            }
+            if (!isLut3DNumber(tokens[0])) {
+                continue;
+            }
+            if (tokens.size() > 3) {
+                if (size == 0) {
+                    size = static_cast<int>(tokens.size());
+                }
+                continue;
+            }
+            if (tokens.size() != 3) {
+                throw AireError("Malformed .3dl table data");
+            }
+            for (int i = 0; i < 3; ++i) {
+                nodes.push_back(std::atoi(tokens[i].c_str()));
+            }
+        }
+
+        const int entries = static_cast<int>(nodes.size() / 3);
+        if (size == 0) {
+            size = static_cast<int>(std::round(std::cbrt(static_cast<double>(entries))));
+        }
+        if (size < 2 || size > 256 || entries != size * size * size) {
+            throw AireError("Incomplete .3dl LUT, received " + std::to_string(entries) + " entries");
+        }
+
+        int maxValue = 1;
+        if (outputDepth > 0) {
+            maxValue = (1 << outputDepth) - 1;
+        } else {
+            const int largest = *std::max_element(nodes.begin(), nodes.end());
+            for (int depth: {8, 10, 12, 14, 16}) {
+                maxValue = (1 << depth) - 1;
+                if (largest <= maxValue) {
+                    break;
+                }
+            }
+        }
+
+        const float scale = 1.f / static_cast<float>(maxValue);
+        std::vector<float> table(size * size * size * 4, 0.f);
+        for (int i = 0; i < entries; ++i) {
+            const int bIndex = i % size;
+            const int gIndex = (i / size) % size;
+            const int rIndex = i / (size * size);
+            float *node = table.data() + ((bIndex * size + gIndex) * size + rIndex) * 4;
+            node[0] = static_cast<float>(nodes[i * 3]) * scale;
+            node[1] = static_cast<float>(nodes[i * 3 + 1]) * scale;
+            node[2] = static_cast<float>(nodes[i * 3 + 2]) * scale;
+        }
+
+        const float domainMin[3] = {0.f, 0.f, 0.f};
+        const float domainMax[3] = {1.f, 1.f, 1.f};
+        return std::make_shared<Lut3D>(size, std::move(table), domainMin, domainMax);
+    }
+
+    std::shared_ptr<Lut3D> Lut3D::parse(const uint8_t *data, size_t length) {
+        const std::string text(reinterpret_cast<const char *>(data), length);
+        if (text.find("LUT_3D_SIZE") != std::string::npos || text.find("LUT_1D_SIZE") != std::string::npos) {
+            return parseCube(text);
+        }
+        return parse3dl(text);
+    }
+
+    uint64_t lut3DHash(const uint8_t *data, size_t length) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash ^ static_cast<uint64_t>(length);
+    }
+
+    bool Lut3DCache::Entry::matches(const uint8_t *data, size_t length) const {
+        return source.size() == length && std::equal(source.begin(), source.end(), data);
+    }
+
+    std::shared_ptr<Lut3D> Lut3DCache::obtain(const uint8_t *data, size_t length,
+                                              const std::function<std::shared_ptr<Lut3D>()> &factory) {
+        const uint64_t key = lut3DHash(data, length);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(key);
+            if (found != index.end() && found->second->matches(data, length)) {
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->lut;
+            }
+        }
+
+        // Concurrent misses for the same key just build it twice
+        std::shared_ptr<Lut3D> lut = factory();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            if (found->second->matches(data, length)) {
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->lut;
+            }
+            // Hash collision, newer LUT replaces the older one
+            entries.erase(found->second);
+            index.erase(found);
+        }
+        entries.push_front({.key = key, .source = std::vector<uint8_t>(data, data + length), .lut = lut});
+        index[key] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+        return lut;
+    }
+
+    std::shared_ptr<Lut3D> obtainLut3D(const uint8_t *data, size_t length) {
+        static Lut3DCache cache(8);
+        return cache.obtain(data, length, [data, length]() {
+            return Lut3D::parse(data, length);
+        });
+    }
+}
+#endif
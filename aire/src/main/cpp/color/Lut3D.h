@@ -0,0 +1,97 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 22/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace aire {
+
+    class Lut3D {
+    public:
+        // Table is size^3 nodes of RGBA floats ( alpha is padding ), red index changes fastest
+        Lut3D(int size, std::vector<float> table, const float domainMin[3], const float domainMax[3]);
+
+        // Parses .cube ( LUT_3D_SIZE ) or .3dl ( shaper line and integer mesh ) text
+        static std::shared_ptr<Lut3D> parse(const uint8_t *data, size_t length);
+
+        // Premultiplied pixels are looked up by their straight color and premultiplied back in registers
+        void applyRGBA8888(uint8_t *data, int stride, int width, int height, bool premultiplied = false) const;
+
+        void applyRGBAF16(uint16_t *data, int stride, int width, int height, bool premultiplied = false) const;
+
+        int getSize() const {
+            return size;
+        }
+
+    private:
+        int size;
+        std::vector<float> table;
+        float domainMin[3];
+        float domainScale[3];
+    };
+
+    // FNV-1a over the bytes
+    uint64_t lut3DHash(const uint8_t *data, size_t length);
+
+    // LRU of LUTs keyed by 64 bit hash, source bytes are kept and compared on hit so colliding hashes
+    // never return other LUT. Factory runs outside of the lock on miss
+    class Lut3DCache {
+    public:
+        explicit Lut3DCache(size_t capacity) : capacity(capacity) {}
+
+        std::shared_ptr<Lut3D> obtain(const uint8_t *data, size_t length,
+                                      const std::function<std::shared_ptr<Lut3D>()> &factory);
+
+    private:
+        struct Entry {
+            uint64_t key;
+            std::vector<uint8_t> source;
+            std::shared_ptr<Lut3D> lut;
+
+            bool matches(const uint8_t *data, size_t length) const;
+        };
+
+        size_t capacity;
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    };
+
+    // Returns parsed LUT from cache keyed by content hash, least recently used LUTs are evicted
+    std::shared_ptr<Lut3D> obtainLut3D(const uint8_t *data, size_t length);
+}
@@ -0,0 +1,290 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 23/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "PointwiseBake.h"
+#include "PointwiseFusion.h"
+#include "Adjustments.h"
+#include "ConvolveToneMapper.h"
+#include "Gamut.h"
+#include "base/Grayscale.h"
+#include "base/LUT8.h"
+#include "base/Vibrance.h"
+#include "jni/JNIUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace aire {
+
+    static constexpr int bakeLatticeSize = 33;
+
+    int pointwiseParamsCount(PointwiseOpType type) {
+        switch (type) {
+            case POINTWISE_EXPOSURE:
+            case POINTWISE_SATURATION:
+            case POINTWISE_CONTRAST:
+            case POINTWISE_BRIGHTNESS:
+            case POINTWISE_GAMMA:
+            case POINTWISE_VIBRANCE:
+            case POINTWISE_LOGARITHMIC:
+            case POINTWISE_ACES_FILM:
+            case POINTWISE_HEJL_BURGESS:
+            case POINTWISE_HABLE_FILMIC:
+            case POINTWISE_ACES_HILL:
+            case POINTWISE_UCHIMURA:
+            case POINTWISE_THRESHOLD:
+                return 1;
+            case POINTWISE_WHITE_BALANCE:
+            case POINTWISE_ALDRIDGE:
+            case POINTWISE_DRAGO:
+                return 2;
+            case POINTWISE_GRAYSCALE:
+            case POINTWISE_MOBIUS:
+                return 3;
+            case POINTWISE_MONOCHROME:
+                return 5;
+            case POINTWISE_COLOR_MATRIX:
+                return 9;
+        }
+        throw AireError("Unknown pointwise operation " + std::to_string(static_cast<int>(type)));
+    }
+
+    bool isPointwiseCurve(PointwiseOpType type) {
+        return type == POINTWISE_GAMMA || type == POINTWISE_THRESHOLD;
+    }
+
+    void pointwiseCurveTable(const PointwiseOp &op, uint8_t table[256]) {
+        for (int i = 0; i < 256; ++i) {
+            if (op.type == POINTWISE_GAMMA) {
+                table[i] = std::clamp(std::pow(float(i), op.params[0]), 0.f, 255.f);
+            } else if (op.type == POINTWISE_THRESHOLD) {
+                table[i] = float(i) > op.params[0] ? 255 : 0;
+            } else {
+                table[i] = i;
+            }
+        }
+    }
+
+    bool isPointwisePremultipliedOp(PointwiseOpType type) {
+        return !isPointwiseCurve(type) && type != POINTWISE_COLOR_MATRIX && type != POINTWISE_GRAYSCALE;
+    }
+
+    void pointwiseOp(uint8_t *data, int stride, int width, int height, const PointwiseOp &op, bool premultiplied) {
+        const float *p = op.params;
+        switch (op.type) {
+            case POINTWISE_EXPOSURE:
+                aire::exposure(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_WHITE_BALANCE:
+                whiteBalance(data, stride, width, height, p[0], p[1], premultiplied);
+                break;
+            case POINTWISE_SATURATION:
+                saturation(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_CONTRAST:
+                adjustment(data, stride, width, height, p[0], 0.f, premultiplied);
+                break;
+            case POINTWISE_BRIGHTNESS:
+                adjustment(data, stride, width, height, 1.f, p[0], premultiplied);
+                break;
+            case POINTWISE_GAMMA:
+            case POINTWISE_THRESHOLD: {
+                uint8_t lookupTable[256];
+                pointwiseCurveTable(op, lookupTable);
+                const LUT8 lut(lookupTable);
+                lut.apply(data, stride, width, height);
+            }
+                break;
+            case POINTWISE_VIBRANCE:
+                vibrance(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_COLOR_MATRIX: {
+                Eigen::Matrix3f matrix;
+                for (int i = 0; i < 3; ++i) {
+                    for (int j = 0; j < 3; ++j) {
+                        matrix(i, j) = p[i * 3 + j];
+                    }
+                }
+                colorMatrix(data, stride, width, height, matrix);
+            }
+                break;
+            case POINTWISE_GRAYSCALE:
+                grayscale(data, data, stride, width, height, p[0], p[1], p[2]);
+                break;
+            case POINTWISE_LOGARITHMIC:
+                logarithmic(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_ACES_FILM:
+                acesFilm(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_HEJL_BURGESS:
+                hejlBurgess(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_HABLE_FILMIC:
+                hableFilmic(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_ACES_HILL:
+                acesHill(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_MONOCHROME: {
+                float color[4] = {p[0], p[1], p[2], p[3]};
+                monochrome(data, stride, width, height, color, p[4], premultiplied);
+            }
+                break;
+            case POINTWISE_MOBIUS:
+                mobius(data, stride, width, height, p[0], p[1], p[2], premultiplied);
+                break;
+            case POINTWISE_UCHIMURA:
+                uchimura(data, stride, width, height, p[0], premultiplied);
+                break;
+            case POINTWISE_ALDRIDGE:
+                aldridge(data, stride, width, height, p[0], p[1], premultiplied);
+                break;
+            case POINTWISE_DRAGO:
+                drago(data, stride, width, height, p[0], p[1], premultiplied);
+                break;
+        }
+    }
+
+    /**
+     * Lattice is laid out as an RGBA image ( width = size * size, height = size ) so every kernel
+     * runs on it unchanged and node (r, g, b) lands at the same index as in the LUT table.
+     * Nodes are rounded to u8 the same way as real pixels are, so baked values at nodes match the passes exactly
+     */
+    static std::shared_ptr<Lut3D> evaluatePointwiseLattice(const std::vector<PointwiseOp> &ops) {
+        const int size = bakeLatticeSize;
+        const int width = size * size;
+        const int height = size;
+        const int stride = width * 4;
+        std::vector<uint8_t> lattice(stride * height);
+        for (int b = 0; b < size; ++b) {
+            uint8_t *row = lattice.data() + b * stride;
+            for (int g = 0; g < size; ++g) {
+                for (int r = 0; r < size; ++r) {
+                    uint8_t *node = row + (g * size + r) * 4;
+                    node[0] = static_cast<uint8_t>(std::lround(r * 255.f / (size - 1)));
+                    node[1] = static_cast<uint8_t>(std::lround(g * 255.f / (size - 1)));
+                    node[2] = static_cast<uint8_t>(std::lround(b * 255.f / (size - 1)));
+                    node[3] = 255;
+                }
+            }
+        }
+
+        for (const auto &op: ops) {
+            pointwiseOp(lattice.data(), stride, width, height, op);
+        }
+
+        std::vector<float> table(size * size * size * 4);
+        for (int i = 0; i < size * size * size; ++i) {
+            table[i * 4] = lattice[i * 4] / 255.f;
+            table[i * 4 + 1] = lattice[i * 4 + 1] / 255.f;
+            table[i * 4 + 2] = lattice[i * 4 + 2] / 255.f;
+            table[i * 4 + 3] = 1.f;
+        }
+
+        const float domainMin[3] = {0.f, 0.f, 0.f};
+        const float domainMax[3] = {1.f, 1.f, 1.f};
+        return std::make_shared<Lut3D>(size, std::move(table), domainMin, domainMax);
+    }
+
+    std::shared_ptr<Lut3D> bakePointwiseChain(const std::vector<PointwiseOp> &ops) {
+        std::vector<uint8_t> key;
+        key.reserve(ops.size() * (sizeof(int32_t) + sizeof(float) * pointwiseMaxParams));
+        for (const auto &op: ops) {
+            const int32_t type = op.type;
+            const int count = pointwiseParamsCount(op.type);
+            const auto typeBytes = reinterpret_cast<const uint8_t *>(&type);
+            const auto paramsBytes = reinterpret_cast<const uint8_t *>(op.params);
+            key.insert(key.end(), typeBytes, typeBytes + sizeof(int32_t));
+            key.insert(key.end(), paramsBytes, paramsBytes + sizeof(float) * count);
+        }
+
+        static Lut3DCache cache(16);
+        return cache.obtain(key.data(), key.size(), [&ops]() {
+            return evaluatePointwiseLattice(ops);
+        });
+    }
+
+    void pointwiseChain(uint8_t *data, int stride, int width, int height, const std::vector<PointwiseOp> &ops,
+                        bool premultiplied) {
+        if (ops.empty()) {
+            return;
+        }
+        const bool hasCurves = std::any_of(ops.begin(), ops.end(), [](const PointwiseOp &op) {
+            return isPointwiseCurve(op.type);
+        });
+        const bool onlyCurves = std::all_of(ops.begin(), ops.end(), [](const PointwiseOp &op) {
+            return isPointwiseCurve(op.type);
+        });
+        // Straight alpha curves compose into a plain LUT8 which keeps its table in registers
+        if (onlyCurves && !premultiplied) {
+            uint8_t table[256];
+            for (int i = 0; i < 256; ++i) {
+                table[i] = i;
+            }
+            for (const auto &op: ops) {
+                uint8_t curve[256];
+                pointwiseCurveTable(op, curve);
+                for (int i = 0; i < 256; ++i) {
+                    table[i] = curve[table[i]];
+                }
+            }
+            const LUT8 lut(table);
+            lut.apply(data, stride, width, height);
+            return;
+        }
+        FusedPointwise program;
+        if (compilePointwiseFusion(ops, program)) {
+            fusedPointwise(data, stride, width, height, program, premultiplied);
+            return;
+        }
+        // Curves are not smooth enough for lattice interpolation: threshold is a step and gamma is steep
+        // in shadows. Chain is split into runs of curves applied exactly and runs of other ops that are baked
+        if (hasCurves) {
+            size_t start = 0;
+            while (start < ops.size()) {
+                const bool curves = isPointwiseCurve(ops[start].type);
+                size_t end = start + 1;
+                while (end < ops.size() && isPointwiseCurve(ops[end].type) == curves) {
+                    ++end;
+                }
+                const std::vector<PointwiseOp> run(ops.begin() + static_cast<long>(start),
+                                                   ops.begin() + static_cast<long>(end));
+                pointwiseChain(data, stride, width, height, run, premultiplied);
+                start = end;
+            }
+            return;
+        }
+        if (ops.size() == 1 && (!premultiplied || isPointwisePremultipliedOp(ops[0].type))) {
+            pointwiseOp(data, stride, width, height, ops[0], premultiplied);
+            return;
+        }
+        bakePointwiseChain(ops)->applyRGBA8888(data, stride, width, height, premultiplied);
+    }
+}
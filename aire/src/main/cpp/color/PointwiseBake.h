@@ -0,0 +1,97 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 23/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Lut3D.h"
+
+namespace aire {
+
+    enum PointwiseOpType {
+        POINTWISE_EXPOSURE = 0,
+        POINTWISE_WHITE_BALANCE = 1,
+        POINTWISE_SATURATION = 2,
+        POINTWISE_CONTRAST = 3,
+        POINTWISE_BRIGHTNESS = 4,
+        POINTWISE_GAMMA = 5,
+        POINTWISE_VIBRANCE = 6,
+        POINTWISE_COLOR_MATRIX = 7,
+        POINTWISE_GRAYSCALE = 8,
+        POINTWISE_LOGARITHMIC = 9,
+        POINTWISE_ACES_FILM = 10,
+        POINTWISE_HEJL_BURGESS = 11,
+        POINTWISE_HABLE_FILMIC = 12,
+        POINTWISE_ACES_HILL = 13,
+        POINTWISE_MONOCHROME = 14,
+        POINTWISE_MOBIUS = 15,
+        POINTWISE_UCHIMURA = 16,
+        POINTWISE_ALDRIDGE = 17,
+        POINTWISE_DRAGO = 18,
+        POINTWISE_THRESHOLD = 19
+    };
+
+    static constexpr int pointwiseMaxParams = 9;
+
+    // Params are in the same order as arguments of the corresponding kernel,
+    // color matrix is row major 3x3, monochrome is color[4] followed by exposure
+    struct PointwiseOp {
+        PointwiseOpType type;
+        float params[pointwiseMaxParams];
+    };
+
+    int pointwiseParamsCount(PointwiseOpType type);
+
+    // Gamma and threshold are 1D u8 curves applied to R, G and B alike
+    bool isPointwiseCurve(PointwiseOpType type);
+
+    void pointwiseCurveTable(const PointwiseOp &op, uint8_t table[256]);
+
+    // Color matrix, grayscale and curves have no premultiplied kernels, other ops unpremultiply in registers
+    bool isPointwisePremultipliedOp(PointwiseOpType type);
+
+    // Runs a single op with it's own kernel
+    void pointwiseOp(uint8_t *data, int stride, int width, int height, const PointwiseOp &op,
+                     bool premultiplied = false);
+
+    // Evaluates the chain on 33^3 lattice, result is cached per ops and params.
+    // Ops should be smooth, 1D curves lose their shape between lattice nodes
+    std::shared_ptr<Lut3D> bakePointwiseChain(const std::vector<PointwiseOp> &ops);
+
+    // Affine ops and curves are fused into one fixed point pass, otherwise single op runs directly
+    // and longer chains are baked into 3D LUT and applied in one pass. Curves are never baked,
+    // they run as exact passes between baked runs of the other ops.
+    // Premultiplied pixels are unpremultiplied and premultiplied back in registers of the fused pass,
+    // the single op kernel or the baked pass
+    void pointwiseChain(uint8_t *data, int stride, int width, int height, const std::vector<PointwiseOp> &ops,
+                        bool premultiplied = false);
+}
@@ -0,0 +1,313 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 24/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "color/PointwiseFusion.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "PointwiseFusion.h"
+#include "color/eotf-inl.h"
+#include "conversion/attenuate-inl.h"
+#include "concurrency.hpp"
+#include "Eigen/Eigen"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE V FusedPointwiseRow(const D di16, const V r, const V g, const V b,
+                                   const V c0, const V c1, const V c2, const V bias) {
+        // Scalar kernels truncate to u8, one Q4 unit offsets flooring of MulHigh
+        const auto rounding = Set(di16, 1);
+        V acc = SaturatedAdd(bias, MulHigh(r, c0));
+        acc = SaturatedAdd(acc, MulHigh(g, c1));
+        acc = SaturatedAdd(acc, MulHigh(b, c2));
+        return ShiftRight<4>(Add(acc, rounding));
+    }
+
+    template<class D>
+    HWY_INLINE void
+    FusedPointwisePixels(const D di16, const FusedPointwise &program, const Vec<D> *coefficients,
+                         const int16_t *planes, const int planeStride, const bool premultiplied,
+                         const uint8_t *src, uint8_t *dst) {
+        const RebindToUnsigned<decltype(di16)> du16;
+        const Rebind<uint8_t, decltype(di16)> du8;
+        Vec<decltype(du8)> ru, gu, bu, au;
+        LoadInterleaved4(du8, src, ru, gu, bu, au);
+        // Opaque vectors are the same in both spaces
+        const bool attenuated = premultiplied && !AllTrue(du8, Eq(au, Set(du8, 255)));
+        const auto a = BitCast(di16, PromoteTo(du16, au));
+        Vec<D> r, g, b;
+        if (program.hasInputCurve) {
+            r = LoadU(di16, planes);
+            g = LoadU(di16, planes + planeStride);
+            b = LoadU(di16, planes + planeStride * 2);
+        } else {
+            r = BitCast(di16, PromoteTo(du16, ru));
+            g = BitCast(di16, PromoteTo(du16, gu));
+            b = BitCast(di16, PromoteTo(du16, bu));
+            if (attenuated) {
+                r = UnattenuateVec16(di16, r, a);
+                g = UnattenuateVec16(di16, g, a);
+                b = UnattenuateVec16(di16, b, a);
+            }
+            r = ShiftLeft<7>(r);
+            g = ShiftLeft<7>(g);
+            b = ShiftLeft<7>(b);
+        }
+
+        auto nr = FusedPointwiseRow(di16, r, g, b, coefficients[0], coefficients[1], coefficients[2],
+                                    coefficients[9]);
+        auto ng = FusedPointwiseRow(di16, r, g, b, coefficients[3], coefficients[4], coefficients[5],
+                                    coefficients[10]);
+        auto nb = FusedPointwiseRow(di16, r, g, b, coefficients[6], coefficients[7], coefficients[8],
+                                    coefficients[11]);
+
+        // With output curve pixels are premultiplied back after the curve
+        if (attenuated && !program.hasOutputCurve) {
+            const auto zeros = Zero(di16);
+            const auto vMax = Set(di16, 255);
+            nr = AttenuateVec16(di16, Clamp(nr, zeros, vMax), a);
+            ng = AttenuateVec16(di16, Clamp(ng, zeros, vMax), a);
+            nb = AttenuateVec16(di16, Clamp(nb, zeros, vMax), a);
+        }
+
+        StoreInterleaved4(DemoteTo(du8, nr), DemoteTo(du8, ng), DemoteTo(du8, nb), au, du8, dst);
+    }
+
+    void FusedPointwiseRGBA(uint8_t *data, const int stride, const int width, const int height,
+                            const FusedPointwise &program, const bool premultiplied) {
+        const ScalableTag<int16_t> di16;
+        const int lanes = static_cast<int>(Lanes(di16));
+
+        Vec<decltype(di16)> coefficients[12];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                coefficients[i * 3 + j] = Set(di16, program.coefficients[i][j]);
+            }
+            coefficients[9 + i] = Set(di16, program.bias[i]);
+        }
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        const int planeStride = (width + lanes - 1) / lanes * lanes;
+
+        concurrency::parallel_for_segment(threadCount, height, [&](int start, int end) {
+            // Curve planes are reused by all rows of the segment
+            std::vector<int16_t> planes(program.hasInputCurve ? planeStride * 3 : 0);
+            HWY_ALIGN uint8_t tail[HWY_MAX_LANES_D(decltype(di16)) * 4] = {};
+
+            for (int y = start; y < end; ++y) {
+                uint8_t *row = data + y * stride;
+
+                if (program.hasInputCurve) {
+                    for (int x = 0; x < width; ++x) {
+                        const uint8_t *px = row + x * 4;
+                        if (premultiplied && px[3] != 255) {
+                            planes[x] = program.inputCurve[0][Unattenuate(px[0], px[3])];
+                            planes[planeStride + x] = program.inputCurve[1][Unattenuate(px[1], px[3])];
+                            planes[planeStride * 2 + x] = program.inputCurve[2][Unattenuate(px[2], px[3])];
+                        } else {
+                            planes[x] = program.inputCurve[0][px[0]];
+                            planes[planeStride + x] = program.inputCurve[1][px[1]];
+                            planes[planeStride * 2 + x] = program.inputCurve[2][px[2]];
+                        }
+                    }
+                }
+
+                int x = 0;
+                for (; x + lanes <= width; x += lanes) {
+                    FusedPointwisePixels(di16, program, coefficients, planes.data() + x, planeStride,
+                                         premultiplied, row + x * 4, row + x * 4);
+                }
+
+                if (x < width) {
+                    const int remaining = width - x;
+                    std::copy(row + x * 4, row + width * 4, tail);
+                    FusedPointwisePixels(di16, program, coefficients, planes.data() + x, planeStride,
+                                         premultiplied, tail, tail);
+                    std::copy(tail, tail + remaining * 4, row + x * 4);
+                }
+
+                if (program.hasOutputCurve) {
+                    for (x = 0; x < width; ++x) {
+                        uint8_t *px = row + x * 4;
+                        px[0] = program.outputCurve[0][px[0]];
+                        px[1] = program.outputCurve[1][px[1]];
+                        px[2] = program.outputCurve[2][px[2]];
+                        if (premultiplied && px[3] != 255) {
+                            px[0] = Attenuate(px[0], px[3]);
+                            px[1] = Attenuate(px[1], px[3]);
+                            px[2] = Attenuate(px[2], px[3]);
+                        }
+                    }
+                }
+            }
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(FusedPointwiseRGBA);
+
+    static bool isPointwiseAffine(PointwiseOpType type) {
+        return type == POINTWISE_CONTRAST || type == POINTWISE_BRIGHTNESS || type == POINTWISE_SATURATION ||
+               type == POINTWISE_COLOR_MATRIX || type == POINTWISE_GRAYSCALE;
+    }
+
+    /**
+     * Ops are folded in three phases: curves before any matrix, matrices, curves after matrices.
+     * Grayscale works on linearized values, so it may only start the matrix phase.
+     * Intermediate results between folded matrices are not clamped to u8
+     */
+    bool compilePointwiseFusion(const std::vector<PointwiseOp> &ops, FusedPointwise &program) {
+        uint8_t inputCurve[256], outputCurve[256];
+        for (int i = 0; i < 256; ++i) {
+            inputCurve[i] = i;
+            outputCurve[i] = i;
+        }
+        bool hasInputCurve = false, hasOutputCurve = false, linearize = false;
+        Eigen::Matrix3f matrix = Eigen::Matrix3f::Identity();
+        Eigen::Vector3f bias = Eigen::Vector3f::Zero();
+        int phase = 0;
+
+        for (const auto &op: ops) {
+            const float *p = op.params;
+            if (isPointwiseCurve(op.type)) {
+                uint8_t table[256];
+                pointwiseCurveTable(op, table);
+                if (phase == 0) {
+                    for (int i = 0; i < 256; ++i) {
+                        inputCurve[i] = table[inputCurve[i]];
+                    }
+                    hasInputCurve = true;
+                } else {
+                    for (int i = 0; i < 256; ++i) {
+                        outputCurve[i] = table[outputCurve[i]];
+                    }
+                    hasOutputCurve = true;
+                    phase = 2;
+                }
+                continue;
+            }
+
+            if (!isPointwiseAffine(op.type) || phase == 2) {
+                return false;
+            }
+
+            Eigen::Matrix3f stepMatrix = Eigen::Matrix3f::Identity();
+            Eigen::Vector3f stepBias = Eigen::Vector3f::Zero();
+            switch (op.type) {
+                case POINTWISE_CONTRAST:
+                    stepMatrix *= p[0];
+                    stepBias.setConstant(127.5f * (1.f - p[0]));
+                    break;
+                case POINTWISE_BRIGHTNESS:
+                    stepBias.setConstant(p[0] * 255.f);
+                    break;
+                case POINTWISE_SATURATION: {
+                    const Eigen::RowVector3f luma = {0.299f, 0.587f, 0.114f};
+                    stepMatrix = p[0] * Eigen::Matrix3f::Identity() +
+                                 (1.f - p[0]) * Eigen::Vector3f::Ones() * luma;
+                }
+                    break;
+                case POINTWISE_COLOR_MATRIX:
+                    stepMatrix << p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8];
+                    break;
+                case POINTWISE_GRAYSCALE:
+                    if (phase != 0) {
+                        return false;
+                    }
+                    linearize = true;
+                    stepMatrix = Eigen::Vector3f::Ones() * Eigen::RowVector3f(p[0], p[1], p[2]);
+                    break;
+                default:
+                    return false;
+            }
+            matrix = stepMatrix * matrix;
+            bias = stepMatrix * bias + stepBias;
+            phase = 1;
+        }
+
+        // Every partial sum must stay inside i16 so saturating adds never trigger
+        for (int i = 0; i < 3; ++i) {
+            float extent = std::abs(bias[i]) * 16.f + 1.f;
+            for (int j = 0; j < 3; ++j) {
+                if (std::abs(matrix(i, j)) >= 3.99f) {
+                    return false;
+                }
+                extent += std::abs(matrix(i, j)) * 255.f * 16.f;
+            }
+            if (extent > 32767.f) {
+                return false;
+            }
+        }
+
+        program.hasInputCurve = hasInputCurve || linearize;
+        for (int i = 0; i < 256; ++i) {
+            float value = inputCurve[i];
+            if (linearize) {
+                value = aire::HWY_NAMESPACE::SRGBToLinear(value / 255.f) * 255.f;
+            }
+            const auto fixed = static_cast<int16_t>(std::lround(value * 128.f));
+            program.inputCurve[0][i] = fixed;
+            program.inputCurve[1][i] = fixed;
+            program.inputCurve[2][i] = fixed;
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                program.coefficients[i][j] = static_cast<int16_t>(std::lround(matrix(i, j) * 8192.f));
+            }
+            program.bias[i] = static_cast<int16_t>(std::lround(bias[i] * 16.f));
+        }
+        program.hasOutputCurve = hasOutputCurve;
+        for (int c = 0; c < 3; ++c) {
+            std::copy(outputCurve, outputCurve + 256, program.outputCurve[c]);
+        }
+        return true;
+    }
+
+    void fusedPointwise(uint8_t *data, int stride, int width, int height, const FusedPointwise &program,
+                        bool premultiplied) {
+        HWY_DYNAMIC_DISPATCH(FusedPointwiseRGBA)(data, stride, width, height, program, premultiplied);
+    }
+}
+#endif
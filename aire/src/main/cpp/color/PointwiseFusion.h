@@ -0,0 +1,59 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 24/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "PointwiseBake.h"
+
+namespace aire {
+
+    /**
+     * Consecutive affine ops ( contrast, brightness, saturation, color matrix, grayscale ) folded into
+     * one 3x4 matrix, with 1D curves before it folded into input tables and curves after it into output tables.
+     * Matrix is Q13, bias is Q4 and input tables are Q7 in u8 units
+     */
+    struct FusedPointwise {
+        bool hasInputCurve;
+        int16_t inputCurve[3][256];
+        int16_t coefficients[3][3];
+        int16_t bias[3];
+        bool hasOutputCurve;
+        uint8_t outputCurve[3][256];
+    };
+
+    // Returns false if chain contains non fusable ops or folded matrix doesn't fit fixed point range
+    bool compilePointwiseFusion(const std::vector<PointwiseOp> &ops, FusedPointwise &program);
+
+    // Premultiplied pixels are unpremultiplied in registers for the ops and premultiplied back before store
+    void fusedPointwise(uint8_t *data, int stride, int width, int height, const FusedPointwise &program,
+                        bool premultiplied = false);
+}
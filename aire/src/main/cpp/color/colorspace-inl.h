@@ -0,0 +1,436 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 25/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#if defined(HIGHWAY_HWY_COLORSPACE_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef HIGHWAY_HWY_COLORSPACE_INL_H_
+#undef HIGHWAY_HWY_COLORSPACE_INL_H_
+#else
+#define HIGHWAY_HWY_COLORSPACE_INL_H_
+#endif
+
+#include "hwy/highway.h"
+#include "algo/math-inl.h"
+#include "algo/fast_math-inl.h"
+#include "eotf-inl.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    // All converters take gamma encoded sRGB in [0, 1] and work in place, hue is in degrees [0, 360).
+    // Cube root goes through CubeRootAndAdd, so vectors have to be full ones
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void
+    ColorspaceMatrix(const D df, V &c0, V &c1, V &c2, const float m[9]) {
+        const auto x = c0;
+        const auto y = c1;
+        const auto z = c2;
+        c0 = MulAdd(Set(df, m[0]), x, MulAdd(Set(df, m[1]), y, Mul(Set(df, m[2]), z)));
+        c1 = MulAdd(Set(df, m[3]), x, MulAdd(Set(df, m[4]), y, Mul(Set(df, m[5]), z)));
+        c2 = MulAdd(Set(df, m[6]), x, MulAdd(Set(df, m[7]), y, Mul(Set(df, m[8]), z)));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V ColorspaceCbrt(const D df, V v) {
+        return CubeRootAndAdd(Max(v, Zero(df)), Zero(df));
+    }
+
+    // Floored modulo for positive divisor
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V ColorspaceMod(const D df, V v, const float divisor) {
+        const auto vDivisor = Set(df, divisor);
+        return NegMulAdd(Floor(Div(v, vDivisor)), vDivisor, v);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToLinearRGB(const D df, V &r, V &g, V &b) {
+        r = SRGBToLinear(df, r);
+        g = SRGBToLinear(df, g);
+        b = SRGBToLinear(df, b);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void LinearRGBToSRGB(const D df, V &r, V &g, V &b) {
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        r = LinearSRGBTosRGB(df, Clamp(r, zeros, ones));
+        g = LinearSRGBTosRGB(df, Clamp(g, zeros, ones));
+        b = LinearSRGBTosRGB(df, Clamp(b, zeros, ones));
+    }
+
+    static const float colorspaceRGBToXYZ[9] = {
+            0.4124564f, 0.3575761f, 0.1804375f,
+            0.2126729f, 0.7151522f, 0.0721750f,
+            0.0193339f, 0.1191920f, 0.9503041f
+    };
+
+    static const float colorspaceXYZToRGB[9] = {
+            3.2404542f, -1.5371385f, -0.4985314f,
+            -0.9692660f, 1.8760108f, 0.0415560f,
+            0.0556434f, -0.2040259f, 1.0572252f
+    };
+
+    static const float colorspaceWhiteX = 0.95047f;
+    static const float colorspaceWhiteZ = 1.08883f;
+    static const float colorspaceLabEpsilon = 0.008856f;
+    static const float colorspaceLabKappa = 903.3f;
+
+    // Oklab, L in [0, 1]
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToOklab(const D df, V &r, V &g, V &b) {
+        static const float rgbToLms[9] = {
+                0.4122214708f, 0.5363325363f, 0.0514459929f,
+                0.2119034982f, 0.6806995451f, 0.1073969566f,
+                0.0883024619f, 0.2817188376f, 0.6299787005f
+        };
+        static const float lmsToLab[9] = {
+                0.2104542553f, 0.7936177850f, -0.0040720468f,
+                1.9779984951f, -2.4285922050f, 0.4505937099f,
+                0.0259040371f, 0.7827717662f, -0.8086757660f
+        };
+        SRGBToLinearRGB(df, r, g, b);
+        ColorspaceMatrix(df, r, g, b, rgbToLms);
+        r = ColorspaceCbrt(df, r);
+        g = ColorspaceCbrt(df, g);
+        b = ColorspaceCbrt(df, b);
+        ColorspaceMatrix(df, r, g, b, lmsToLab);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void OklabToSRGB(const D df, V &l, V &a, V &b) {
+        static const float labToLms[9] = {
+                1.f, 0.3963377774f, 0.2158037573f,
+                1.f, -0.1055613458f, -0.0638541728f,
+                1.f, -0.0894841775f, -1.2914855480f
+        };
+        static const float lmsToRgb[9] = {
+                4.0767416621f, -3.3077115913f, 0.2309699292f,
+                -1.2684380046f, 2.6097574011f, -0.3413193965f,
+                -0.0041960863f, -0.7034186147f, 1.7076147010f
+        };
+        ColorspaceMatrix(df, l, a, b, labToLms);
+        l = Mul(Mul(l, l), l);
+        a = Mul(Mul(a, a), a);
+        b = Mul(Mul(b, b), b);
+        ColorspaceMatrix(df, l, a, b, lmsToRgb);
+        LinearRGBToSRGB(df, l, a, b);
+    }
+
+    // Polar form of opponent axes: a, b -> chroma, hue
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void ColorspaceToPolar(const D df, V &a, V &b) {
+        const auto chroma = Sqrt(MulAdd(a, a, Mul(b, b)));
+        auto hue = Mul(hwy::HWY_NAMESPACE::Atan2(df, b, a), Set(df, 180.f / static_cast<float>(M_PI)));
+        hue = IfThenElse(Lt(hue, Zero(df)), Add(hue, Set(df, 360.f)), hue);
+        a = chroma;
+        b = hue;
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void ColorspaceFromPolar(const D df, V &c, V &h) {
+        V sine, cosine;
+        hwy::HWY_NAMESPACE::SinCos(df, Mul(h, Set(df, static_cast<float>(M_PI) / 180.f)), sine, cosine);
+        const auto chroma = c;
+        c = Mul(chroma, cosine);
+        h = Mul(chroma, sine);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToOklch(const D df, V &r, V &g, V &b) {
+        SRGBToOklab(df, r, g, b);
+        ColorspaceToPolar(df, g, b);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void OklchToSRGB(const D df, V &l, V &c, V &h) {
+        ColorspaceFromPolar(df, c, h);
+        OklabToSRGB(df, l, c, h);
+    }
+
+    // CIE L*a*b* D65, L in [0, 100]
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V LabF(const D df, V t) {
+        const auto linear = MulAdd(t, Set(df, colorspaceLabKappa / 116.f), Set(df, 16.f / 116.f));
+        return IfThenElse(Gt(t, Set(df, colorspaceLabEpsilon)), ColorspaceCbrt(df, t), linear);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V LabInverseF(const D df, V f) {
+        const auto cube = Mul(Mul(f, f), f);
+        const auto linear = Div(MulSub(f, Set(df, 116.f), Set(df, 16.f)), Set(df, colorspaceLabKappa));
+        return IfThenElse(Gt(cube, Set(df, colorspaceLabEpsilon)), cube, linear);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToLab(const D df, V &r, V &g, V &b) {
+        SRGBToLinearRGB(df, r, g, b);
+        ColorspaceMatrix(df, r, g, b, colorspaceRGBToXYZ);
+        const auto fx = LabF(df, Mul(r, Set(df, 1.f / colorspaceWhiteX)));
+        const auto fy = LabF(df, g);
+        const auto fz = LabF(df, Mul(b, Set(df, 1.f / colorspaceWhiteZ)));
+        r = MulSub(fy, Set(df, 116.f), Set(df, 16.f));
+        g = Mul(Sub(fx, fy), Set(df, 500.f));
+        b = Mul(Sub(fy, fz), Set(df, 200.f));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void LabToSRGB(const D df, V &l, V &a, V &b) {
+        const auto fy = Mul(Add(l, Set(df, 16.f)), Set(df, 1.f / 116.f));
+        const auto fx = MulAdd(a, Set(df, 1.f / 500.f), fy);
+        const auto fz = NegMulAdd(b, Set(df, 1.f / 200.f), fy);
+        const auto y = IfThenElse(Gt(l, Set(df, colorspaceLabKappa * colorspaceLabEpsilon)),
+                                  Mul(Mul(fy, fy), fy), Div(l, Set(df, colorspaceLabKappa)));
+        l = Mul(LabInverseF(df, fx), Set(df, colorspaceWhiteX));
+        a = y;
+        b = Mul(LabInverseF(df, fz), Set(df, colorspaceWhiteZ));
+        ColorspaceMatrix(df, l, a, b, colorspaceXYZToRGB);
+        LinearRGBToSRGB(df, l, a, b);
+    }
+
+    // CIE L*u*v* D65, L in [0, 100]
+
+    static const float colorspaceWhiteU = 0.1978398f;
+    static const float colorspaceWhiteV = 0.4683363f;
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToLuv(const D df, V &r, V &g, V &b) {
+        SRGBToLinearRGB(df, r, g, b);
+        ColorspaceMatrix(df, r, g, b, colorspaceRGBToXYZ);
+        const auto zeros = Zero(df);
+        const auto denominator = MulAdd(Set(df, 15.f), g, MulAdd(Set(df, 3.f), b, r));
+        const auto black = Le(denominator, zeros);
+        const auto scale = Div(Set(df, 1.f), IfThenElse(black, Set(df, 1.f), denominator));
+        const auto uPrime = Mul(Mul(Set(df, 4.f), r), scale);
+        const auto vPrime = Mul(Mul(Set(df, 9.f), g), scale);
+        const auto l = MulSub(LabF(df, g), Set(df, 116.f), Set(df, 16.f));
+        const auto l13 = Mul(l, Set(df, 13.f));
+        r = l;
+        g = IfThenZeroElse(black, Mul(l13, Sub(uPrime, Set(df, colorspaceWhiteU))));
+        b = IfThenZeroElse(black, Mul(l13, Sub(vPrime, Set(df, colorspaceWhiteV))));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void LuvToSRGB(const D df, V &l, V &u, V &v) {
+        const auto zeros = Zero(df);
+        const auto black = Le(l, zeros);
+        const auto l13 = Div(Set(df, 1.f), Mul(IfThenElse(black, Set(df, 1.f), l), Set(df, 13.f)));
+        const auto uPrime = MulAdd(u, l13, Set(df, colorspaceWhiteU));
+        auto vPrime = MulAdd(v, l13, Set(df, colorspaceWhiteV));
+        vPrime = IfThenElse(Le(vPrime, zeros), Set(df, 1e-6f), vPrime);
+        const auto fy = Mul(Add(l, Set(df, 16.f)), Set(df, 1.f / 116.f));
+        const auto y = IfThenZeroElse(black, IfThenElse(Gt(l, Set(df, colorspaceLabKappa * colorspaceLabEpsilon)),
+                                                        Mul(Mul(fy, fy), fy), Div(l, Set(df, colorspaceLabKappa))));
+        const auto yScale = Div(y, Mul(Set(df, 4.f), vPrime));
+        l = Mul(Mul(Set(df, 9.f), uPrime), yScale);
+        u = y;
+        v = Mul(NegMulAdd(Set(df, 20.f), vPrime, NegMulAdd(Set(df, 3.f), uPrime, Set(df, 12.f))), yScale);
+        ColorspaceMatrix(df, l, u, v, colorspaceXYZToRGB);
+        LinearRGBToSRGB(df, l, u, v);
+    }
+
+    // HSV and HSL works directly on gamma encoded values, saturation and value/lightness in [0, 1]
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V ColorspaceHue(const D df, V r, V g, V b, V max, V delta) {
+        const auto zeros = Zero(df);
+        const auto grey = Eq(delta, zeros);
+        const auto scale = Div(Set(df, 60.f), IfThenElse(grey, Set(df, 1.f), delta));
+        auto hue = IfThenElse(Eq(max, r), Sub(g, b),
+                              IfThenElse(Eq(max, g), MulAdd(Set(df, 2.f), delta, Sub(b, r)),
+                                         MulAdd(Set(df, 4.f), delta, Sub(r, g))));
+        hue = Mul(hue, scale);
+        hue = IfThenElse(Lt(hue, zeros), Add(hue, Set(df, 360.f)), hue);
+        return IfThenZeroElse(grey, hue);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToHSV(const D df, V &r, V &g, V &b) {
+        const auto max = Max(r, Max(g, b));
+        const auto delta = Sub(max, Min(r, Min(g, b)));
+        const auto hue = ColorspaceHue(df, r, g, b, max, delta);
+        const auto isZero = Eq(max, Zero(df));
+        r = hue;
+        g = IfThenZeroElse(isZero, Div(delta, IfThenElse(isZero, Set(df, 1.f), max)));
+        b = max;
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V HSVChannel(const D df, V h, V chroma, V value, const float n) {
+        const auto k = ColorspaceMod(df, MulAdd(h, Set(df, 1.f / 60.f), Set(df, n)), 6.f);
+        const auto t = Clamp(Min(k, Sub(Set(df, 4.f), k)), Zero(df), Set(df, 1.f));
+        return NegMulAdd(chroma, t, value);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void HSVToSRGB(const D df, V &h, V &s, V &v) {
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        const auto value = Clamp(v, zeros, ones);
+        const auto chroma = Mul(value, Clamp(s, zeros, ones));
+        const auto hue = h;
+        h = HSVChannel(df, hue, chroma, value, 5.f);
+        s = HSVChannel(df, hue, chroma, value, 3.f);
+        v = HSVChannel(df, hue, chroma, value, 1.f);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToHSL(const D df, V &r, V &g, V &b) {
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        const auto max = Max(r, Max(g, b));
+        const auto min = Min(r, Min(g, b));
+        const auto delta = Sub(max, min);
+        const auto hue = ColorspaceHue(df, r, g, b, max, delta);
+        const auto lightness = Mul(Add(max, min), Set(df, 0.5f));
+        auto denominator = Sub(ones, Abs(MulSub(Set(df, 2.f), lightness, ones)));
+        const auto grey = Le(denominator, zeros);
+        denominator = IfThenElse(grey, ones, denominator);
+        r = hue;
+        g = IfThenZeroElse(grey, Min(Div(delta, denominator), ones));
+        b = lightness;
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V HSLChannel(const D df, V h, V a, V lightness, const float n) {
+        const auto k = ColorspaceMod(df, MulAdd(h, Set(df, 1.f / 30.f), Set(df, n)), 12.f);
+        const auto t = Clamp(Min(Sub(k, Set(df, 3.f)), Sub(Set(df, 9.f), k)), Set(df, -1.f), Set(df, 1.f));
+        return NegMulAdd(a, t, lightness);
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void HSLToSRGB(const D df, V &h, V &s, V &l) {
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        const auto lightness = Clamp(l, zeros, ones);
+        const auto a = Mul(Clamp(s, zeros, ones), Min(lightness, Sub(ones, lightness)));
+        const auto hue = h;
+        h = HSLChannel(df, hue, a, lightness, 0.f);
+        s = HSLChannel(df, hue, a, lightness, 8.f);
+        l = HSLChannel(df, hue, a, lightness, 4.f);
+    }
+
+    // JzAzBz with SDR white mapped to jzazbzDisplayLuminance cd/m2
+
+    static const float jzazbzDisplayLuminance = 200.f;
+    static const float jzazbzB = 1.15f;
+    static const float jzazbzG = 0.66f;
+    static const float jzazbzC1 = 3424.f / 4096.f;
+    static const float jzazbzC2 = 2413.f / 128.f;
+    static const float jzazbzC3 = 2392.f / 128.f;
+    static const float jzazbzN = 2610.f / 16384.f;
+    static const float jzazbzP = 1.7f * 2523.f / 32.f;
+    static const float jzazbzD = -0.56f;
+    static const float jzazbzD0 = 1.6295499532821566e-11f;
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V JzazbzPerceptualQuantizer(const D df, V v) {
+        const auto vn = Pow(df, Max(Mul(v, Set(df, 1.f / 10000.f)), Set(df, 1e-12f)), Set(df, jzazbzN));
+        const auto numerator = MulAdd(Set(df, jzazbzC2), vn, Set(df, jzazbzC1));
+        const auto denominator = MulAdd(Set(df, jzazbzC3), vn, Set(df, 1.f));
+        return Pow(df, Div(numerator, denominator), Set(df, jzazbzP));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE V JzazbzInversePerceptualQuantizer(const D df, V v) {
+        const auto vp = Pow(df, Max(v, Set(df, 1e-12f)), Set(df, 1.f / jzazbzP));
+        const auto numerator = Sub(Set(df, jzazbzC1), vp);
+        const auto denominator = MulSub(Set(df, jzazbzC3), vp, Set(df, jzazbzC2));
+        const auto ratio = Max(Div(numerator, denominator), Set(df, 1e-12f));
+        return Mul(Pow(df, ratio, Set(df, 1.f / jzazbzN)), Set(df, 10000.f));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void SRGBToJzazbz(const D df, V &r, V &g, V &b) {
+        static const float xyzToLms[9] = {
+                0.41478972f, 0.579999f, 0.0146480f,
+                -0.2015100f, 1.120649f, 0.0531008f,
+                -0.0166008f, 0.264800f, 0.6684799f
+        };
+        static const float lmsToIab[9] = {
+                0.5f, 0.5f, 0.f,
+                3.524000f, -4.066708f, 0.542708f,
+                0.199076f, 1.096799f, -1.295875f
+        };
+        SRGBToLinearRGB(df, r, g, b);
+        ColorspaceMatrix(df, r, g, b, colorspaceRGBToXYZ);
+        const auto luminance = Set(df, jzazbzDisplayLuminance);
+        const auto x = Mul(r, luminance);
+        const auto y = Mul(g, luminance);
+        const auto z = Mul(b, luminance);
+        r = MulSub(Set(df, jzazbzB), x, Mul(Set(df, jzazbzB - 1.f), z));
+        g = MulSub(Set(df, jzazbzG), y, Mul(Set(df, jzazbzG - 1.f), x));
+        b = z;
+        ColorspaceMatrix(df, r, g, b, xyzToLms);
+        r = JzazbzPerceptualQuantizer(df, r);
+        g = JzazbzPerceptualQuantizer(df, g);
+        b = JzazbzPerceptualQuantizer(df, b);
+        ColorspaceMatrix(df, r, g, b, lmsToIab);
+        const auto d = Set(df, jzazbzD);
+        r = Sub(Div(Mul(Set(df, 1.f + jzazbzD), r), MulAdd(d, r, Set(df, 1.f))), Set(df, jzazbzD0));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_FAST_MATH_INLINE void JzazbzToSRGB(const D df, V &jz, V &az, V &bz) {
+        static const float iabToLms[9] = {
+                1.f, 0.138605043271539f, 0.0580473161561189f,
+                1.f, -0.138605043271539f, -0.0580473161561189f,
+                1.f, -0.0960192420263190f, -0.811891896056039f
+        };
+        static const float lmsToXyz[9] = {
+                1.92422643578761f, -1.00479231259537f, 0.037651404030618f,
+                0.350316762094999f, 0.726481193931655f, -0.065384422948085f,
+                -0.0909828109828476f, -0.312728290523074f, 1.52276656130526f
+        };
+        const auto jzd = Add(jz, Set(df, jzazbzD0));
+        jz = Div(jzd, NegMulAdd(Set(df, jzazbzD), jzd, Set(df, 1.f + jzazbzD)));
+        ColorspaceMatrix(df, jz, az, bz, iabToLms);
+        jz = JzazbzInversePerceptualQuantizer(df, jz);
+        az = JzazbzInversePerceptualQuantizer(df, az);
+        bz = JzazbzInversePerceptualQuantizer(df, bz);
+        ColorspaceMatrix(df, jz, az, bz, lmsToXyz);
+        const auto z = bz;
+        const auto x = Mul(MulAdd(Set(df, jzazbzB - 1.f), z, jz), Set(df, 1.f / jzazbzB));
+        const auto y = Mul(MulAdd(Set(df, jzazbzG - 1.f), x, az), Set(df, 1.f / jzazbzG));
+        const auto scale = Set(df, 1.f / jzazbzDisplayLuminance);
+        jz = Mul(x, scale);
+        az = Mul(y, scale);
+        bz = Mul(z, scale);
+        ColorspaceMatrix(df, jz, az, bz, colorspaceXYZToRGB);
+        LinearRGBToSRGB(df, jz, az, bz);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
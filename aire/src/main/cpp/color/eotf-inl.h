@@ -89,11 +89,11 @@ namespace aire::HWY_NAMESPACE {
         const VF32 b = Set(df, static_cast<T>(0.28466892f));
         const VF32 c = Set(df, static_cast<T>(0.55991073f));
         const VF32 mm = Set(df, static_cast<T>(0.5f));
-        const VF32 inversed3 = ApproximateReciprocal(Set(df, static_cast<T>(3.f)));
-        const VF32 inversed12 = ApproximateReciprocal(Set(df, static_cast<T>(12.0f)));
+        const VF32 inversed3 = Set(df, static_cast<T>(1.f / 3.f));
+        const VF32 inversed12 = Set(df, static_cast<T>(1.f / 12.0f));
         const auto cmp = v < mm;
         auto branch1 = Mul(Mul(v, v), inversed3);
-        auto branch2 = Mul(aire::HWY_NAMESPACE::sleef::Exp(df, Add(Div(Sub(v, c), a), b)),
+        auto branch2 = Mul(Add(aire::HWY_NAMESPACE::sleef::Exp(df, Div(Sub(v, c), a)), b),
                            inversed12);
         return IfThenElse(cmp, branch1, branch2);
     }
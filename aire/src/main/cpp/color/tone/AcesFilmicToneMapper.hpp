@@ -10,7 +10,7 @@
 
 namespace aire {
     template<typename D>
-    class AcesFilmicToneMapper : public ToneMapper<D> {
+    class AcesFilmicToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -11,7 +11,7 @@
 
 namespace aire {
     template<typename D>
-    class AldridgeToneMapper : public ToneMapper<D> {
+    class AldridgeToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
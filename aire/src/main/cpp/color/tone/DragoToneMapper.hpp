@@ -10,7 +10,7 @@
 
 namespace aire {
     template<typename D>
-    class DragoToneMapper : public ToneMapper<D> {
+    class DragoToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -28,6 +28,11 @@ namespace aire {
                                                          ToneMapper<D>() {
             std::copy(lumaCoefficients, lumaCoefficients + 3, this->lumaCoefficients);
             this->lumaCoefficients[3] = 0.0f;
+            // Curve parameters do not depend on pixel, so computed once
+            lwaP = Lwa / std::powf(1.f + bias - 0.85f, 5.f);
+            lmaxP = maxLd / lwaP;
+            exponent = std::log(bias) / std::log(0.5f);
+            c1 = (0.01f * maxLd) / std::log10(1.f + lmaxP);
         }
 
         ~DragoToneMapper() override = default;
@@ -51,26 +56,24 @@ namespace aire {
 
             V Lin = Add(Add(rLuma, gLuma), bLuma);
 
-            const TFromD<D> Lmax = this->maxLd;
-            const auto LwaP = Set(df_, Lwa / std::powf(1.f + bias - 0.85f, 5.f));
-            const auto LmaxP = Div(Set(df_, Lmax), LwaP);
+            const auto LwaP = Set(df_, lwaP);
+            const auto LmaxP = Set(df_, lmaxP);
             const auto LinP = Div(Lin, LwaP);
 
-            const auto exponent = Set(df_, std::log(bias) / std::log(0.5f));
-            const auto c1High = Set(df_, 0.01f * maxLd);
-            const auto c1 = Div(c1High, hwy::HWY_NAMESPACE::sleef::Log10f(df_, Add(ones, LmaxP)));
+            const auto vExponent = Set(df_, exponent);
+            const auto vC1 = Set(df_, c1);
 
             const auto twos = Set(df_, static_cast<TFromD<D>>(2.f));
             const auto eights = Set(df_, static_cast<TFromD<D>>(8.f));
 
             const auto c2 = Div(hwy::HWY_NAMESPACE::sleef::LogFast(df_, Add(ones, LinP)),
                                 hwy::HWY_NAMESPACE::sleef::LogFast(df_,
-                                        MulAdd(eights, aire::HWY_NAMESPACE::Pow(df_, Div(LinP, LmaxP), exponent), twos)
+                                        MulAdd(eights, aire::HWY_NAMESPACE::Pow(df_, Div(LinP, LmaxP), vExponent), twos)
                                 ));
 
             Lin = IfThenElse(Lin == zeros, ones, Lin);
 
-            const auto Lout = Mul(c1, c2);
+            const auto Lout = Mul(vC1, c2);
 
             V scales = Div(Lout, Lin);
             R = Mul(R, scales);
@@ -115,5 +118,9 @@ namespace aire {
         }
 
         TFromD<D> lumaCoefficients[4];
+        TFromD<D> lwaP;
+        TFromD<D> lmaxP;
+        TFromD<D> exponent;
+        TFromD<D> c1;
     };
 }
\ No newline at end of file
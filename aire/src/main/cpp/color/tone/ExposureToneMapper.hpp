@@ -9,7 +9,7 @@
 
 namespace aire {
     template<typename D>
-    class ExposureToneMapper : public ToneMapper<D> {
+    class ExposureToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -11,7 +11,7 @@
 
 namespace aire {
     template<typename D>
-    class HableFilmicToneMapper : public ToneMapper<D> {
+    class HableFilmicToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
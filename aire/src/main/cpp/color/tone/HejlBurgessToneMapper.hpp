@@ -10,7 +10,7 @@
 
 namespace aire {
     template<typename D>
-    class HejlBurgessToneMapper : public ToneMapper<D> {
+    class HejlBurgessToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -9,7 +9,7 @@
 
 namespace aire {
     template<typename D>
-    class LogarithmicToneMapper : public ToneMapper<D> {
+    class LogarithmicToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -11,7 +11,7 @@
 
 namespace aire {
     template<typename D>
-    class MobiusToneMapper : public ToneMapper<D> {
+    class MobiusToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -2,6 +2,8 @@
 // Created by Radzivon Bartoshyk on 05/02/2024.
 //
 
+#pragma once
+
 #include "ToneMapper.h"
 #include "color/Blend.h"
 #include <fast_math-inl.h>
@@ -9,7 +11,7 @@
 
 namespace aire {
     template<typename D>
-    class MonochromeToneMapper : public ToneMapper<D> {
+    class MonochromeToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
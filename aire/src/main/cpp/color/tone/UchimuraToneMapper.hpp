@@ -11,7 +11,7 @@
 
 namespace aire {
     template<typename D>
-    class UchimuraToneMapper : public ToneMapper<D> {
+    class UchimuraToneMapper final : public ToneMapper<D> {
     private:
         using V = Vec<D>;
         D df_;
@@ -35,6 +35,7 @@
 
 #include "hwy/highway.h"
 #include "hwy/ops/shared-inl.h"
+#include <algorithm>
 
 #define HWY_ATTENUATE_INLINE inline __attribute__((flatten))
 
@@ -71,6 +72,14 @@ namespace aire::HWY_NAMESPACE {
     using hwy::HWY_NAMESPACE::Div;
     using hwy::HWY_NAMESPACE::TFromV;
     using hwy::HWY_NAMESPACE::TFromD;
+    using hwy::HWY_NAMESPACE::Add;
+    using hwy::HWY_NAMESPACE::Gt;
+    using hwy::HWY_NAMESPACE::IfThenElseZero;
+    using hwy::HWY_NAMESPACE::ConcatEven;
+    using hwy::HWY_NAMESPACE::Repartition;
+    using hwy::HWY_NAMESPACE::RebindToFloat;
+    using hwy::HWY_NAMESPACE::RebindToSigned;
+    using hwy::HWY_NAMESPACE::RebindToUnsigned;
     using hwy::EnableIf;
     using hwy::IsSame;
     using hwy::float16_t;
@@ -162,6 +171,56 @@ namespace aire::HWY_NAMESPACE {
         auto low = DemoteTo(du8x4, ConvertTo(du32x4, vk));
         return low;
     }
+
+    /**
+     * Premultiplies u8 values held in 16 bit lanes, exactly round(v * a / 255)
+     */
+    template<class D, typename V = Vec<D>, HWY_IF_NOT_FLOAT_D(D), HWY_IF_T_SIZE_D(D, 2)>
+    HWY_ATTENUATE_INLINE V
+    AttenuateVec16(D d, V vec, V alpha) {
+        const RebindToUnsigned<D> du16;
+        const auto product = Add(Mul(BitCast(du16, vec), BitCast(du16, alpha)), Set(du16, 128));
+        return BitCast(d, ShiftRight<8>(Add(product, ShiftRight<8>(product))));
+    }
+
+    /**
+     * Unpremultiplies u8 values held in 16 bit lanes as round(min(v, a) * 255 / a), zero alpha gives zero
+     */
+    template<class D, typename V = Vec<D>, HWY_IF_NOT_FLOAT_D(D), HWY_IF_T_SIZE_D(D, 2)>
+    HWY_ATTENUATE_INLINE V
+    UnattenuateVec16(D d, V vec, V alpha) {
+        const RebindToUnsigned<D> du16;
+        const Repartition<uint32_t, D> du32;
+        const RebindToSigned<decltype(du32)> di32;
+        const RebindToFloat<decltype(du32)> df32;
+        const auto a = BitCast(du16, alpha);
+        const auto numerator = Add(Mul(Min(BitCast(du16, vec), a), Set(du16, 255)), ShiftRight<1>(a));
+        const auto denominator = Max(a, Set(du16, 1));
+        // Quotients are far enough from the next integer for f32 division to truncate exactly
+        const auto low = ConvertTo(di32, Div(ConvertTo(df32, BitCast(di32, PromoteLowerTo(du32, numerator))),
+                                             ConvertTo(df32, BitCast(di32, PromoteLowerTo(du32, denominator)))));
+        const auto high = ConvertTo(di32, Div(ConvertTo(df32, BitCast(di32, PromoteUpperTo(du32, numerator))),
+                                              ConvertTo(df32, BitCast(di32, PromoteUpperTo(du32, denominator)))));
+        return BitCast(d, ConcatEven(du16, BitCast(du16, high), BitCast(du16, low)));
+    }
+
+    // Float unpremultiply, zero alpha gives zero
+    template<class D, typename V = Vec<D>, HWY_IF_FLOAT_D(D)>
+    HWY_ATTENUATE_INLINE V
+    UnattenuateVec(D d, V vec, V alpha) {
+        return IfThenElseZero(Gt(alpha, Zero(d)), Div(vec, alpha));
+    }
+
+    static inline uint8_t Attenuate(const uint8_t value, const uint8_t alpha) {
+        return static_cast<uint8_t>((value * alpha + 127) / 255);
+    }
+
+    static inline uint8_t Unattenuate(const uint8_t value, const uint8_t alpha) {
+        if (alpha == 0) {
+            return 0;
+        }
+        return static_cast<uint8_t>((std::min(value, alpha) * 255 + alpha / 2) / alpha);
+    }
 }
 
 HWY_AFTER_NAMESPACE();
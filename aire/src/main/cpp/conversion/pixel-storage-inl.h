@@ -0,0 +1,221 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 29/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#if defined(AIRE_PIXEL_STORAGE_INL_H) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_PIXEL_STORAGE_INL_H
+#undef AIRE_PIXEL_STORAGE_INL_H
+#else
+#define AIRE_PIXEL_STORAGE_INL_H
+#endif
+
+#include "hwy/highway.h"
+#include "PixelStorage.h"
+#include <algorithm>
+#include <type_traits>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    template<PixelStorage Storage>
+    using PixelStorageTag = std::integral_constant<PixelStorage, Storage>;
+
+    // Instantiates function with the storage as a compile time constant
+    template<class Function>
+    HWY_INLINE void DispatchPixelStorage(const PixelStorage storage, Function &&function) {
+        switch (storage) {
+            case PIXEL_RGBA_F16:
+                function(PixelStorageTag<PIXEL_RGBA_F16>());
+                break;
+            case PIXEL_RGBA1010102:
+                function(PixelStorageTag<PIXEL_RGBA1010102>());
+                break;
+            case PIXEL_RGB565:
+                function(PixelStorageTag<PIXEL_RGB565>());
+                break;
+            default:
+                function(PixelStorageTag<PIXEL_RGBA8888>());
+                break;
+        }
+    }
+
+    template<PixelStorage Storage>
+    constexpr int PixelStorageBytes = Storage == PIXEL_RGBA_F16 ? 8 : (Storage == PIXEL_RGB565 ? 2 : 4);
+
+    /**
+     * Loads Lanes(df) pixels as normalized floats, 565 has no alpha so it's loaded as 1.
+     * F16 is returned as is, so extended range values may be outside of [0, 1]
+     */
+    template<PixelStorage Storage, class D, typename V = Vec<D>>
+    HWY_INLINE void LoadPixels(const D df, const uint8_t *pixels, V &r, V &g, V &b, V &a) {
+        if constexpr (Storage == PIXEL_RGBA8888) {
+            const Rebind<uint8_t, decltype(df)> du8;
+            const Rebind<int32_t, decltype(df)> di32;
+            const auto vRevertScale = Set(df, 1.f / 255.f);
+            Vec<decltype(du8)> ru, gu, bu, au;
+            LoadInterleaved4(du8, pixels, ru, gu, bu, au);
+            r = Mul(ConvertTo(df, PromoteTo(di32, ru)), vRevertScale);
+            g = Mul(ConvertTo(df, PromoteTo(di32, gu)), vRevertScale);
+            b = Mul(ConvertTo(df, PromoteTo(di32, bu)), vRevertScale);
+            a = Mul(ConvertTo(df, PromoteTo(di32, au)), vRevertScale);
+        } else if constexpr (Storage == PIXEL_RGBA_F16) {
+            const Rebind<uint16_t, decltype(df)> du16;
+            const Rebind<hwy::float16_t, decltype(df)> dh;
+            Vec<decltype(du16)> ru, gu, bu, au;
+            LoadInterleaved4(du16, reinterpret_cast<const uint16_t *>(pixels), ru, gu, bu, au);
+            r = PromoteTo(df, BitCast(dh, ru));
+            g = PromoteTo(df, BitCast(dh, gu));
+            b = PromoteTo(df, BitCast(dh, bu));
+            a = PromoteTo(df, BitCast(dh, au));
+        } else if constexpr (Storage == PIXEL_RGBA1010102) {
+            const Rebind<uint32_t, decltype(df)> du32;
+            const auto mask = Set(du32, 0x3ff);
+            const auto vRevertScale = Set(df, 1.f / 1023.f);
+            const auto packed = LoadU(du32, reinterpret_cast<const uint32_t *>(pixels));
+            r = Mul(ConvertTo(df, And(packed, mask)), vRevertScale);
+            g = Mul(ConvertTo(df, And(ShiftRight<10>(packed), mask)), vRevertScale);
+            b = Mul(ConvertTo(df, And(ShiftRight<20>(packed), mask)), vRevertScale);
+            a = Mul(ConvertTo(df, ShiftRight<30>(packed)), Set(df, 1.f / 3.f));
+        } else {
+            const Rebind<uint16_t, decltype(df)> du16;
+            const Rebind<uint32_t, decltype(df)> du32;
+            const auto packed = PromoteTo(du32, LoadU(du16, reinterpret_cast<const uint16_t *>(pixels)));
+            r = Mul(ConvertTo(df, ShiftRight<11>(packed)), Set(df, 1.f / 31.f));
+            g = Mul(ConvertTo(df, And(ShiftRight<5>(packed), Set(du32, 0x3f))), Set(df, 1.f / 63.f));
+            b = Mul(ConvertTo(df, And(packed, Set(du32, 0x1f))), Set(df, 1.f / 31.f));
+            a = Set(df, 1.f);
+        }
+    }
+
+    // Stores normalized floats, integer storages are clamped to [0, 1] with rounding to nearest
+    // and 565 drops alpha; F16 keeps color outside of [0, 1] so extended range survives
+    template<PixelStorage Storage, class D, typename V = Vec<D>>
+    HWY_INLINE void StorePixels(const D df, uint8_t *pixels, V r, V g, V b, V a) {
+        const auto zeros = Zero(df);
+        if constexpr (Storage == PIXEL_RGBA8888) {
+            const Rebind<uint8_t, decltype(df)> du8;
+            const auto vScale = Set(df, 255.f);
+            const auto ru = DemoteTo(du8, NearestInt(Clamp(Mul(r, vScale), zeros, vScale)));
+            const auto gu = DemoteTo(du8, NearestInt(Clamp(Mul(g, vScale), zeros, vScale)));
+            const auto bu = DemoteTo(du8, NearestInt(Clamp(Mul(b, vScale), zeros, vScale)));
+            const auto au = DemoteTo(du8, NearestInt(Clamp(Mul(a, vScale), zeros, vScale)));
+            StoreInterleaved4(ru, gu, bu, au, du8, pixels);
+        } else if constexpr (Storage == PIXEL_RGBA_F16) {
+            const Rebind<uint16_t, decltype(df)> du16;
+            const Rebind<hwy::float16_t, decltype(df)> dh;
+            StoreInterleaved4(BitCast(du16, DemoteTo(dh, r)),
+                              BitCast(du16, DemoteTo(dh, g)),
+                              BitCast(du16, DemoteTo(dh, b)),
+                              BitCast(du16, DemoteTo(dh, Clamp(a, zeros, Set(df, 1.f)))),
+                              du16, reinterpret_cast<uint16_t *>(pixels));
+        } else if constexpr (Storage == PIXEL_RGBA1010102) {
+            const Rebind<uint32_t, decltype(df)> du32;
+            const auto vScale = Set(df, 1023.f);
+            const auto vAlphaScale = Set(df, 3.f);
+            const auto ri = BitCast(du32, NearestInt(Clamp(Mul(r, vScale), zeros, vScale)));
+            const auto gi = BitCast(du32, NearestInt(Clamp(Mul(g, vScale), zeros, vScale)));
+            const auto bi = BitCast(du32, NearestInt(Clamp(Mul(b, vScale), zeros, vScale)));
+            const auto ai = BitCast(du32, NearestInt(Clamp(Mul(a, vAlphaScale), zeros, vAlphaScale)));
+            const auto packed = Or(Or(ri, ShiftLeft<10>(gi)), Or(ShiftLeft<20>(bi), ShiftLeft<30>(ai)));
+            StoreU(packed, du32, reinterpret_cast<uint32_t *>(pixels));
+        } else {
+            const Rebind<uint16_t, decltype(df)> du16;
+            const Rebind<uint32_t, decltype(df)> du32;
+            const auto v31 = Set(df, 31.f);
+            const auto v63 = Set(df, 63.f);
+            const auto ri = BitCast(du32, NearestInt(Clamp(Mul(r, v31), zeros, v31)));
+            const auto gi = BitCast(du32, NearestInt(Clamp(Mul(g, v63), zeros, v63)));
+            const auto bi = BitCast(du32, NearestInt(Clamp(Mul(b, v31), zeros, v31)));
+            const auto packed = Or(ShiftLeft<11>(ri), Or(ShiftLeft<5>(gi), bi));
+            StoreU(DemoteTo(du16, packed), du16, reinterpret_cast<uint16_t *>(pixels));
+        }
+    }
+
+    // Premultiplied color to straight alpha, zero alpha gives zero
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void UnpremultiplyPixels(const D df, V &r, V &g, V &b, const V a) {
+        const auto scale = IfThenElseZero(Gt(a, Zero(df)), Div(Set(df, 1.f), a));
+        r = Mul(r, scale);
+        g = Mul(g, scale);
+        b = Mul(b, scale);
+    }
+
+    // Straight color back to premultiplied, integer storages are clamped first so color never exceeds alpha
+    template<PixelStorage Storage, class D, typename V = Vec<D>>
+    HWY_INLINE void PremultiplyPixels(const D df, V &r, V &g, V &b, const V a) {
+        if constexpr (Storage != PIXEL_RGBA_F16) {
+            const auto zeros = Zero(df);
+            const auto ones = Set(df, 1.f);
+            r = Clamp(r, zeros, ones);
+            g = Clamp(g, zeros, ones);
+            b = Clamp(b, zeros, ones);
+        }
+        r = Mul(r, a);
+        g = Mul(g, a);
+        b = Mul(b, a);
+    }
+
+    /**
+     * Runs pixel function over a row of width pixels, a vector at a time. Tail shorter than a vector
+     * goes through a padded copy. Source and destination may be the same row when storages match
+     */
+    template<PixelStorage Source, PixelStorage Destination, class D, class PixelFunction>
+    HWY_INLINE void TransformPixelRow(const D df, const uint8_t *src, uint8_t *dst, const int width,
+                                      PixelFunction &&function) {
+        const int lanes = static_cast<int>(Lanes(df));
+        constexpr int srcPixelSize = PixelStorageBytes<Source>;
+        constexpr int dstPixelSize = PixelStorageBytes<Destination>;
+        Vec<D> r, g, b, a;
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            LoadPixels<Source>(df, src, r, g, b, a);
+            function(r, g, b, a);
+            StorePixels<Destination>(df, dst, r, g, b, a);
+            src += lanes * srcPixelSize;
+            dst += lanes * dstPixelSize;
+        }
+
+        if (x < width) {
+            const int remaining = width - x;
+            HWY_ALIGN uint8_t srcTail[HWY_MAX_LANES_D(D) * srcPixelSize] = {};
+            HWY_ALIGN uint8_t dstTail[HWY_MAX_LANES_D(D) * dstPixelSize];
+            std::copy(src, src + remaining * srcPixelSize, srcTail);
+            LoadPixels<Source>(df, srcTail, r, g, b, a);
+            function(r, g, b, a);
+            StorePixels<Destination>(df, dstTail, r, g, b, a);
+            std::copy(dstTail, dstTail + remaining * dstPixelSize, dst);
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
@@ -0,0 +1,319 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "RgbaToYuv.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "concurrency.hpp"
+
+using namespace std;
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "RgbaToYuv.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "jni/JNIUtils.h"
+
+HWY_BEFORE_NAMESPACE();
+
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    // Q15 weights, luma bias is Q6 with rounding already added
+    struct RgbToYuvCoefficients {
+        int16_t yR;
+        int16_t yG;
+        int16_t yB;
+        int16_t yBias;
+        int16_t uR;
+        int16_t uG;
+        int16_t uB;
+        int16_t vR;
+        int16_t vG;
+        int16_t vB;
+    };
+
+    template<bool BGRA, class D, typename V = Vec<D>>
+    HWY_INLINE void RgbaLoadRGB(const D di16, const uint8_t *src, V &r, V &g, V &b) {
+        const Rebind<uint8_t, decltype(di16)> du8;
+        const RebindToUnsigned<decltype(di16)> du16;
+        Vec<decltype(du8)> r8, g8, b8, a8;
+        LoadInterleaved4(du8, src, r8, g8, b8, a8);
+        if constexpr (BGRA) {
+            std::swap(r8, b8);
+        }
+        r = BitCast(di16, PromoteTo(du16, r8));
+        g = BitCast(di16, PromoteTo(du16, g8));
+        b = BitCast(di16, PromoteTo(du16, b8));
+    }
+
+    /**
+     * Weighted sum in Q6, values must be scaled so that value * weight stays in Q21,
+     * 8 bit channels are shifted by 7 and 2x2 sums by 5
+     */
+    template<int Shift, class D, typename V = Vec<D>>
+    HWY_INLINE V RgbWeightedSum(const D di16, V r, V g, V b, const int16_t wR, const int16_t wG, const int16_t wB,
+                                const int16_t bias) {
+        auto sum = Add(MulHigh(ShiftLeft<Shift>(r), Set(di16, wR)), Set(di16, bias));
+        sum = Add(sum, MulHigh(ShiftLeft<Shift>(g), Set(di16, wG)));
+        sum = Add(sum, MulHigh(ShiftLeft<Shift>(b), Set(di16, wB)));
+        return ShiftRight<6>(sum);
+    }
+
+    template<YuvLayout Layout, bool BGRA>
+    void RgbaToYuvImpl(const uint8_t *src, const int srcStride, const int width, const int height,
+                       uint8_t *yPlane, const int yStride, uint8_t *uPlane, const int uStride,
+                       uint8_t *vPlane, const int vStride, const RgbToYuvCoefficients &c) {
+        const ScalableTag<int16_t> di16;
+        const Rebind<uint8_t, decltype(di16)> du8;
+        using V = Vec<decltype(di16)>;
+        const int lanes = static_cast<int>(Lanes(di16));
+        constexpr bool interleaved = Layout == YUV_LAYOUT_NV12 || Layout == YUV_LAYOUT_NV21;
+        const int16_t chromaBias = (128 << 6) + 32;
+
+        // Converts 2 * lanes pixels of two rows, second luma row is skipped when y1 is null
+        auto convert = [&](const uint8_t *src0, const uint8_t *src1, uint8_t *y0, uint8_t *y1,
+                           uint8_t *uDst, uint8_t *vDst) {
+            V r0, g0, b0, r1, g1, b1, r2, g2, b2, r3, g3, b3;
+            RgbaLoadRGB<BGRA>(di16, src0, r0, g0, b0);
+            RgbaLoadRGB<BGRA>(di16, src0 + lanes * 4, r1, g1, b1);
+            RgbaLoadRGB<BGRA>(di16, src1, r2, g2, b2);
+            RgbaLoadRGB<BGRA>(di16, src1 + lanes * 4, r3, g3, b3);
+
+            StoreU(DemoteTo(du8, RgbWeightedSum<7>(di16, r0, g0, b0, c.yR, c.yG, c.yB, c.yBias)), du8, y0);
+            StoreU(DemoteTo(du8, RgbWeightedSum<7>(di16, r1, g1, b1, c.yR, c.yG, c.yB, c.yBias)), du8, y0 + lanes);
+            if (y1) {
+                StoreU(DemoteTo(du8, RgbWeightedSum<7>(di16, r2, g2, b2, c.yR, c.yG, c.yB, c.yBias)), du8, y1);
+                StoreU(DemoteTo(du8, RgbWeightedSum<7>(di16, r3, g3, b3, c.yR, c.yG, c.yB, c.yBias)), du8,
+                       y1 + lanes);
+            }
+
+            // Vertical sums first, then adjacent lanes are added, each lane holds a sum of 2x2 block
+            auto blockSum = [&](V top0, V top1, V bottom0, V bottom1) {
+                const V first = Add(top0, bottom0);
+                const V second = Add(top1, bottom1);
+                return Add(ConcatEven(di16, second, first), ConcatOdd(di16, second, first));
+            };
+            const V r = blockSum(r0, r1, r2, r3);
+            const V g = blockSum(g0, g1, g2, g3);
+            const V b = blockSum(b0, b1, b2, b3);
+
+            const auto u = DemoteTo(du8, RgbWeightedSum<5>(di16, r, g, b, c.uR, c.uG, c.uB, chromaBias));
+            const auto v = DemoteTo(du8, RgbWeightedSum<5>(di16, r, g, b, c.vR, c.vG, c.vB, chromaBias));
+            if constexpr (Layout == YUV_LAYOUT_NV12) {
+                StoreInterleaved2(u, v, du8, uDst);
+            } else if constexpr (Layout == YUV_LAYOUT_NV21) {
+                StoreInterleaved2(v, u, du8, uDst);
+            } else {
+                StoreU(u, du8, uDst);
+                StoreU(v, du8, vDst);
+            }
+        };
+
+        const int pairs = (height + 1) / 2;
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, pairs, [&](int pair) {
+            const int y = pair * 2;
+            const bool hasSecondRow = y + 1 < height;
+            const uint8_t *src0 = src + static_cast<size_t>(y) * srcStride;
+            const uint8_t *src1 = hasSecondRow ? src0 + srcStride : src0;
+            uint8_t *y0 = yPlane + static_cast<size_t>(y) * yStride;
+            uint8_t *y1 = hasSecondRow ? y0 + yStride : nullptr;
+            uint8_t *uRow = uPlane + static_cast<size_t>(pair) * uStride;
+            uint8_t *vRow = interleaved ? nullptr : vPlane + static_cast<size_t>(pair) * vStride;
+
+            int x = 0;
+            for (; x + lanes * 2 <= width; x += lanes * 2) {
+                convert(src0 + x * 4, src1 + x * 4, y0 + x, y1 ? y1 + x : nullptr,
+                        uRow + (interleaved ? x : x / 2), interleaved ? nullptr : vRow + x / 2);
+            }
+
+            if (x < width) {
+                const int remaining = width - x;
+                const int chromaRemaining = (remaining + 1) / 2;
+                constexpr int maxPixels = HWY_MAX_LANES_D(decltype(di16)) * 2;
+                HWY_ALIGN uint8_t srcTail0[maxPixels * 4];
+                HWY_ALIGN uint8_t srcTail1[maxPixels * 4];
+                HWY_ALIGN uint8_t yTail0[maxPixels];
+                HWY_ALIGN uint8_t yTail1[maxPixels];
+                HWY_ALIGN uint8_t uTail[maxPixels];
+                HWY_ALIGN uint8_t vTail[maxPixels];
+                // Last pixel is replicated so odd edge chroma averages only real pixels
+                for (int i = 0; i < lanes * 2; ++i) {
+                    const int sx = x + std::min(i, remaining - 1);
+                    std::copy(src0 + sx * 4, src0 + sx * 4 + 4, srcTail0 + i * 4);
+                    std::copy(src1 + sx * 4, src1 + sx * 4 + 4, srcTail1 + i * 4);
+                }
+                convert(srcTail0, srcTail1, yTail0, y1 ? yTail1 : nullptr, uTail, vTail);
+                std::copy(yTail0, yTail0 + remaining, y0 + x);
+                if (y1) {
+                    std::copy(yTail1, yTail1 + remaining, y1 + x);
+                }
+                if (interleaved) {
+                    std::copy(uTail, uTail + chromaRemaining * 2, uRow + x);
+                } else {
+                    std::copy(uTail, uTail + chromaRemaining, uRow + x / 2);
+                    std::copy(vTail, vTail + chromaRemaining, vRow + x / 2);
+                }
+            }
+        });
+    }
+
+    void RgbaToYuvHWY(const YuvLayout layout, const bool bgra, const uint8_t *src, const int srcStride,
+                      const int width, const int height, uint8_t *yDst, const int yStride,
+                      uint8_t *uDst, const int uStride, uint8_t *vDst, const int vStride,
+                      const int16_t fixedCoefficients[10]) {
+        const RgbToYuvCoefficients coefficients = {
+                fixedCoefficients[0], fixedCoefficients[1], fixedCoefficients[2], fixedCoefficients[3],
+                fixedCoefficients[4], fixedCoefficients[5], fixedCoefficients[6],
+                fixedCoefficients[7], fixedCoefficients[8], fixedCoefficients[9]
+        };
+        auto run = [&](auto layoutTag) {
+            constexpr YuvLayout Layout = decltype(layoutTag)::value;
+            if (bgra) {
+                RgbaToYuvImpl<Layout, true>(src, srcStride, width, height, yDst, yStride, uDst, uStride,
+                                            vDst, vStride, coefficients);
+            } else {
+                RgbaToYuvImpl<Layout, false>(src, srcStride, width, height, yDst, yStride, uDst, uStride,
+                                             vDst, vStride, coefficients);
+            }
+        };
+        switch (layout) {
+            case YUV_LAYOUT_NV12:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_NV12>());
+                break;
+            case YUV_LAYOUT_NV21:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_NV21>());
+                break;
+            case YUV_LAYOUT_I420:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_I420>());
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(RgbaToYuvHWY);
+
+    // Luma weights and bias, then U and V weights, all scaled to the target range
+    static void rgbToYuvCoefficients(const YuvMatrix matrix, const YuvRange range, int16_t coefficients[10]) {
+        float kr = 0.299f, kb = 0.114f;
+        if (matrix == YUV_MATRIX_BT709) {
+            kr = 0.2126f;
+            kb = 0.0722f;
+        } else if (matrix == YUV_MATRIX_BT2020) {
+            kr = 0.2627f;
+            kb = 0.0593f;
+        }
+        const float kg = 1.f - kr - kb;
+        const bool full = range == YUV_RANGE_FULL;
+        const float lumaScale = full ? 1.f : 219.f / 255.f;
+        const float chromaScale = full ? 1.f : 224.f / 255.f;
+        const float q = 32768.f;
+        const float cb = 0.5f / (1.f - kb) * chromaScale;
+        const float cr = 0.5f / (1.f - kr) * chromaScale;
+        const float values[10] = {
+                kr * lumaScale * q,
+                kg * lumaScale * q,
+                kb * lumaScale * q,
+                (full ? 0.f : 16.f * 64.f) + 32.f,
+                -kr * cb * q,
+                -kg * cb * q,
+                (1.f - kb) * cb * q,
+                (1.f - kr) * cr * q,
+                -kg * cr * q,
+                -kb * cr * q,
+        };
+        for (int i = 0; i < 10; ++i) {
+            coefficients[i] = static_cast<int16_t>(std::clamp(std::lround(values[i]), -32768l, 32767l));
+        }
+    }
+
+    static void rgbaToYuv(const YuvLayout layout, const bool bgra, const uint8_t *src, int srcStride,
+                          int width, int height, uint8_t *yDst, int yStride, uint8_t *uDst, int uStride,
+                          uint8_t *vDst, int vStride, YuvMatrix matrix, YuvRange range) {
+        if (width <= 0 || height <= 0) {
+            std::string msg = "Invalid image size";
+            throw AireError(msg);
+        }
+        int16_t coefficients[10];
+        rgbToYuvCoefficients(matrix, range, coefficients);
+        HWY_DYNAMIC_DISPATCH(RgbaToYuvHWY)(layout, bgra, src, srcStride, width, height, yDst, yStride,
+                                           uDst, uStride, vDst, vStride, coefficients);
+    }
+
+    void RGBAToNV12(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uvDst, int uvStride, YuvMatrix matrix, YuvRange range) {
+        rgbaToYuv(YUV_LAYOUT_NV12, false, src, srcStride, width, height, yDst, yStride, uvDst, uvStride,
+                  nullptr, 0, matrix, range);
+    }
+
+    void RGBAToNV21(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *vuDst, int vuStride, YuvMatrix matrix, YuvRange range) {
+        rgbaToYuv(YUV_LAYOUT_NV21, false, src, srcStride, width, height, yDst, yStride, vuDst, vuStride,
+                  nullptr, 0, matrix, range);
+    }
+
+    void RGBAToI420(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uDst, int uStride, uint8_t *vDst, int vStride, YuvMatrix matrix, YuvRange range) {
+        rgbaToYuv(YUV_LAYOUT_I420, false, src, srcStride, width, height, yDst, yStride, uDst, uStride,
+                  vDst, vStride, matrix, range);
+    }
+
+    void BGRAToNV12(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uvDst, int uvStride, YuvMatrix matrix, YuvRange range) {
+        rgbaToYuv(YUV_LAYOUT_NV12, true, src, srcStride, width, height, yDst, yStride, uvDst, uvStride,
+                  nullptr, 0, matrix, range);
+    }
+
+    void BGRAToNV21(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *vuDst, int vuStride, YuvMatrix matrix, YuvRange range) {
+        rgbaToYuv(YUV_LAYOUT_NV21, true, src, srcStride, width, height, yDst, yStride, vuDst, vuStride,
+                  nullptr, 0, matrix, range);
+    }
+
+    void BGRAToI420(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uDst, int uStride, uint8_t *vDst, int vStride, YuvMatrix matrix, YuvRange range) {
+        rgbaToYuv(YUV_LAYOUT_I420, true, src, srcStride, width, height, yDst, yStride, uDst, uStride,
+                  vDst, vStride, matrix, range);
+    }
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "YuvConverter.h"
+
+namespace aire {
+
+    /**
+     * RGBA8888 or BGRA8888 to 8 bit 4:2:0 YUV, alpha is ignored.
+     * Chroma is an average of the 2x2 block it covers, odd edges are replicated
+     */
+    void RGBAToNV12(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uvDst, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+
+    void RGBAToNV21(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *vuDst, int vuStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+
+    void RGBAToI420(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uDst, int uStride, uint8_t *vDst, int vStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+
+    void BGRAToNV12(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uvDst, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+
+    void BGRAToNV21(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *vuDst, int vuStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+
+    void BGRAToI420(const uint8_t *src, int srcStride, int width, int height, uint8_t *yDst, int yStride,
+                    uint8_t *uDst, int uStride, uint8_t *vDst, int vStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+}
@@ -0,0 +1,308 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "Yuv10Converter.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "concurrency.hpp"
+#include "conversion/PixelStorage.h"
+
+using namespace std;
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "Yuv10Converter.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "color/eotf-inl.h"
+#include "conversion/pixel-storage-inl.h"
+#include "jni/JNIUtils.h"
+
+HWY_BEFORE_NAMESPACE();
+
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    // Normalized floats, luma is Y * lumaScale - lumaBias and chroma weights already include range scale
+    struct Yuv10Coefficients {
+        float lumaScale;
+        float lumaBias;
+        float crR;
+        float cbB;
+        float crG;
+        float cbG;
+    };
+
+    // Transfer curves are sampled into a table, two pows per channel cost more than the whole conversion
+    static constexpr int kTransferTableSize = 4096;
+
+    template<YuvTransfer Transfer, class D, typename V = Vec<D>>
+    HWY_INLINE V Yuv10Linearize(const D df, V v, const float *transferTable) {
+        v = Clamp(v, Zero(df), Set(df, 1.f));
+        if constexpr (Transfer == YUV_TRANSFER_NONE) {
+            return v;
+        } else {
+            const RebindToSigned<decltype(df)> di32;
+            const auto scaled = Mul(v, Set(df, static_cast<float>(kTransferTableSize)));
+            const auto index = Min(ConvertTo(di32, scaled), Set(di32, kTransferTableSize - 1));
+            const auto fraction = Sub(scaled, ConvertTo(df, index));
+            const auto lower = GatherIndex(df, transferTable, index);
+            const auto upper = GatherIndex(df, transferTable + 1, index);
+            return MulAdd(Sub(upper, lower), fraction, lower);
+        }
+    }
+
+    template<YuvTransfer Transfer, class D, typename V = Vec<D>>
+    HWY_INLINE void Yuv10ToRGB(const D df, V y, V u, V v, const Yuv10Coefficients &c, const float *transferTable,
+                               V &r, V &g, V &b) {
+        const auto luma = MulSub(y, Set(df, c.lumaScale), Set(df, c.lumaBias));
+        const auto center = Set(df, 512.f);
+        const auto cb = Sub(u, center);
+        const auto cr = Sub(v, center);
+        r = Yuv10Linearize<Transfer>(df, MulAdd(cr, Set(df, c.crR), luma), transferTable);
+        b = Yuv10Linearize<Transfer>(df, MulAdd(cb, Set(df, c.cbB), luma), transferTable);
+        g = Yuv10Linearize<Transfer>(df, NegMulAdd(cb, Set(df, c.cbG), NegMulAdd(cr, Set(df, c.crG), luma)),
+                                     transferTable);
+    }
+
+    template<bool Interleaved, PixelStorage Storage, YuvTransfer Transfer>
+    void Yuv10ToRGBAImpl(uint8_t *dst, const int dstStride, const int width, const int height,
+                         const uint8_t *yPlane, const int yStride, const uint8_t *uPlane, const int uStride,
+                         const uint8_t *vPlane, const int vStride, const Yuv10Coefficients &coefficients,
+                         const float *transferTable) {
+        const ScalableTag<uint16_t> du16;
+        const Half<decltype(du16)> dh16;
+        const Repartition<int32_t, decltype(du16)> di32;
+        const Rebind<float, decltype(di32)> df;
+        const Rebind<hwy::float16_t, decltype(df)> dhf;
+        using VF = Vec<decltype(df)>;
+        const int lanes = static_cast<int>(Lanes(du16));
+        const int floatLanes = static_cast<int>(Lanes(df));
+        constexpr int pixelSize = Storage == PIXEL_RGBA_F16 ? 8 : 4;
+        // PQ keeps highlights above reference white, everything else is in [0, 1]
+        const float maxValue = Transfer == YUV_TRANSFER_PQ ? 10000.f / 203.f : 1.f;
+
+        auto convert = [&](const uint16_t *ySrc, const uint16_t *uSrc, const uint16_t *vSrc, uint8_t *store) {
+            auto y = LoadU(du16, ySrc);
+            Vec<decltype(dh16)> uh, vh;
+            if constexpr (Interleaved) {
+                LoadInterleaved2(dh16, uSrc, uh, vh);
+                y = ShiftRight<6>(y);
+                uh = ShiftRight<6>(uh);
+                vh = ShiftRight<6>(vh);
+            } else {
+                uh = LoadU(dh16, uSrc);
+                vh = LoadU(dh16, vSrc);
+            }
+            const auto u = Combine(du16, InterleaveUpper(dh16, uh, uh), InterleaveLower(dh16, uh, uh));
+            const auto v = Combine(du16, InterleaveUpper(dh16, vh, vh), InterleaveLower(dh16, vh, vh));
+
+            VF rl, gl, bl, ru, gu, bu;
+            Yuv10ToRGB<Transfer>(df, ConvertTo(df, PromoteLowerTo(di32, y)), ConvertTo(df, PromoteLowerTo(di32, u)),
+                                 ConvertTo(df, PromoteLowerTo(di32, v)), coefficients, transferTable, rl, gl, bl);
+            Yuv10ToRGB<Transfer>(df, ConvertTo(df, PromoteUpperTo(di32, y)), ConvertTo(df, PromoteUpperTo(di32, u)),
+                                 ConvertTo(df, PromoteUpperTo(di32, v)), coefficients, transferTable, ru, gu, bu);
+
+            if constexpr (Storage == PIXEL_RGBA_F16) {
+                const auto zeros = Zero(df);
+                const auto vMax = Set(df, maxValue);
+                auto toHalf = [&](VF lower, VF upper) {
+                    return Combine(du16, BitCast(dh16, DemoteTo(dhf, Clamp(upper, zeros, vMax))),
+                                   BitCast(dh16, DemoteTo(dhf, Clamp(lower, zeros, vMax))));
+                };
+                StoreInterleaved4(toHalf(rl, ru), toHalf(gl, gu), toHalf(bl, bu), Set(du16, 0x3C00), du16,
+                                  reinterpret_cast<uint16_t *>(store));
+            } else {
+                const auto ones = Set(df, 1.f);
+                StorePixels<Storage>(df, store, rl, gl, bl, ones);
+                StorePixels<Storage>(df, store + floatLanes * pixelSize, ru, gu, bu, ones);
+            }
+        };
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const int chromaY = y / 2;
+            auto yRow = reinterpret_cast<const uint16_t *>(yPlane + static_cast<size_t>(y) * yStride);
+            auto uRow = reinterpret_cast<const uint16_t *>(uPlane + static_cast<size_t>(chromaY) * uStride);
+            auto vRow = Interleaved ? nullptr
+                                    : reinterpret_cast<const uint16_t *>(vPlane + static_cast<size_t>(chromaY) * vStride);
+            uint8_t *dstRow = dst + static_cast<size_t>(y) * dstStride;
+
+            // Interleaved chroma holds two samples per pair of pixels
+            auto chromaOffset = [](const int x) { return Interleaved ? x : x / 2; };
+
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                convert(yRow + x, uRow + chromaOffset(x), Interleaved ? nullptr : vRow + chromaOffset(x),
+                        dstRow + x * pixelSize);
+            }
+
+            if (x < width) {
+                const int remaining = width - x;
+                const int chromaRemaining = Interleaved ? (remaining + 1) / 2 * 2 : (remaining + 1) / 2;
+                HWY_ALIGN uint16_t yTail[HWY_MAX_LANES_D(decltype(du16))] = {};
+                HWY_ALIGN uint16_t uTail[HWY_MAX_LANES_D(decltype(du16))] = {};
+                HWY_ALIGN uint16_t vTail[HWY_MAX_LANES_D(decltype(du16))] = {};
+                HWY_ALIGN uint8_t dstTail[HWY_MAX_LANES_D(decltype(du16)) * pixelSize];
+                std::copy(yRow + x, yRow + width, yTail);
+                std::copy(uRow + chromaOffset(x), uRow + chromaOffset(x) + chromaRemaining, uTail);
+                if (!Interleaved) {
+                    std::copy(vRow + chromaOffset(x), vRow + chromaOffset(x) + chromaRemaining, vTail);
+                }
+                convert(yTail, uTail, vTail, dstTail);
+                std::copy(dstTail, dstTail + remaining * pixelSize, dstRow + x * pixelSize);
+            }
+        });
+    }
+
+    void Yuv10ToRGBAHWY(const bool interleaved, const PixelStorage storage, const YuvTransfer transfer,
+                        uint8_t *dst, const int dstStride, const int width, const int height,
+                        const uint8_t *ySrc, const int yStride, const uint8_t *uSrc, const int uStride,
+                        const uint8_t *vSrc, const int vStride, const float fixedCoefficients[6]) {
+        const Yuv10Coefficients coefficients = {fixedCoefficients[0], fixedCoefficients[1], fixedCoefficients[2],
+                                                fixedCoefficients[3], fixedCoefficients[4], fixedCoefficients[5]};
+        std::vector<float> transferTable;
+        if (transfer != YUV_TRANSFER_NONE) {
+            transferTable.resize(kTransferTableSize + 1);
+            for (int i = 0; i <= kTransferTableSize; ++i) {
+                const float value = static_cast<float>(i) / static_cast<float>(kTransferTableSize);
+                transferTable[i] = transfer == YUV_TRANSFER_PQ ? ToLinearPQ(value, 203.f) : HLGEotf(value);
+            }
+        }
+        auto run = [&](auto storageTag, auto transferTag) {
+            constexpr PixelStorage Storage = decltype(storageTag)::value;
+            constexpr YuvTransfer Transfer = decltype(transferTag)::value;
+            if (interleaved) {
+                Yuv10ToRGBAImpl<true, Storage, Transfer>(dst, dstStride, width, height, ySrc, yStride,
+                                                         uSrc, uStride, vSrc, vStride, coefficients,
+                                                         transferTable.data());
+            } else {
+                Yuv10ToRGBAImpl<false, Storage, Transfer>(dst, dstStride, width, height, ySrc, yStride,
+                                                          uSrc, uStride, vSrc, vStride, coefficients,
+                                                          transferTable.data());
+            }
+        };
+        auto runTransfer = [&](auto storageTag) {
+            switch (transfer) {
+                case YUV_TRANSFER_PQ:
+                    run(storageTag, std::integral_constant<YuvTransfer, YUV_TRANSFER_PQ>());
+                    break;
+                case YUV_TRANSFER_HLG:
+                    run(storageTag, std::integral_constant<YuvTransfer, YUV_TRANSFER_HLG>());
+                    break;
+                default:
+                    run(storageTag, std::integral_constant<YuvTransfer, YUV_TRANSFER_NONE>());
+                    break;
+            }
+        };
+        if (storage == PIXEL_RGBA_F16) {
+            runTransfer(std::integral_constant<PixelStorage, PIXEL_RGBA_F16>());
+        } else {
+            runTransfer(std::integral_constant<PixelStorage, PIXEL_RGBA1010102>());
+        }
+    }
+}
+
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(Yuv10ToRGBAHWY);
+
+    // Luma scale, luma bias, Cr to R, Cb to B, Cr to G and Cb to G for 10 bit samples
+    static void yuv10Coefficients(const YuvMatrix matrix, const YuvRange range, float coefficients[6]) {
+        float kr = 0.2627f, kb = 0.0593f;
+        if (matrix == YUV_MATRIX_BT601) {
+            kr = 0.299f;
+            kb = 0.114f;
+        } else if (matrix == YUV_MATRIX_BT709) {
+            kr = 0.2126f;
+            kb = 0.0722f;
+        }
+        const float kg = 1.f - kr - kb;
+        const bool full = range == YUV_RANGE_FULL;
+        const float lumaScale = full ? 1.f / 1023.f : 1.f / 876.f;
+        const float chromaScale = full ? 1.f / 1023.f : 1.f / 896.f;
+        coefficients[0] = lumaScale;
+        coefficients[1] = full ? 0.f : 64.f * lumaScale;
+        coefficients[2] = 2.f * (1.f - kr) * chromaScale;
+        coefficients[3] = 2.f * (1.f - kb) * chromaScale;
+        coefficients[4] = 2.f * (1.f - kr) * kr / kg * chromaScale;
+        coefficients[5] = 2.f * (1.f - kb) * kb / kg * chromaScale;
+    }
+
+    static void yuv10ToRGBA(const bool interleaved, const PixelStorage storage, uint8_t *dst, int dstStride,
+                            int width, int height, const uint16_t *ySrc, int yStride,
+                            const uint16_t *uSrc, int uStride, const uint16_t *vSrc, int vStride,
+                            YuvMatrix matrix, YuvRange range, YuvTransfer transfer) {
+        if (width <= 0 || height <= 0) {
+            std::string msg = "Invalid YUV image size";
+            throw AireError(msg);
+        }
+        float coefficients[6];
+        yuv10Coefficients(matrix, range, coefficients);
+        HWY_DYNAMIC_DISPATCH(Yuv10ToRGBAHWY)(interleaved, storage, transfer, dst, dstStride, width, height,
+                                             reinterpret_cast<const uint8_t *>(ySrc), yStride,
+                                             reinterpret_cast<const uint8_t *>(uSrc), uStride,
+                                             reinterpret_cast<const uint8_t *>(vSrc), vStride, coefficients);
+    }
+
+    void P010ToRGBA1010102(uint8_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                           const uint16_t *uv, int uvStride, YuvMatrix matrix, YuvRange range, YuvTransfer transfer) {
+        yuv10ToRGBA(true, PIXEL_RGBA1010102, dst, dstStride, width, height, ySrc, yStride, uv, uvStride,
+                    nullptr, 0, matrix, range, transfer);
+    }
+
+    void P010ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                       const uint16_t *uv, int uvStride, YuvMatrix matrix, YuvRange range, YuvTransfer transfer) {
+        yuv10ToRGBA(true, PIXEL_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                    uv, uvStride, nullptr, 0, matrix, range, transfer);
+    }
+
+    void I010ToRGBA1010102(uint8_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                           const uint16_t *uSrc, int uStride, const uint16_t *vSrc, int vStride,
+                           YuvMatrix matrix, YuvRange range, YuvTransfer transfer) {
+        yuv10ToRGBA(false, PIXEL_RGBA1010102, dst, dstStride, width, height, ySrc, yStride, uSrc, uStride,
+                    vSrc, vStride, matrix, range, transfer);
+    }
+
+    void I010ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                       const uint16_t *uSrc, int uStride, const uint16_t *vSrc, int vStride,
+                       YuvMatrix matrix, YuvRange range, YuvTransfer transfer) {
+        yuv10ToRGBA(false, PIXEL_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                    uSrc, uStride, vSrc, vStride, matrix, range, transfer);
+    }
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "YuvConverter.h"
+
+namespace aire {
+
+    enum YuvTransfer {
+        // Values are kept as they are encoded
+        YUV_TRANSFER_NONE = 0,
+        // SMPTE ST 2084, 203 nits of reference white are mapped to 1
+        YUV_TRANSFER_PQ = 1,
+        // ARIB STD-B67 inverse OETF, scene linear light in [0, 1]
+        YUV_TRANSFER_HLG = 2
+    };
+
+    /**
+     * 10 bit YUV 4:2:0 to RGBA1010102 or RGBA F16, alpha is opaque.
+     * P010 keeps samples in the high bits of 16 bit words with interleaved UV, I010 keeps them in the low bits
+     * of three planes. Strides are in bytes. RGBA1010102 is clamped to [0, 1], F16 keeps linearized values
+     * above 1
+     */
+    void P010ToRGBA1010102(uint8_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                           const uint16_t *uv, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT2020,
+                           YuvRange range = YUV_RANGE_LIMITED, YuvTransfer transfer = YUV_TRANSFER_NONE);
+
+    void P010ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                       const uint16_t *uv, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT2020,
+                       YuvRange range = YUV_RANGE_LIMITED, YuvTransfer transfer = YUV_TRANSFER_NONE);
+
+    void I010ToRGBA1010102(uint8_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                           const uint16_t *uSrc, int uStride, const uint16_t *vSrc, int vStride,
+                           YuvMatrix matrix = YUV_MATRIX_BT2020, YuvRange range = YUV_RANGE_LIMITED,
+                           YuvTransfer transfer = YUV_TRANSFER_NONE);
+
+    void I010ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint16_t *ySrc, int yStride,
+                       const uint16_t *uSrc, int uStride, const uint16_t *vSrc, int vStride,
+                       YuvMatrix matrix = YUV_MATRIX_BT2020, YuvRange range = YUV_RANGE_LIMITED,
+                       YuvTransfer transfer = YUV_TRANSFER_NONE);
+}
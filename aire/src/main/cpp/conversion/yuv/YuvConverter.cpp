@@ -40,7 +40,7 @@ using namespace std;
 
 #include "hwy/foreach_target.h"
 #include "hwy/highway.h"
-#include "NV21-inl.h"
+#include "jni/JNIUtils.h"
 
 HWY_BEFORE_NAMESPACE();
 
@@ -49,19 +49,212 @@ namespace aire::HWY_NAMESPACE {
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
-    void NV21ToRGBAHWYInterop(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc,
-                              int yStride, const uint8_t *uv, int uvStride) {
-        sparkyuv::HWY_NAMESPACE::NV21ToRGBAHWY(dst, dstStride, width, height, ySrc, yStride, uv, uvStride);
+    // Q6 coefficients, luma is expanded by MulHigh of Y * 0x0101 so limited range keeps full precision
+    struct YuvCoefficients {
+        int16_t lumaScale;
+        int16_t lumaBias;
+        int16_t crR;
+        int16_t cbB;
+        int16_t crG;
+        int16_t cbG;
+    };
+
+    /**
+     * Converts Lanes(di16) pixels, chroma points to the first chroma sample of the run,
+     * for NV layouts u is the interleaved plane. Result is R, G, B in Q6
+     */
+    template<YuvLayout Layout, class D, typename V = Vec<D>>
+    HWY_INLINE void YuvLoadRGB(const D di16, const uint8_t *ySrc, const uint8_t *uSrc, const uint8_t *vSrc,
+                               const YuvCoefficients &c, V &r, V &g, V &b) {
+        const Rebind<uint8_t, decltype(di16)> du8;
+        const RebindToUnsigned<decltype(di16)> du16;
+        const Half<decltype(di16)> dh16;
+        const Rebind<uint8_t, decltype(dh16)> du8h;
+
+        const auto yu = Mul(PromoteTo(du16, LoadU(du8, ySrc)), Set(du16, 0x0101));
+        const auto luma = Sub(BitCast(di16, MulHigh(yu, Set(du16, static_cast<uint16_t>(c.lumaScale)))),
+                              Set(di16, c.lumaBias));
+
+        V cb, cr;
+        const auto vBias = Set(di16, 128);
+        if constexpr (Layout == YUV_LAYOUT_I444) {
+            cb = Sub(BitCast(di16, PromoteTo(du16, LoadU(du8, uSrc))), vBias);
+            cr = Sub(BitCast(di16, PromoteTo(du16, LoadU(du8, vSrc))), vBias);
+        } else {
+            Vec<decltype(du8h)> uh, vh;
+            if constexpr (Layout == YUV_LAYOUT_NV12) {
+                LoadInterleaved2(du8h, uSrc, uh, vh);
+            } else if constexpr (Layout == YUV_LAYOUT_NV21) {
+                LoadInterleaved2(du8h, uSrc, vh, uh);
+            } else {
+                uh = LoadU(du8h, uSrc);
+                vh = LoadU(du8h, vSrc);
+            }
+            const auto u16 = BitCast(dh16, PromoteTo(RebindToUnsigned<decltype(dh16)>(), uh));
+            const auto v16 = BitCast(dh16, PromoteTo(RebindToUnsigned<decltype(dh16)>(), vh));
+            cb = Sub(Combine(di16, InterleaveUpper(dh16, u16, u16), InterleaveLower(dh16, u16, u16)), vBias);
+            cr = Sub(Combine(di16, InterleaveUpper(dh16, v16, v16), InterleaveLower(dh16, v16, v16)), vBias);
+        }
+
+        r = SaturatedAdd(luma, Mul(cr, Set(di16, c.crR)));
+        b = SaturatedAdd(luma, Mul(cb, Set(di16, c.cbB)));
+        g = SaturatedSub(SaturatedSub(luma, Mul(cr, Set(di16, c.crG))), Mul(cb, Set(di16, c.cbG)));
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void YuvStoreRGBA8(const D di16, uint8_t *dst, V r, V g, V b) {
+        const Rebind<uint8_t, decltype(di16)> du8;
+        const auto rounding = Set(di16, 32);
+        StoreInterleaved4(DemoteTo(du8, ShiftRight<6>(SaturatedAdd(r, rounding))),
+                          DemoteTo(du8, ShiftRight<6>(SaturatedAdd(g, rounding))),
+                          DemoteTo(du8, ShiftRight<6>(SaturatedAdd(b, rounding))),
+                          Set(du8, 255), du8, dst);
+    }
+
+    template<bool Reversed, class D, typename V = Vec<D>>
+    HWY_INLINE void YuvStoreRGB8(const D di16, uint8_t *dst, V r, V g, V b) {
+        const Rebind<uint8_t, decltype(di16)> du8;
+        const auto rounding = Set(di16, 32);
+        const auto ru = DemoteTo(du8, ShiftRight<6>(SaturatedAdd(r, rounding)));
+        const auto gu = DemoteTo(du8, ShiftRight<6>(SaturatedAdd(g, rounding)));
+        const auto bu = DemoteTo(du8, ShiftRight<6>(SaturatedAdd(b, rounding)));
+        if constexpr (Reversed) {
+            StoreInterleaved3(bu, gu, ru, du8, dst);
+        } else {
+            StoreInterleaved3(ru, gu, bu, du8, dst);
+        }
+    }
+
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE Vec<RebindToUnsigned<D>> YuvToHalfFloats(const D di16, V v) {
+        const RebindToUnsigned<decltype(di16)> du16;
+        const Half<decltype(du16)> duh;
+        const Rebind<int32_t, decltype(duh)> di32;
+        const Rebind<float, decltype(duh)> df;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        const auto scale = Set(df, 1.f / (255.f * 64.f));
+        const auto zeros = Zero(df);
+        const auto ones = Set(df, 1.f);
+        const auto lower = Clamp(Mul(ConvertTo(df, PromoteLowerTo(di32, v)), scale), zeros, ones);
+        const auto upper = Clamp(Mul(ConvertTo(df, PromoteUpperTo(di32, v)), scale), zeros, ones);
+        return Combine(du16, BitCast(duh, DemoteTo(dh, upper)), BitCast(duh, DemoteTo(dh, lower)));
     }
 
-    void NV21ToRGBHWYInterop(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc,
-                             int yStride, const uint8_t *uv, int uvStride) {
-        sparkyuv::HWY_NAMESPACE::NV21ToRGBHWY(dst, dstStride, width, height, ySrc, yStride, uv, uvStride);
+    template<class D, typename V = Vec<D>>
+    HWY_INLINE void YuvStoreRGBAF16(const D di16, uint8_t *dst, V r, V g, V b) {
+        const RebindToUnsigned<decltype(di16)> du16;
+        StoreInterleaved4(YuvToHalfFloats(di16, r), YuvToHalfFloats(di16, g), YuvToHalfFloats(di16, b),
+                          Set(du16, 0x3C00), du16, reinterpret_cast<uint16_t *>(dst));
     }
 
-    void NV21ToBGRHWYInterop(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc,
-                             int yStride, const uint8_t *uv, int uvStride) {
-        sparkyuv::HWY_NAMESPACE::NV21ToBGRHWY(dst, dstStride, width, height, ySrc, yStride, uv, uvStride);
+    template<YuvLayout Layout, YuvTarget Target>
+    void YuvToRGBAImpl(uint8_t *dst, const int dstStride, const int width, const int height,
+                       const uint8_t *yPlane, const int yStride,
+                       const uint8_t *uPlane, const int uStride, const uint8_t *vPlane, const int vStride,
+                       const YuvCoefficients &coefficients) {
+        const ScalableTag<int16_t> di16;
+        using V = Vec<decltype(di16)>;
+        const int lanes = static_cast<int>(Lanes(di16));
+        constexpr int pixelSize = Target == YUV_TARGET_RGBA_F16 ? 8 : (Target == YUV_TARGET_RGBA8888 ? 4 : 3);
+        constexpr bool subsampledRows = Layout == YUV_LAYOUT_NV12 || Layout == YUV_LAYOUT_NV21 || Layout == YUV_LAYOUT_I420;
+        constexpr bool interleaved = Layout == YUV_LAYOUT_NV12 || Layout == YUV_LAYOUT_NV21;
+        // Offset of the chroma sample of pixel x in a chroma row, NV planes hold two bytes per sample
+        auto chromaOffset = [](const int x) {
+            return Layout == YUV_LAYOUT_I444 ? x : (interleaved ? x : x / 2);
+        };
+
+        auto convert = [&](const uint8_t *ySrc, const uint8_t *uSrc, const uint8_t *vSrc, uint8_t *store) {
+            V r, g, b;
+            YuvLoadRGB<Layout>(di16, ySrc, uSrc, vSrc, coefficients, r, g, b);
+            if constexpr (Target == YUV_TARGET_RGBA_F16) {
+                YuvStoreRGBAF16(di16, store, r, g, b);
+            } else if constexpr (Target == YUV_TARGET_RGBA8888) {
+                YuvStoreRGBA8(di16, store, r, g, b);
+            } else {
+                YuvStoreRGB8<Target == YUV_TARGET_BGR888>(di16, store, r, g, b);
+            }
+        };
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const int chromaY = subsampledRows ? y / 2 : y;
+            const uint8_t *yRow = yPlane + static_cast<size_t>(y) * yStride;
+            const uint8_t *uRow = uPlane + static_cast<size_t>(chromaY) * uStride;
+            const uint8_t *vRow = interleaved ? nullptr : vPlane + static_cast<size_t>(chromaY) * vStride;
+            uint8_t *dstRow = dst + static_cast<size_t>(y) * dstStride;
+
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                convert(yRow + x, uRow + chromaOffset(x), interleaved ? nullptr : vRow + chromaOffset(x),
+                        dstRow + x * pixelSize);
+            }
+
+            if (x < width) {
+                const int remaining = width - x;
+                const int chromaRemaining = Layout == YUV_LAYOUT_I444 ? remaining
+                                                                      : (interleaved ? (remaining + 1) / 2 * 2
+                                                                                     : (remaining + 1) / 2);
+                HWY_ALIGN uint8_t yTail[HWY_MAX_LANES_D(decltype(di16))] = {};
+                HWY_ALIGN uint8_t uTail[HWY_MAX_LANES_D(decltype(di16))] = {};
+                HWY_ALIGN uint8_t vTail[HWY_MAX_LANES_D(decltype(di16))] = {};
+                HWY_ALIGN uint8_t dstTail[HWY_MAX_LANES_D(decltype(di16)) * pixelSize];
+                std::copy(yRow + x, yRow + width, yTail);
+                std::copy(uRow + chromaOffset(x), uRow + chromaOffset(x) + chromaRemaining, uTail);
+                if (!interleaved) {
+                    std::copy(vRow + chromaOffset(x), vRow + chromaOffset(x) + chromaRemaining, vTail);
+                }
+                convert(yTail, uTail, vTail, dstTail);
+                std::copy(dstTail, dstTail + remaining * pixelSize, dstRow + x * pixelSize);
+            }
+        });
+    }
+
+    void YuvToRGBAHWY(const YuvLayout layout, const YuvTarget target, uint8_t *dst, const int dstStride,
+                      const int width, const int height, const uint8_t *ySrc, const int yStride,
+                      const uint8_t *uSrc, const int uStride, const uint8_t *vSrc, const int vStride,
+                      const int16_t fixedCoefficients[6]) {
+        const YuvCoefficients coefficients = {fixedCoefficients[0], fixedCoefficients[1], fixedCoefficients[2],
+                                              fixedCoefficients[3], fixedCoefficients[4], fixedCoefficients[5]};
+        auto run = [&](auto layoutTag) {
+            constexpr YuvLayout Layout = decltype(layoutTag)::value;
+            switch (target) {
+                case YUV_TARGET_RGBA8888:
+                    YuvToRGBAImpl<Layout, YUV_TARGET_RGBA8888>(dst, dstStride, width, height, ySrc, yStride,
+                                                               uSrc, uStride, vSrc, vStride, coefficients);
+                    break;
+                case YUV_TARGET_RGBA_F16:
+                    YuvToRGBAImpl<Layout, YUV_TARGET_RGBA_F16>(dst, dstStride, width, height, ySrc, yStride,
+                                                               uSrc, uStride, vSrc, vStride, coefficients);
+                    break;
+                case YUV_TARGET_RGB888:
+                    YuvToRGBAImpl<Layout, YUV_TARGET_RGB888>(dst, dstStride, width, height, ySrc, yStride,
+                                                             uSrc, uStride, vSrc, vStride, coefficients);
+                    break;
+                case YUV_TARGET_BGR888:
+                    YuvToRGBAImpl<Layout, YUV_TARGET_BGR888>(dst, dstStride, width, height, ySrc, yStride,
+                                                             uSrc, uStride, vSrc, vStride, coefficients);
+                    break;
+            }
+        };
+        switch (layout) {
+            case YUV_LAYOUT_NV12:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_NV12>());
+                break;
+            case YUV_LAYOUT_NV21:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_NV21>());
+                break;
+            case YUV_LAYOUT_I420:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_I420>());
+                break;
+            case YUV_LAYOUT_I422:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_I422>());
+                break;
+            case YUV_LAYOUT_I444:
+                run(std::integral_constant<YuvLayout, YUV_LAYOUT_I444>());
+                break;
+        }
     }
 }
 
@@ -69,26 +262,121 @@ HWY_AFTER_NAMESPACE();
 
 #if HWY_ONCE
 namespace aire {
-    HWY_EXPORT(NV21ToRGBAHWYInterop);
-    HWY_EXPORT(NV21ToRGBHWYInterop);
-    HWY_EXPORT(NV21ToBGRHWYInterop);
+    HWY_EXPORT(YuvToRGBAHWY);
+
+    // Luma scale, luma bias, Cr to R, Cb to B, Cr to G and Cb to G in Q6
+    static void yuvCoefficients(const YuvMatrix matrix, const YuvRange range, int16_t coefficients[6]) {
+        float kr = 0.299f, kb = 0.114f;
+        if (matrix == YUV_MATRIX_BT709) {
+            kr = 0.2126f;
+            kb = 0.0722f;
+        } else if (matrix == YUV_MATRIX_BT2020) {
+            kr = 0.2627f;
+            kb = 0.0593f;
+        }
+        const float kg = 1.f - kr - kb;
+        const bool full = range == YUV_RANGE_FULL;
+        const float lumaScale = full ? 1.f : 255.f / 219.f;
+        const float chromaScale = full ? 1.f : 255.f / 224.f;
+        const float q = 64.f;
+        const float values[6] = {
+                lumaScale * q * 65536.f / 257.f,
+                full ? 0.f : 16.f * lumaScale * q,
+                2.f * (1.f - kr) * chromaScale * q,
+                2.f * (1.f - kb) * chromaScale * q,
+                2.f * (1.f - kr) * kr / kg * chromaScale * q,
+                2.f * (1.f - kb) * kb / kg * chromaScale * q,
+        };
+        for (int i = 0; i < 6; ++i) {
+            coefficients[i] = static_cast<int16_t>(std::lround(values[i]));
+        }
+    }
+
+    static void yuvToRGBA(const YuvLayout layout, const YuvTarget target, uint8_t *dst, int dstStride, int width, int height,
+                          const uint8_t *ySrc, int yStride, const uint8_t *uSrc, int uStride,
+                          const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        if (width <= 0 || height <= 0) {
+            std::string msg = "Invalid YUV image size";
+            throw AireError(msg);
+        }
+        int16_t coefficients[6];
+        yuvCoefficients(matrix, range, coefficients);
+        HWY_DYNAMIC_DISPATCH(YuvToRGBAHWY)(layout, target, dst, dstStride, width, height, ySrc, yStride,
+                                           uSrc, uStride, vSrc, vStride, coefficients);
+    }
+
+    void NV12ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uv, int uvStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_NV12, YUV_TARGET_RGBA8888, dst, dstStride, width, height, ySrc, yStride, uv, uvStride, nullptr, 0,
+                  matrix, range);
+    }
+
+    void NV12ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uv, int uvStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_NV12, YUV_TARGET_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                  uv, uvStride, nullptr, 0, matrix, range);
+    }
+
+    void NV21ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uv, int uvStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_NV21, YUV_TARGET_RGBA8888, dst, dstStride, width, height, ySrc, yStride, uv, uvStride, nullptr, 0,
+                  matrix, range);
+    }
+
+    void NV21ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uv, int uvStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_NV21, YUV_TARGET_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                  uv, uvStride, nullptr, 0, matrix, range);
+    }
+
+    void I420ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_I420, YUV_TARGET_RGBA8888, dst, dstStride, width, height, ySrc, yStride, uSrc, uStride, vSrc, vStride,
+                  matrix, range);
+    }
+
+    void I420ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_I420, YUV_TARGET_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                  uSrc, uStride, vSrc, vStride, matrix, range);
+    }
+
+    void I422ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_I422, YUV_TARGET_RGBA8888, dst, dstStride, width, height, ySrc, yStride, uSrc, uStride, vSrc, vStride,
+                  matrix, range);
+    }
+
+    void I422ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_I422, YUV_TARGET_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                  uSrc, uStride, vSrc, vStride, matrix, range);
+    }
+
+    void I444ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_I444, YUV_TARGET_RGBA8888, dst, dstStride, width, height, ySrc, yStride, uSrc, uStride, vSrc, vStride,
+                  matrix, range);
+    }
 
-    HWY_DLLEXPORT void
-    NV21ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
-               const uint8_t *uv, int uvStride) {
-        HWY_DYNAMIC_DISPATCH(NV21ToRGBAHWYInterop)(dst, dstStride, width, height, ySrc, yStride, uv, uvStride);
+    void I444ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride, YuvMatrix matrix, YuvRange range) {
+        yuvToRGBA(YUV_LAYOUT_I444, YUV_TARGET_RGBA_F16, reinterpret_cast<uint8_t *>(dst), dstStride, width, height, ySrc, yStride,
+                  uSrc, uStride, vSrc, vStride, matrix, range);
     }
 
     void
     NV21ToRGB(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
               const uint8_t *uv, int uvStride) {
-        HWY_DYNAMIC_DISPATCH(NV21ToRGBHWYInterop)(dst, dstStride, width, height, ySrc, yStride, uv, uvStride);
+        yuvToRGBA(YUV_LAYOUT_NV21, YUV_TARGET_RGB888, dst, dstStride, width, height, ySrc, yStride, uv, uvStride,
+                  nullptr, 0, YUV_MATRIX_BT601, YUV_RANGE_LIMITED);
     }
 
     void
     NV21ToBGR(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
               const uint8_t *uv, int uvStride) {
-        HWY_DYNAMIC_DISPATCH(NV21ToBGRHWYInterop)(dst, dstStride, width, height, ySrc, yStride, uv, uvStride);
+        yuvToRGBA(YUV_LAYOUT_NV21, YUV_TARGET_BGR888, dst, dstStride, width, height, ySrc, yStride, uv, uvStride,
+                  nullptr, 0, YUV_MATRIX_BT601, YUV_RANGE_LIMITED);
     }
 }
 #endif
@@ -34,10 +34,81 @@
 #include <vector>
 
 namespace aire {
+
+    enum YuvMatrix {
+        YUV_MATRIX_BT601 = 0,
+        YUV_MATRIX_BT709 = 1,
+        YUV_MATRIX_BT2020 = 2
+    };
+
+    enum YuvRange {
+        YUV_RANGE_LIMITED = 0,
+        YUV_RANGE_FULL = 1
+    };
+
+    // NV12 and NV21 have interleaved chroma plane, UV and VU respectively
+    enum YuvLayout {
+        YUV_LAYOUT_NV12 = 0,
+        YUV_LAYOUT_NV21 = 1,
+        YUV_LAYOUT_I420 = 2,
+        YUV_LAYOUT_I422 = 3,
+        YUV_LAYOUT_I444 = 4
+    };
+
+    // Interleaved pixel written by the YUV kernel
+    enum YuvTarget {
+        YUV_TARGET_RGBA8888 = 0,
+        YUV_TARGET_RGBA_F16 = 1,
+        YUV_TARGET_RGB888 = 2,
+        YUV_TARGET_BGR888 = 3
+    };
+
+    /**
+     * 8 bit YUV to RGBA8888 or RGBA F16, any plane strides are accepted and alpha is opaque.
+     * Chroma of 4:2:0 and 4:2:2 is replicated to both pixels it covers
+     */
+    void NV12ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uv, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                    YuvRange range = YUV_RANGE_LIMITED);
+
+    void NV12ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uv, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                       YuvRange range = YUV_RANGE_LIMITED);
+
     void
     NV21ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
-               const uint8_t *uv, int uvStride);
+               const uint8_t *uv, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+               YuvRange range = YUV_RANGE_LIMITED);
+
+    void NV21ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uv, int uvStride, YuvMatrix matrix = YUV_MATRIX_BT601,
+                       YuvRange range = YUV_RANGE_LIMITED);
+
+    void I420ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride,
+                    YuvMatrix matrix = YUV_MATRIX_BT601, YuvRange range = YUV_RANGE_LIMITED);
+
+    void I420ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride,
+                       YuvMatrix matrix = YUV_MATRIX_BT601, YuvRange range = YUV_RANGE_LIMITED);
+
+    void I422ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride,
+                    YuvMatrix matrix = YUV_MATRIX_BT601, YuvRange range = YUV_RANGE_LIMITED);
+
+    void I422ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride,
+                       YuvMatrix matrix = YUV_MATRIX_BT601, YuvRange range = YUV_RANGE_LIMITED);
+
+    void I444ToRGBA(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                    const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride,
+                    YuvMatrix matrix = YUV_MATRIX_BT601, YuvRange range = YUV_RANGE_LIMITED);
+
+    void I444ToRGBAF16(uint16_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
+                       const uint8_t *uSrc, int uStride, const uint8_t *vSrc, int vStride,
+                       YuvMatrix matrix = YUV_MATRIX_BT601, YuvRange range = YUV_RANGE_LIMITED);
 
+    // BT.601 limited range NV21 to packed 3 channel pixels
     void
     NV21ToRGB(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
               const uint8_t *uv, int uvStride);
@@ -45,4 +116,4 @@ namespace aire {
     void
     NV21ToBGR(uint8_t *dst, int dstStride, int width, int height, const uint8_t *ySrc, int yStride,
               const uint8_t *uv, int uvStride);
-}
\ No newline at end of file
+}
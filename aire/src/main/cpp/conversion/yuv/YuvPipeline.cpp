@@ -0,0 +1,361 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "YuvPipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "concurrency.hpp"
+#include "base/Clahe.h"
+#include "base/LUT8.h"
+
+using namespace std;
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "YuvPipeline.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "jni/JNIUtils.h"
+
+HWY_BEFORE_NAMESPACE();
+
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    /**
+     * Rows are taken from padded plane, each of them has one replicated pixel on both sides,
+     * so x of the output reads x, x + 1 and x + 2 of the padded row
+     */
+    template<class D, class Function>
+    HWY_INLINE void YuvNeighbourhoodRow(const D d, uint8_t *dst, const int width, Function &&function) {
+        const int lanes = static_cast<int>(Lanes(d));
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            function(x, dst + x);
+        }
+        if (x < width) {
+            HWY_ALIGN uint8_t tail[HWY_MAX_LANES_D(D)];
+            function(x, tail);
+            std::copy(tail, tail + width - x, dst + x);
+        }
+    }
+
+    // Unsharp mask with 3x3 gaussian, amount is Q10
+    void YuvSharpenRow(const uint8_t *top, const uint8_t *middle, const uint8_t *bottom, uint8_t *dst,
+                       const int width, const int16_t amount, const uint8_t low, const uint8_t high) {
+        const ScalableTag<int16_t> di16;
+        const RebindToUnsigned<decltype(di16)> du16;
+        const Rebind<uint8_t, decltype(di16)> du8;
+        auto load = [&](const uint8_t *src) {
+            return BitCast(di16, PromoteTo(du16, LoadU(du8, src)));
+        };
+        auto tap = [&](const uint8_t *src) {
+            return Add(Add(load(src), load(src + 2)), ShiftLeft<1>(load(src + 1)));
+        };
+        const auto vAmount = Set(di16, amount);
+        const auto vLow = Set(di16, low);
+        const auto vHigh = Set(di16, high);
+        const auto rounding = Set(di16, 8);
+        const auto ones = Set(di16, 1);
+
+        YuvNeighbourhoodRow(di16, dst, width, [&](const int x, uint8_t *store) {
+            const auto center = load(middle + x + 1);
+            const auto blur = ShiftRight<4>(Add(Add(Add(tap(top + x), tap(bottom + x)),
+                                                    ShiftLeft<1>(tap(middle + x))), rounding));
+            const auto boost = ShiftRight<1>(Add(MulHigh(ShiftLeft<7>(Sub(center, blur)), vAmount), ones));
+            StoreU(DemoteTo(du8, Clamp(Add(center, boost), vLow, vHigh)), du8, store);
+        });
+    }
+
+    // Sigma filter, neighbours are weighted by how close they are to the center within threshold
+    void YuvDenoiseRow(const uint8_t *top, const uint8_t *middle, const uint8_t *bottom, uint8_t *dst,
+                       const int width, const float threshold) {
+        const ScalableTag<float> df;
+        const RebindToSigned<decltype(df)> di32;
+        const Rebind<uint8_t, decltype(df)> du8;
+        auto load = [&](const uint8_t *src) {
+            return ConvertTo(df, PromoteTo(di32, LoadU(du8, src)));
+        };
+        const auto vThreshold = Set(df, threshold);
+        const auto zeros = Zero(df);
+        const uint8_t *rows[3] = {top, middle, bottom};
+
+        YuvNeighbourhoodRow(df, dst, width, [&](const int x, uint8_t *store) {
+            const auto center = load(middle + x + 1);
+            auto weights = vThreshold;
+            auto sum = Mul(center, vThreshold);
+            for (int row = 0; row < 3; ++row) {
+                for (int column = 0; column < 3; ++column) {
+                    if (row == 1 && column == 1) {
+                        continue;
+                    }
+                    const auto neighbour = load(rows[row] + x + column);
+                    const auto weight = Max(Sub(vThreshold, AbsDiff(neighbour, center)), zeros);
+                    weights = Add(weights, weight);
+                    sum = MulAdd(weight, neighbour, sum);
+                }
+            }
+            StoreU(DemoteTo(du8, NearestInt(Div(sum, weights))), du8, store);
+        });
+    }
+
+    // Interleaved chroma pairs are multiplied by Q10 2x2 matrix around 128
+    void YuvChromaRow(uint8_t *chroma, const int pairs, const int16_t matrix[4], const uint8_t low,
+                      const uint8_t high) {
+        const ScalableTag<int16_t> di16;
+        const RebindToUnsigned<decltype(di16)> du16;
+        const Rebind<uint8_t, decltype(di16)> du8;
+        const int lanes = static_cast<int>(Lanes(di16));
+        const auto center = Set(di16, 128);
+        const auto m0 = Set(di16, matrix[0]);
+        const auto m1 = Set(di16, matrix[1]);
+        const auto m2 = Set(di16, matrix[2]);
+        const auto m3 = Set(di16, matrix[3]);
+        const auto vLow = Set(di16, low);
+        const auto vHigh = Set(di16, high);
+        const auto rounding = Set(di16, 2);
+
+        auto run = [&](const uint8_t *src, uint8_t *store) {
+            Vec<decltype(du8)> first8, second8;
+            LoadInterleaved2(du8, src, first8, second8);
+            const auto first = ShiftLeft<8>(Sub(BitCast(di16, PromoteTo(du16, first8)), center));
+            const auto second = ShiftLeft<8>(Sub(BitCast(di16, PromoteTo(du16, second8)), center));
+            // MulHigh of value << 8 by Q10 gives Q2
+            auto toChroma = [&](auto a, auto b) {
+                const auto q2 = SaturatedAdd(SaturatedAdd(MulHigh(first, a), MulHigh(second, b)), rounding);
+                return DemoteTo(du8, Clamp(Add(ShiftRight<2>(q2), center), vLow, vHigh));
+            };
+            StoreInterleaved2(toChroma(m0, m1), toChroma(m2, m3), du8, store);
+        };
+
+        int x = 0;
+        for (; x + lanes <= pairs; x += lanes) {
+            run(chroma + x * 2, chroma + x * 2);
+        }
+        if (x < pairs) {
+            HWY_ALIGN uint8_t tail[HWY_MAX_LANES_D(decltype(di16)) * 2] = {};
+            const int remaining = (pairs - x) * 2;
+            std::copy(chroma + x * 2, chroma + x * 2 + remaining, tail);
+            run(tail, tail);
+            std::copy(tail, tail + remaining, chroma + x * 2);
+        }
+    }
+}
+
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(YuvSharpenRow);
+    HWY_EXPORT(YuvDenoiseRow);
+    HWY_EXPORT(YuvChromaRow);
+
+    static int yuvThreadCount(const int width, const int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   height * width / (256 * 256)), 1, 12);
+    }
+
+    // Copy with one replicated pixel on both sides and room for a vector read past the end
+    static std::vector<uint8_t> yuvPaddedPlane(const uint8_t *plane, const int stride, const int width,
+                                               const int height, int &paddedStride) {
+        paddedStride = width + 2 + HWY_MAX_BYTES;
+        std::vector<uint8_t> padded(static_cast<size_t>(paddedStride) * height);
+        concurrency::parallel_for(yuvThreadCount(width, height), height, [&](int y) {
+            const uint8_t *src = plane + static_cast<size_t>(y) * stride;
+            uint8_t *dst = padded.data() + static_cast<size_t>(y) * paddedStride;
+            dst[0] = src[0];
+            std::copy(src, src + width, dst + 1);
+            std::fill(dst + width + 1, dst + paddedStride, src[width - 1]);
+        });
+        return padded;
+    }
+
+    template<class RowFunction>
+    static void yuvNeighbourhood(uint8_t *plane, const int stride, const int width, const int height,
+                                 RowFunction &&function) {
+        int paddedStride;
+        const std::vector<uint8_t> padded = yuvPaddedPlane(plane, stride, width, height, paddedStride);
+        concurrency::parallel_for(yuvThreadCount(width, height), height, [&](int y) {
+            const uint8_t *top = padded.data() + static_cast<size_t>(std::max(y - 1, 0)) * paddedStride;
+            const uint8_t *middle = padded.data() + static_cast<size_t>(y) * paddedStride;
+            const uint8_t *bottom = padded.data() + static_cast<size_t>(std::min(y + 1, height - 1)) * paddedStride;
+            function(top, middle, bottom, plane + static_cast<size_t>(y) * stride);
+        });
+    }
+
+    static void yuvApplyCurve(uint8_t *plane, const int stride, const int width, const int height,
+                              const float curve[256], const uint8_t low, const uint8_t high) {
+        uint8_t table[256];
+        for (int i = 0; i < 256; ++i) {
+            table[i] = static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround(curve[i])),
+                                                       static_cast<int>(low), static_cast<int>(high)));
+        }
+        LUT8(table).applyPlane(plane, stride, width, height);
+    }
+
+    void yuvChain(uint8_t *yPlane, int yStride, uint8_t *uvPlane, int uvStride, int width, int height,
+                  YuvLayout layout, YuvRange range, const std::vector<YuvOp> &ops) {
+        if (width <= 0 || height <= 0) {
+            std::string msg = "Invalid YUV image size";
+            throw AireError(msg);
+        }
+        if (layout != YUV_LAYOUT_NV12 && layout != YUV_LAYOUT_NV21) {
+            std::string msg = "Only NV12 and NV21 frames are supported";
+            throw AireError(msg);
+        }
+
+        const bool full = range == YUV_RANGE_FULL;
+        const uint8_t lumaLow = full ? 0 : 16;
+        const uint8_t lumaHigh = full ? 255 : 235;
+        const uint8_t chromaLow = full ? 0 : 16;
+        const uint8_t chromaHigh = full ? 255 : 240;
+        const float lumaScale = static_cast<float>(lumaHigh - lumaLow);
+
+        // Curves are composed in floats and quantized once before the next spatial op
+        float curve[256];
+        bool hasCurve = false;
+        auto resetCurve = [&]() {
+            for (int i = 0; i < 256; ++i) {
+                curve[i] = static_cast<float>(i);
+            }
+            hasCurve = false;
+        };
+        auto flushCurve = [&]() {
+            if (hasCurve) {
+                yuvApplyCurve(yPlane, yStride, width, height, curve, lumaLow, lumaHigh);
+            }
+            resetCurve();
+        };
+        resetCurve();
+
+        // Row major 2x2 over Cb and Cr
+        float chroma[4] = {1.f, 0.f, 0.f, 1.f};
+        bool hasChroma = false;
+        auto multiplyChroma = [&](const float m00, const float m01, const float m10, const float m11) {
+            const float result[4] = {
+                    m00 * chroma[0] + m01 * chroma[2], m00 * chroma[1] + m01 * chroma[3],
+                    m10 * chroma[0] + m11 * chroma[2], m10 * chroma[1] + m11 * chroma[3],
+            };
+            std::copy(result, result + 4, chroma);
+            hasChroma = true;
+        };
+
+        for (const YuvOp &op: ops) {
+            const float *p = op.params;
+            switch (op.type) {
+                case YUV_OP_CONTRAST:
+                case YUV_OP_BRIGHTNESS:
+                case YUV_OP_GAMMA:
+                    for (float &value: curve) {
+                        float normalized = std::clamp((value - lumaLow) / lumaScale, 0.f, 1.f);
+                        if (op.type == YUV_OP_CONTRAST) {
+                            normalized = (normalized - 0.5f) * p[0] + 0.5f;
+                        } else if (op.type == YUV_OP_BRIGHTNESS) {
+                            normalized += p[0];
+                        } else {
+                            normalized = std::pow(normalized, p[0]);
+                        }
+                        value = normalized * lumaScale + lumaLow;
+                    }
+                    hasCurve = true;
+                    break;
+                case YUV_OP_SHARPEN: {
+                    flushCurve();
+                    const auto amount = static_cast<int16_t>(std::lround(std::clamp(p[0], 0.f, 31.f) * 1024.f));
+                    yuvNeighbourhood(yPlane, yStride, width, height,
+                                     [&](const uint8_t *top, const uint8_t *middle, const uint8_t *bottom,
+                                         uint8_t *dst) {
+                                         HWY_DYNAMIC_DISPATCH(YuvSharpenRow)(top, middle, bottom, dst, width,
+                                                                             amount, lumaLow, lumaHigh);
+                                     });
+                }
+                    break;
+                case YUV_OP_DENOISE: {
+                    flushCurve();
+                    if (p[0] <= 0) {
+                        break;
+                    }
+                    const float threshold = p[0];
+                    yuvNeighbourhood(yPlane, yStride, width, height,
+                                     [&](const uint8_t *top, const uint8_t *middle, const uint8_t *bottom,
+                                         uint8_t *dst) {
+                                         HWY_DYNAMIC_DISPATCH(YuvDenoiseRow)(top, middle, bottom, dst, width,
+                                                                             threshold);
+                                     });
+                }
+                    break;
+                case YUV_OP_CLAHE:
+                    flushCurve();
+                    clahePlane(yPlane, yStride, width, height, p[0], static_cast<int>(p[1]),
+                               static_cast<int>(p[2]), lumaLow, lumaHigh);
+                    break;
+                case YUV_OP_SATURATION:
+                    multiplyChroma(p[0], 0.f, 0.f, p[0]);
+                    break;
+                case YUV_OP_HUE: {
+                    const float radians = p[0] * static_cast<float>(M_PI) / 180.f;
+                    const float cosine = std::cos(radians);
+                    const float sine = std::sin(radians);
+                    multiplyChroma(cosine, -sine, sine, cosine);
+                }
+                    break;
+                case YUV_OP_CHROMA_MATRIX:
+                    multiplyChroma(p[0], p[1], p[2], p[3]);
+                    break;
+            }
+        }
+        flushCurve();
+
+        if (!hasChroma) {
+            return;
+        }
+        // NV21 holds Cr first, so the matrix is mirrored instead of swapping samples
+        const float ordered[4] = {
+                layout == YUV_LAYOUT_NV12 ? chroma[0] : chroma[3],
+                layout == YUV_LAYOUT_NV12 ? chroma[1] : chroma[2],
+                layout == YUV_LAYOUT_NV12 ? chroma[2] : chroma[1],
+                layout == YUV_LAYOUT_NV12 ? chroma[3] : chroma[0],
+        };
+        int16_t matrix[4];
+        for (int i = 0; i < 4; ++i) {
+            matrix[i] = static_cast<int16_t>(std::lround(std::clamp(ordered[i], -8.f, 8.f) * 1024.f));
+        }
+        const int chromaWidth = (width + 1) / 2;
+        const int chromaHeight = (height + 1) / 2;
+        concurrency::parallel_for(yuvThreadCount(chromaWidth, chromaHeight), chromaHeight, [&](int y) {
+            HWY_DYNAMIC_DISPATCH(YuvChromaRow)(uvPlane + static_cast<size_t>(y) * uvStride, chromaWidth, matrix,
+                                               chromaLow, chromaHigh);
+        });
+    }
+}
+#endif
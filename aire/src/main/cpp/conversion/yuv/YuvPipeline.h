@@ -0,0 +1,66 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "YuvConverter.h"
+
+namespace aire {
+
+    enum YuvOpType {
+        YUV_OP_CONTRAST = 0,
+        YUV_OP_BRIGHTNESS = 1,
+        YUV_OP_GAMMA = 2,
+        YUV_OP_SHARPEN = 3,
+        YUV_OP_DENOISE = 4,
+        YUV_OP_CLAHE = 5,
+        YUV_OP_SATURATION = 6,
+        YUV_OP_HUE = 7,
+        YUV_OP_CHROMA_MATRIX = 8
+    };
+
+    static constexpr int yuvOpMaxParams = 4;
+
+    // Clahe params are threshold, grid x and grid y, chroma matrix is row major 2x2 over Cb and Cr
+    struct YuvOp {
+        YuvOpType type;
+        float params[yuvOpMaxParams];
+    };
+
+    /**
+     * Runs ops in place on NV12 or NV21 frame without converting it to RGB.
+     * Luma ops go over Y plane in order, consecutive contrast, brightness and gamma are folded into one table.
+     * Chroma ops don't depend on luma, so all of them are folded into one matrix applied to the interleaved plane
+     */
+    void yuvChain(uint8_t *yPlane, int yStride, uint8_t *uvPlane, int uvStride, int width, int height,
+                  YuvLayout layout, YuvRange range, const std::vector<YuvOp> &ops);
+}
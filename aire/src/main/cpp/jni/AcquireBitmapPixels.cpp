@@ -95,237 +95,111 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
             throw AireError(msg);
         }
 
-        void *addr = nullptr;
-        if (AndroidBitmap_lockPixels(env, bitmap, &addr) != 0) {
-            std::string exc = "Cannot acquire bitmap pixels";
-            throw AireError(exc);
-        }
-
-        vector<uint8_t> rgbaPixels(info.stride * info.height);
-        std::copy(reinterpret_cast<uint8_t *>(addr), reinterpret_cast<uint8_t *>(addr) + info.stride * info.height, rgbaPixels.begin());
+        auto isAllowed = [&allowedFormats](const AcquirePixelFormat format) {
+            return std::find(allowedFormats.begin(), allowedFormats.end(), format) != allowedFormats.end();
+        };
 
-        if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
-            string exc = "Unlocking pixels has failed";
-            throw AireError(exc);
+        AcquirePixelFormat sourceFormat = APF_RGBA8888;
+        if (info.format == ANDROID_BITMAP_FORMAT_RGBA_F16) {
+            sourceFormat = APF_F16;
+        } else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_1010102) {
+            sourceFormat = APF_RGBA1010102;
+        } else if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
+            sourceFormat = APF_565;
         }
 
-        int imageStride = (int) info.stride;
-
-        auto isAllowed1010102Lambda = [](const AcquirePixelFormat &format) {
-            return format == APF_RGBA1010102;
-        };
-        auto sAllowed1010102Iterator = std::find_if(allowedFormats.begin(), allowedFormats.end(),
-                                                    isAllowed1010102Lambda);
-        auto is1010102Allowed = sAllowed1010102Iterator != allowedFormats.end();
+        // Native format first, then conversions in order of preference for each source format
+        AcquirePixelFormat usingFormat = sourceFormat;
+        if (!isAllowed(sourceFormat)) {
+            std::vector<AcquirePixelFormat> candidates;
+            switch (sourceFormat) {
+                case APF_F16:
+                    candidates = {APF_RGBA1010102, APF_RGBA8888, APF_565};
+                    break;
+                case APF_RGBA1010102:
+                case APF_565:
+                    candidates = {APF_F16, APF_RGBA1010102, APF_RGBA8888, APF_565};
+                    break;
+                default:
+                    candidates = {APF_F16, APF_RGBA1010102, APF_565};
+                    break;
+            }
+            auto candidate = std::find_if(candidates.begin(), candidates.end(), isAllowed);
+            if (candidate == candidates.end()) {
+                string ss = getPixelFormatName(sourceFormat);
+                string exc = "Unknown " + ss + " conversion path";
+                throw AireError(exc);
+            }
+            usingFormat = *candidate;
+        }
 
-        auto isAllowedF16Lambda = [](const AcquirePixelFormat &format) {
-            return format == APF_F16;
-        };
-        auto sAllowedF16Iterator = std::find_if(allowedFormats.begin(), allowedFormats.end(),
-                                                isAllowedF16Lambda);
-        auto isF16Allowed = sAllowedF16Iterator != allowedFormats.end();
+        const int width = (int) info.width;
+        const int height = (int) info.height;
+        const int pixelSize = getPixelSize(usingFormat);
+        const int components = getComponents(usingFormat);
+        int imageStride = width * components * pixelSize;
+        if (usingFormat == sourceFormat && allowsMemoryAlignment) {
+            imageStride = (int) info.stride;
+        }
 
-        auto isAllowed565Lambda = [](const AcquirePixelFormat &format) {
-            return format == APF_565;
-        };
-        auto sAllowed565Iterator = std::find_if(allowedFormats.begin(), allowedFormats.end(),
-                                                isAllowed565Lambda);
-        auto is565Allowed = sAllowed565Iterator != allowedFormats.end();
+        vector<uint8_t> rgbaPixels(imageStride * height);
 
-        auto isAllowed888Lambda = [](const AcquirePixelFormat &format) {
-            return format == APF_RGBA8888;
-        };
-        auto sAllowed888Iterator = std::find_if(allowedFormats.begin(), allowedFormats.end(),
-                                                isAllowed888Lambda);
-        auto is888Allowed = sAllowed888Iterator != allowedFormats.end();
+        void *addr = nullptr;
+        if (AndroidBitmap_lockPixels(env, bitmap, &addr) != 0) {
+            std::string exc = "Cannot acquire bitmap pixels";
+            throw AireError(exc);
+        }
 
-        AcquirePixelFormat usingFormat = APF_RGBA8888;
+        // Converters read locked pixels directly, so any source format is a single pass into working buffer
+        const auto source = reinterpret_cast<const uint8_t *>(addr);
+        const auto source16 = reinterpret_cast<const uint16_t *>(addr);
+        const int sourceStride = (int) info.stride;
+        uint8_t *destination = rgbaPixels.data();
+        auto destination16 = reinterpret_cast<uint16_t *>(rgbaPixels.data());
 
-        if (info.format == ANDROID_BITMAP_FORMAT_RGBA_F16) {
-            if (isF16Allowed) {
-                usingFormat = APF_F16;
+        if (usingFormat == sourceFormat) {
+            aire::CopyUnaligned(source, sourceStride, destination, imageStride,
+                                width * components, height, pixelSize);
+        } else if (sourceFormat == APF_F16) {
+            if (usingFormat == APF_RGBA1010102) {
+                aire::F16ToRGBA1010102(source16, sourceStride, destination, imageStride, width, height);
+            } else if (usingFormat == APF_RGBA8888) {
+                aire::RGBAF16BitToNBitU8(source16, sourceStride, destination, imageStride, width, height, 8, true);
             } else {
-                if (is1010102Allowed) {
-                    imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
-                    vector<uint8_t> halfFloatPixels(imageStride * info.height);
-                    aire::F16ToRGBA1010102(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                           (int) info.stride,
-                                           reinterpret_cast<uint8_t *>(halfFloatPixels.data()),
-                                           (int) imageStride,
-                                           (int) info.width,
-                                           (int) info.height);
-                    usingFormat = APF_RGBA1010102;
-                    rgbaPixels = halfFloatPixels;
-                } else if (is888Allowed) {
-                    imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
-                    vector<uint8_t> halfFloatPixels(imageStride * info.height);
-                    aire::RGBAF16BitToNBitU8(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                             (int) info.stride,
-                                             reinterpret_cast<uint8_t *>(halfFloatPixels.data()),
-                                             (int) imageStride,
-                                             (int) info.width,
-                                             (int) info.height, 8, true);
-                    usingFormat = APF_RGBA8888;
-                    rgbaPixels = halfFloatPixels;
-                } else if (is565Allowed) {
-                    imageStride = (int) info.width * (int) sizeof(uint16_t);
-                    vector<uint8_t> r888Pixels(imageStride * info.height);
-                    aire::RGBAF16To565(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                       (int) info.stride,
-                                       reinterpret_cast<uint16_t *>(r888Pixels.data()),
-                                       (int) imageStride,
-                                       (int) info.width,
-                                       (int) info.height);
-                    usingFormat = APF_RGBA8888;
-                    rgbaPixels = r888Pixels;
-                } else {
-                    string ss = getPixelFormatName(APF_F16);
-                    string exc = "Unknown " + ss + " conversion path";
-                    throw AireError(exc);
-                }
+                aire::RGBAF16To565(source16, sourceStride, destination16, imageStride, width, height);
             }
-        } else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_1010102) {
-            if (!is1010102Allowed) {
-                if (isF16Allowed) {
-                    imageStride = (int) info.width * 4 * (int) sizeof(uint16_t);
-                    vector<uint8_t> halfFloatPixels(imageStride * info.height);
-                    aire::ConvertRGBA1010102toF16(
-                            reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                            (int) info.stride,
-                            reinterpret_cast<uint16_t *>(halfFloatPixels.data()),
-                            (int) imageStride,
-                            (int) info.width,
-                            (int) info.height);
-                    usingFormat = APF_F16;
-                    rgbaPixels = halfFloatPixels;
-                } else if (is888Allowed) {
-                    imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
-                    vector<uint8_t> r888Pixels(imageStride * info.height);
-                    aire::RGBA1010102ToUnsigned(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                                                (int) info.stride,
-                                                reinterpret_cast<uint8_t *>(r888Pixels.data()),
-                                                (int) imageStride,
-                                                (int) info.width,
-                                                (int) info.height, 8);
-                    usingFormat = APF_RGBA8888;
-                    rgbaPixels = r888Pixels;
-                } else if (is565Allowed) {
-                    imageStride = (int) info.width * (int) sizeof(uint16_t);
-                    vector<uint8_t> r888Pixels(imageStride * info.height);
-                    aire::RGBA1010102To565(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                                           (int) info.stride,
-                                           reinterpret_cast<uint16_t *>(r888Pixels.data()),
-                                           (int) imageStride,
-                                           (int) info.width,
-                                           (int) info.height);
-                    usingFormat = APF_565;
-                    rgbaPixels = r888Pixels;
-                } else {
-                    string ss = getPixelFormatName(APF_RGBA1010102);
-                    string exc = "Unknown " + ss + " conversion path";
-                    throw AireError(exc);
-                }
+        } else if (sourceFormat == APF_RGBA1010102) {
+            if (usingFormat == APF_F16) {
+                aire::ConvertRGBA1010102toF16(source, sourceStride, destination16, imageStride, width, height);
+            } else if (usingFormat == APF_RGBA8888) {
+                aire::RGBA1010102ToUnsigned(source, sourceStride, destination, imageStride, width, height, 8);
             } else {
-                usingFormat = APF_RGBA1010102;
+                aire::RGBA1010102To565(source, sourceStride, destination16, imageStride, width, height);
             }
-        } else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
-            if (is888Allowed) {
-                usingFormat = APF_RGBA8888;
+        } else if (sourceFormat == APF_RGBA8888) {
+            if (usingFormat == APF_F16) {
+                aire::Rgba8ToF16(source, sourceStride, destination16, imageStride, width, height, 8, true);
+            } else if (usingFormat == APF_RGBA1010102) {
+                aire::Rgba8ToRGBA1010102(source, sourceStride, destination, imageStride, width, height, true);
             } else {
-                if (isF16Allowed) {
-                    imageStride = (int) info.width * 4 * (int) sizeof(uint16_t);
-                    vector<uint8_t> halfFloatPixels(imageStride * info.height);
-                    aire::Rgba8ToF16(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                                     (int) info.stride,
-                                     reinterpret_cast<uint16_t *>(halfFloatPixels.data()),
-                                     (int) imageStride,
-                                     (int) info.width,
-                                     (int) info.height, 8, true);
-                    usingFormat = APF_F16;
-                    rgbaPixels = halfFloatPixels;
-                } else if (is1010102Allowed) {
-                    imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
-                    vector<uint8_t> halfFloatPixels(imageStride * info.height);
-                    aire::Rgba8ToRGBA1010102(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                                             (int) info.stride,
-                                             reinterpret_cast<uint8_t *>(halfFloatPixels.data()),
-                                             (int) imageStride,
-                                             (int) info.width,
-                                             (int) info.height, true);
-                    usingFormat = APF_RGBA1010102;
-                    rgbaPixels = halfFloatPixels;
-                } else if (is565Allowed) {
-                    imageStride = (int) info.width * (int) sizeof(uint16_t);
-                    vector<uint8_t> halfFloatPixels(imageStride * info.height);
-                    aire::Rgba8To565(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                                     (int) info.stride,
-                                     reinterpret_cast<uint16_t *>(halfFloatPixels.data()),
-                                     (int) imageStride,
-                                     (int) info.width,
-                                     (int) info.height, 8, true);
-                    usingFormat = APF_RGBA1010102;
-                    rgbaPixels = halfFloatPixels;
-                } else {
-                    string ss = getPixelFormatName(APF_RGBA8888);
-                    string exc = "Unknown " + ss + " conversion path";
-                    throw AireError(exc);
-                }
+                aire::Rgba8To565(source, sourceStride, destination16, imageStride, width, height, 8, true);
             }
-        } else if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
-            if (is565Allowed) {
-                usingFormat = APF_565;
+        } else {
+            if (usingFormat == APF_F16) {
+                aire::Rgb565ToF16(source16, sourceStride, destination16, imageStride, width, height);
+            } else if (usingFormat == APF_RGBA1010102) {
+                aire::Rgb565ToRGBA1010102(source16, sourceStride, destination, imageStride, width, height);
             } else {
-                if (isF16Allowed) {
-                    int newStride = (int) info.width * 4 * (int) sizeof(uint16_t);
-                    std::vector<uint8_t> rgba8888Pixels(newStride * info.height);
-                    aire::Rgb565ToF16(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                      (int) info.stride,
-                                      reinterpret_cast<uint16_t *>(rgba8888Pixels.data()),
-                                      newStride,
-                                      (int) info.width, (int) info.height);
-
-                    imageStride = newStride;
-                    rgbaPixels = rgba8888Pixels;
-                    usingFormat = APF_F16;
-                } else if (is1010102Allowed) {
-                    int newStride = (int) info.width * 4 * (int) sizeof(uint8_t);
-                    std::vector<uint8_t> rgba8888Pixels(newStride * info.height);
-                    aire::Rgb565ToRGBA1010102(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                              (int) info.stride,
-                                              rgba8888Pixels.data(), newStride,
-                                              (int) info.width, (int) info.height);
-                    usingFormat = APF_RGBA1010102;
-                    imageStride = newStride;
-                    rgbaPixels = rgba8888Pixels;
-                } else if (is888Allowed) {
-                    int newStride = (int) info.width * 4 * (int) sizeof(uint8_t);
-                    std::vector<uint8_t> rgba8888Pixels(newStride * info.height);
-                    aire::Rgb565ToUnsigned8(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                            (int) info.stride,
-                                            rgba8888Pixels.data(), newStride,
-                                            (int) info.width, (int) info.height, 8, 255);
-                    usingFormat = APF_RGBA8888;
-                    imageStride = newStride;
-                    rgbaPixels = rgba8888Pixels;
-                } else {
-                    string ss = getPixelFormatName(APF_565);
-                    string exc = "Unknown " + ss + " conversion path";
-                    throw AireError(exc);
-                }
+                aire::Rgb565ToUnsigned8(source16, sourceStride, destination, imageStride, width, height, 8, 255);
             }
         }
 
-        int pixelSize = getPixelSize(usingFormat);
-        int components = getComponents(usingFormat);
-
-        if (!allowsMemoryAlignment && imageStride != info.width * components * pixelSize) {
-            std::vector<uint8_t> newPixels(
-                    info.width * components * pixelSize * (int) info.height);
-            rgbaPixels = newPixels;
-            imageStride = info.width * components * pixelSize;
+        if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+            string exc = "Unlocking pixels has failed";
+            throw AireError(exc);
         }
 
-        auto result = worker(rgbaPixels, imageStride, info.width, info.height, usingFormat);
+        auto result = worker(rgbaPixels, imageStride, width, height, usingFormat);
 
         std::string bitmapPixelConfig = getAndroidFormat(result.pixelFormat);
         jclass bitmapConfig = env->FindClass("android/graphics/Bitmap$Config");
@@ -370,4 +244,84 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
     } catch (std::bad_alloc &err) {
         throw AireError(err.what());
     }
-}
\ No newline at end of file
+}
+void ReadBitmapPixels(JNIEnv *env, jobject bitmap,
+                      const std::function<void(const uint8_t *, int, int, int)> &reader) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
+        std::string err("Cannot acquire bitmap info");
+        throw AireError(err);
+    }
+
+    if (info.flags & ANDROID_BITMAP_FLAGS_IS_HARDWARE) {
+        std::string exc = "Hardware bitmap is not supported";
+        throw AireError(exc);
+    }
+
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 &&
+        info.format != ANDROID_BITMAP_FORMAT_RGBA_F16 &&
+        info.format != ANDROID_BITMAP_FORMAT_RGBA_1010102) {
+        string msg("Currently reading supports only RGBA_8888, RGBA_F16, RGBA_1010102 images pixel format");
+        throw AireError(msg);
+    }
+
+    void *addr = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &addr) != 0) {
+        std::string exc = "Cannot acquire bitmap pixels";
+        throw AireError(exc);
+    }
+
+    try {
+        const int width = (int) info.width;
+        const int height = (int) info.height;
+        if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
+            reader(reinterpret_cast<const uint8_t *>(addr), (int) info.stride, width, height);
+        } else {
+            const int stride = width * 4 * (int) sizeof(uint8_t);
+            vector<uint8_t> rgbaPixels(stride * height);
+            if (info.format == ANDROID_BITMAP_FORMAT_RGBA_F16) {
+                aire::RGBAF16BitToNBitU8(reinterpret_cast<const uint16_t *>(addr), (int) info.stride,
+                                         rgbaPixels.data(), stride, width, height, 8, true);
+            } else {
+                aire::RGBA1010102ToUnsigned(reinterpret_cast<const uint8_t *>(addr), (int) info.stride,
+                                            rgbaPixels.data(), stride, width, height, 8);
+            }
+            reader(rgbaPixels.data(), stride, width, height);
+        }
+    } catch (...) {
+        AndroidBitmap_unlockPixels(env, bitmap);
+        throw;
+    }
+
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        string exc = "Unlocking pixels has failed";
+        throw AireError(exc);
+    }
+}
+
+int getBitmapColorSpaceId(JNIEnv *env, jobject bitmap) {
+    if (androidOSVersion() < 26) {
+        return -1;
+    }
+    jclass bitmapClass = env->FindClass("android/graphics/Bitmap");
+    jmethodID getColorSpaceMethod = env->GetMethodID(bitmapClass, "getColorSpace",
+                                                     "()Landroid/graphics/ColorSpace;");
+    jobject colorSpace = env->CallObjectMethod(bitmap, getColorSpaceMethod);
+    if (colorSpace == nullptr) {
+        return -1;
+    }
+    jclass colorSpaceClass = env->FindClass("android/graphics/ColorSpace");
+    jmethodID getIdMethod = env->GetMethodID(colorSpaceClass, "getId", "()I");
+    int id = env->CallIntMethod(colorSpace, getIdMethod);
+    env->DeleteLocalRef(colorSpace);
+    return id;
+}
+
+bool isBitmapPremultiplied(JNIEnv *env, jobject bitmap) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
+        std::string err("Cannot acquire bitmap info");
+        throw AireError(err);
+    }
+    return (info.flags & ANDROID_BITMAP_FLAGS_ALPHA_MASK) == ANDROID_BITMAP_FLAGS_ALPHA_PREMUL;
+}
@@ -34,6 +34,7 @@
 #include <vector>
 #include <iostream>
 #include <functional>
+#include "conversion/PixelStorage.h"
 
 enum AcquirePixelFormat {
     APF_RGBA8888,
@@ -84,6 +85,19 @@ static int getComponents(AcquirePixelFormat px) {
     return 0;
 }
 
+static aire::PixelStorage getPixelStorage(AcquirePixelFormat px) {
+    switch (px) {
+        case APF_565:
+            return aire::PIXEL_RGB565;
+        case APF_F16:
+            return aire::PIXEL_RGBA_F16;
+        case APF_RGBA1010102:
+            return aire::PIXEL_RGBA1010102;
+        default:
+            return aire::PIXEL_RGBA8888;
+    }
+}
+
 static std::string getAndroidFormat(AcquirePixelFormat px) {
     switch (px) {
         case APF_RGBA8888:
@@ -110,4 +124,22 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                          std::vector<AcquirePixelFormat> allowedFormats,
                          bool allowsMemoryAlignment,
                          std::function<BuiltImagePresentation(std::vector<uint8_t> &, int, int, int,
-                                                              AcquirePixelFormat)> worker);
\ No newline at end of file
+                                                              AcquirePixelFormat)> worker);
+/**
+ * Passes RGBA8888 pixels of the bitmap to reader while they are locked, RGBA_8888 is read in place,
+ * RGBA_F16 and RGBA_1010102 are converted to a temporary RGBA8888 image
+ */
+void ReadBitmapPixels(JNIEnv *env, jobject bitmap,
+                      const std::function<void(const uint8_t *, int, int, int)> &reader);
+
+/**
+ * Returns android.graphics.ColorSpace.Named ordinal of the bitmap or -1 if not available
+ */
+int getBitmapColorSpaceId(JNIEnv *env, jobject bitmap);
+
+/**
+ * Returns true when bitmap pixels are stored with premultiplied alpha, what is the default for Android bitmaps.
+ * Blurs and convolutions are correct on premultiplied pixels as is, pointwise color ops take this flag
+ * and unpremultiply in registers
+ */
+bool isBitmapPremultiplied(JNIEnv *env, jobject bitmap);
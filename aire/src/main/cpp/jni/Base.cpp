@@ -36,13 +36,15 @@
 #include "base/Dilation.h"
 #include "base/Threshold.h"
 #include "base/Erosion.h"
+#include "base/Morphology.h"
 #include "base/Vibrance.h"
 #include "base/Grain.h"
 #include "base/Sharpness.h"
-#include "base/LUT8.h"
 #include "algo/MedianCut.h"
 #include "blur/GaussBlur.h"
 #include "color/Adjustments.h"
+#include "color/Lut3D.h"
+#include "color/PointwiseBake.h"
 #include "MathUtils.hpp"
 #include "Eigen/Eigen"
 #include "algo/WuQuantizer.h"
@@ -73,7 +75,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grayscalePipeline(JNIEnv *env, j
                                                                 bPrimary);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -134,7 +136,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_dilatePipeline(JNIEnv *env, jobj
                                                 input = output;
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -194,7 +196,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_thresholdPipeline(JNIEnv *env, j
                                                             height);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -244,7 +246,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_erodePipeline(JNIEnv *env, jobje
                                                 input = output;
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -281,7 +283,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_vibrancePipeline(JNIEnv *env, jo
                                                                vibrance);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -300,13 +302,14 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_contrastImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat gain) {
   try {
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
     jobject newBitmap = AcquireBitmapPixels(env,
                                             bitmap,
                                             formats,
                                             true,
-                                            [gain](
+                                            [gain, premultiplied](
                                                 std::vector<uint8_t> &input, int stride,
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -316,10 +319,11 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_contrastImpl(JNIEnv *env, jobjec
                                                                  width,
                                                                  height,
                                                                  gain,
-                                                                 0.0f);
+                                                                 0.0f,
+                                                                 premultiplied);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -338,13 +342,14 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_brightnessImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat bias) {
   try {
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
     jobject newBitmap = AcquireBitmapPixels(env,
                                             bitmap,
                                             formats,
                                             true,
-                                            [bias](
+                                            [bias, premultiplied](
                                                 std::vector<uint8_t> &input, int stride,
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -354,10 +359,11 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_brightnessImpl(JNIEnv *env, jobj
                                                                  width,
                                                                  height,
                                                                  1.0f,
-                                                                 bias);
+                                                                 bias,
+                                                                 premultiplied);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -383,35 +389,133 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_colorMatrixImpl(JNIEnv *env, job
       return nullptr;
     }
 
-    Eigen::Matrix3f colorMatrix;
+    // Runs as a single op chain, so it's fused into fixed point pass and handles premultiplied alpha
+    std::vector<aire::PointwiseOp> ops(1);
+    ops[0].type = aire::POINTWISE_COLOR_MATRIX;
+    env->GetFloatArrayRegion(jColorMatrix, 0, 9, ops[0].params);
 
-    jfloat *inputElements = env->GetFloatArrayElements(jColorMatrix, 0);
-    for (int i = 0; i < 3; ++i) {
-      for (int j = 0; j < 3; ++j) {
-        colorMatrix(i, j) = inputElements[i * 3 + j];
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    jobject newBitmap = AcquireBitmapPixels(env,
+                                            bitmap,
+                                            formats,
+                                            true,
+                                            [&ops, premultiplied](
+                                                std::vector<uint8_t> &input, int stride,
+                                                int width, int height,
+                                                AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                              if (fmt == APF_RGBA8888) {
+                                                aire::pointwiseChain(input.data(), stride, width, height, ops,
+                                                                     premultiplied);
+                                              }
+                                              return {
+                                                  .data = std::move(input),
+                                                  .stride = stride,
+                                                  .width = width,
+                                                  .height = height,
+                                                  .pixelFormat = fmt
+                                              };
+                                            });
+    return newBitmap;
+  } catch (AireError &err) {
+    std::string msg = err.what();
+    throwException(env, msg);
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_lut3DImpl(JNIEnv *env, jobject thiz, jobject bitmap, jbyteArray jLut) {
+  try {
+    jsize length = env->GetArrayLength(jLut);
+    std::vector<uint8_t> lutData(length);
+    env->GetByteArrayRegion(jLut, 0, length, reinterpret_cast<jbyte *>(lutData.data()));
+
+    std::shared_ptr<aire::Lut3D> lut = aire::obtainLut3D(lutData.data(), lutData.size());
+
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    formats.insert(formats.begin(), APF_F16);
+    jobject newBitmap = AcquireBitmapPixels(env,
+                                            bitmap,
+                                            formats,
+                                            true,
+                                            [&lut, premultiplied](
+                                                std::vector<uint8_t> &input, int stride,
+                                                int width, int height,
+                                                AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                              if (fmt == APF_RGBA8888) {
+                                                lut->applyRGBA8888(input.data(), stride, width, height, premultiplied);
+                                              } else if (fmt == APF_F16) {
+                                                lut->applyRGBAF16(reinterpret_cast<uint16_t *>(input.data()),
+                                                                  stride, width, height, premultiplied);
+                                              }
+                                              return {
+                                                  .data = std::move(input),
+                                                  .stride = stride,
+                                                  .width = width,
+                                                  .height = height,
+                                                  .pixelFormat = fmt
+                                              };
+                                            });
+    return newBitmap;
+  } catch (AireError &err) {
+    std::string msg = err.what();
+    throwException(env, msg);
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_pointwiseImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                              jintArray jTypes, jfloatArray jParams) {
+  try {
+    jsize opsCount = env->GetArrayLength(jTypes);
+    jsize paramsLength = env->GetArrayLength(jParams);
+    if (paramsLength != opsCount * aire::pointwiseMaxParams) {
+      std::string msg = "Each pointwise operation must have exactly " + std::to_string(aire::pointwiseMaxParams) + " params";
+      throwException(env, msg);
+      return nullptr;
+    }
+
+    std::vector<jint> types(opsCount);
+    std::vector<jfloat> params(paramsLength);
+    env->GetIntArrayRegion(jTypes, 0, opsCount, types.data());
+    env->GetFloatArrayRegion(jParams, 0, paramsLength, params.data());
+
+    std::vector<aire::PointwiseOp> ops(opsCount);
+    for (int i = 0; i < opsCount; ++i) {
+      if (types[i] < aire::POINTWISE_EXPOSURE || types[i] > aire::POINTWISE_THRESHOLD) {
+        std::string msg = "Unknown pointwise operation: " + std::to_string(types[i]);
+        throwException(env, msg);
+        return nullptr;
       }
+      ops[i].type = static_cast<aire::PointwiseOpType>(types[i]);
+      std::copy(params.begin() + i * aire::pointwiseMaxParams,
+                params.begin() + (i + 1) * aire::pointwiseMaxParams, ops[i].params);
     }
-    env->ReleaseFloatArrayElements(jColorMatrix, inputElements, 0);
 
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
     jobject newBitmap = AcquireBitmapPixels(env,
                                             bitmap,
                                             formats,
                                             true,
-                                            [colorMatrix](
+                                            [&ops, premultiplied](
                                                 std::vector<uint8_t> &input, int stride,
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                               if (fmt == APF_RGBA8888) {
-                                                aire::colorMatrix(input.data(),
-                                                                  stride,
-                                                                  width,
-                                                                  height,
-                                                                  colorMatrix);
+                                                aire::pointwiseChain(input.data(), stride, width, height, ops,
+                                                                     premultiplied);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -428,7 +532,9 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_colorMatrixImpl(JNIEnv *env, job
 
 extern "C"
 JNIEXPORT jobject JNICALL
-Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat intensity) {
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat intensity,
+                                                          jlong seed, jfloat luminanceResponse,
+                                                          jfloat chromaIntensity) {
   try {
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
@@ -436,7 +542,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject t
                                             bitmap,
                                             formats,
                                             true,
-                                            [intensity](
+                                            [intensity, seed, luminanceResponse, chromaIntensity](
                                                 std::vector<uint8_t> &input, int stride,
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -445,10 +551,13 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject t
                                                             stride,
                                                             width,
                                                             height,
-                                                            intensity);
+                                                            intensity,
+                                                            static_cast<uint64_t>(seed),
+                                                            luminanceResponse,
+                                                            chromaIntensity);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -483,7 +592,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_sharpnessImpl(JNIEnv *env, jobje
                                                 aire::applySharp(input.data(), sharpen.data(), stride, width, height, intensity);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -519,7 +628,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_unsharpImpl(JNIEnv *env, jobject
                                                 aire::applyUnsharp(input.data(), sharpen.data(), stride, width, height, intensity);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -538,27 +647,29 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_gammaImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat gamma) {
   try {
+    // Straight alpha gamma runs as LUT8, premultiplied pixels go through the fused pass
+    // which unpremultiplies them in registers
+    std::vector<aire::PointwiseOp> ops(1);
+    ops[0].type = aire::POINTWISE_GAMMA;
+    ops[0].params[0] = gamma;
+
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
     jobject newBitmap = AcquireBitmapPixels(env,
                                             bitmap,
                                             formats,
                                             true,
-                                            [gamma](
+                                            [&ops, premultiplied](
                                                 std::vector<uint8_t> &input, int stride,
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                               if (fmt == APF_RGBA8888) {
-                                                const int TABLE_SIZE = 256;
-                                                uint8_t lookupTable[TABLE_SIZE];
-                                                for (int i = 0; i < 256; ++i) {
-                                                  lookupTable[i] = std::clamp(std::powf(float(i), gamma), 0.f, 255.f);
-                                                }
-                                                const aire::LUT8 lut(lookupTable);
-                                                lut.apply(input.data(), stride, width, height);
+                                                aire::pointwiseChain(input.data(), stride, width, height, ops,
+                                                                     premultiplied);
                                               }
                                               return {
-                                                  .data = input,
+                                                  .data = std::move(input),
                                                   .stride = stride,
                                                   .width = width,
                                                   .height = height,
@@ -631,7 +742,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_paletteImpl(JNIEnv *env, jobject
                                        };
                                      }
                                      return {
-                                         .data = input,
+                                         .data = std::move(input),
                                          .stride = stride,
                                          .width = width,
                                          .height = height,
@@ -732,4 +843,90 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_getBokehConvolutionKernelImpl(JN
     throwException(env, exception);
     return nullptr;
   }
-}
\ No newline at end of file
+}
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_morphologyPipeline(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                   jint morphOp, jint morphOpMode,
+                                                                   jint borderMode, jobject borderScalar,
+                                                                   jintArray kernel, jint kernelWidth,
+                                                                   jint kernelHeight) {
+  try {
+    if (kernelWidth <= 0 || kernelHeight <= 0) {
+      std::string msg("Kernel size must be >= 1");
+      throw AireError(msg);
+    }
+    if (morphOp < aire::MORPH_DILATE || morphOp > aire::MORPH_BLACKHAT) {
+      std::string msg("Unknown morphology operation: " + std::to_string(morphOp));
+      throw AireError(msg);
+    }
+    if (borderMode < aire::EDGE_CLAMP || borderMode > aire::EDGE_CONSTANT) {
+      std::string msg("Unknown border mode: " + std::to_string(borderMode));
+      throw AireError(msg);
+    }
+    jsize length = env->GetArrayLength(kernel);
+    if (length != kernelWidth * kernelHeight) {
+      std::string msg("Kernel must have " + std::to_string(kernelWidth * kernelHeight) +
+          " elements but received " + std::to_string(length));
+      throw AireError(msg);
+    }
+
+    Eigen::MatrixXi matrix(kernelHeight, kernelWidth);
+    jint *inputElements = env->GetIntArrayElements(kernel, 0);
+    for (int j = 0; j < kernelHeight; ++j) {
+      for (int i = 0; i < kernelWidth; ++i) {
+        matrix(j, i) = inputElements[j * kernelWidth + i];
+      }
+    }
+    env->ReleaseIntArrayElements(kernel, inputElements, 0);
+
+    if ((matrix.array() != 0).count() == 0) {
+      std::string msg("Kernel must have at least one non zero element");
+      throw AireError(msg);
+    }
+
+    auto scalar = getScalarRGBA(env, borderScalar);
+    auto op = static_cast<aire::MorphOp>(morphOp);
+    auto mode = morphOpMode == aire::MORPH_OP_RGB ? aire::MORPH_OP_RGB : aire::MORPH_OP_RGBA;
+    auto edgeMode = static_cast<aire::EdgeMode>(borderMode);
+
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    jobject newBitmap = AcquireBitmapPixels(env,
+                                            bitmap,
+                                            formats,
+                                            true,
+                                            [&](
+                                                std::vector<uint8_t> &input, int stride,
+                                                int width, int height,
+                                                AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                              if (fmt == APF_RGBA8888) {
+                                                std::vector<uint8_t> output(
+                                                    stride * height);
+                                                aire::morphology(input.data(), output.data(),
+                                                                 stride, width, height,
+                                                                 op, mode, edgeMode, scalar,
+                                                                 matrix);
+                                                return {
+                                                    .data = std::move(output),
+                                                    .stride = stride,
+                                                    .width = width,
+                                                    .height = height,
+                                                    .pixelFormat = fmt
+                                                };
+                                              }
+                                              return {
+                                                  .data = std::move(input),
+                                                  .stride = stride,
+                                                  .width = width,
+                                                  .height = height,
+                                                  .pixelFormat = fmt
+                                              };
+                                            });
+    return newBitmap;
+  } catch (AireError &err) {
+    std::string msg = err.what();
+    throwException(env, msg);
+    return nullptr;
+  }
+}
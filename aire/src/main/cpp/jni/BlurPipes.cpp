@@ -40,6 +40,7 @@
 #include <string>
 #include "blur/ZoomBlur.hpp"
 #include "blur/AnisotropicDiffusion.h"
+#include "blur/BilateralGrid.h"
 #include "color/Gamut.h"
 #include "EigenUtils.h"
 
@@ -67,7 +68,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_boxBlurPipeline(JNIEnv *env, job
                                                                          height, radius);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -101,7 +102,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_medianBlurPipeline(JNIEnv *env,
                                                                 stride, width, height, radius);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -144,7 +145,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_gaussianBlurPipeline(JNIEnv *env
                                                                            sigma);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -183,7 +184,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_tentBlurPipeline(JNIEnv *env, jo
                                                                           height, radius);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -229,7 +230,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_anisotropicDiffusionPipeline(JNI
                                                                                    height, diffusion, conduction, numOfSteps);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -267,7 +268,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_poissonBlurPipeline(JNIEnv *env,
                                                                              height, radius);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -299,7 +300,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_fastGaussian2DImpl(JNIEnv *env,
                                                         aire::gaussianApproximation2D(input.data(), stride, width,
                                                                                       height, radius);
                                                         return {
-                                                                .data = input,
+                                                                .data = std::move(input),
                                                                 .stride = stride,
                                                                 .width = width,
                                                                 .height = height,
@@ -307,7 +308,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_fastGaussian2DImpl(JNIEnv *env,
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -338,7 +339,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_fastGaussian3DImpl(JNIEnv *env,
                                                         aire::gaussianApproximation3D(input.data(), stride, width,
                                                                                       height, radius);
                                                         return {
-                                                                .data = input,
+                                                                .data = std::move(input),
                                                                 .stride = stride,
                                                                 .width = width,
                                                                 .height = height,
@@ -346,7 +347,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_fastGaussian3DImpl(JNIEnv *env,
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -376,7 +377,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_fastGaussian4DImpl(JNIEnv *env,
                                                         aire::gaussianApproximation4D(input.data(), stride, width,
                                                                                       height, radius);
                                                         return {
-                                                                .data = input,
+                                                                .data = std::move(input),
                                                                 .stride = stride,
                                                                 .width = width,
                                                                 .height = height,
@@ -384,7 +385,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_fastGaussian4DImpl(JNIEnv *env,
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -422,7 +423,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_zoomBlurImpl(JNIEnv *env, jobjec
                                                         aire::ZoomBlur zoom(kernelSize, sigma, centerX, centerY, strength, angle);
                                                         zoom.apply(input.data(), stride, width, height);
                                                         return {
-                                                                .data = input,
+                                                                .data = std::move(input),
                                                                 .stride = stride,
                                                                 .width = width,
                                                                 .height = height,
@@ -430,7 +431,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_zoomBlurImpl(JNIEnv *env, jobjec
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -443,4 +444,53 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_zoomBlurImpl(JNIEnv *env, jobjec
         throwException(env, msg);
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_bilateralGridBlurImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                      jfloat spatialSigma, jfloat rangeSigma,
+                                                                      jboolean linearLight) {
+    try {
+        if (spatialSigma <= 0 || rangeSigma <= 0) {
+            std::string msg("Sigma must be > 0, but received (" + std::to_string(spatialSigma) + ", "
+                            + std::to_string(rangeSigma) + ")");
+            throw AireError(msg);
+        }
+        const bool useLinear = linearLight == JNI_TRUE;
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        formats.insert(formats.begin(), APF_F16);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&](std::vector<uint8_t> &input, int stride,
+                                                    int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::bilateralGridBlurU8(input.data(), stride, width, height,
+                                                                                  spatialSigma, rangeSigma, useLinear);
+                                                    } else if (fmt == APF_F16) {
+                                                        aire::bilateralGridBlurF16(reinterpret_cast<uint16_t *>(input.data()),
+                                                                                   stride, width, height,
+                                                                                   spatialSigma, rangeSigma, useLinear);
+                                                    }
+                                                    return {
+                                                            .data = std::move(input),
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    } catch (std::bad_alloc &err) {
+        std::string exception = "Not enough memory to blur this image";
+        throwException(env, exception);
+        return nullptr;
+    }
+}
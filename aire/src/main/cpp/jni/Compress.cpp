@@ -62,6 +62,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_toPNGImpl(JNIEnv *env, jobject t
     aire::RemapDithering dithering = static_cast<aire::RemapDithering>(ditheringStrategy);
     AireQuantize quantize = static_cast<AireQuantize>(aireQuantize);
     aire::RemapMappingStrategy strategy = static_cast<aire::RemapMappingStrategy>(mappingStrategy);
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
     std::vector<uint8_t> compressedData;
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
@@ -69,19 +70,21 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_toPNGImpl(JNIEnv *env, jobject t
                         bitmap,
                         formats,
                         false,
-                        [&compressedData, maxColors, quantize, dithering, strategy, compressionLevel](
+                        [&compressedData, maxColors, quantize, dithering, strategy, compressionLevel, premultiplied](
                             std::vector<uint8_t> &input, int stride,
                             int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
                           if (fmt == APF_RGBA8888) {
                             std::vector<Eigen::Vector4i> palette;
                             uint32_t colors = maxColors;
-                            std::vector<uint8_t> original(input.size());
-
-                            aire::UnpremultiplyRGBA(input.data(), stride, original.data(), stride, width, height);
+                            // Pixels are owned by this call, so alpha is removed in place without a frame copy
+                            if (premultiplied) {
+                              aire::UnpremultiplyRGBA(input.data(), stride, input.data(), stride, width, height);
+                            }
+                            uint8_t *original = input.data();
 
                             switch (quantize) {
                               case AIRE_QUANTIZE_MEDIAN_CUT: {
-                                aire::Palette cut(reinterpret_cast<uint32_t *>(original.data()), width * height);
+                                aire::Palette cut(reinterpret_cast<uint32_t *>(original), width * height);
                                 cut.medianCut(maxColors, [&palette](const aire::Cube &cube) {
                                   auto clr = cube.getAverageRGBA();
                                   palette.push_back(unpackRGBA(clr));
@@ -89,13 +92,13 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_toPNGImpl(JNIEnv *env, jobject t
                               }
                                 break;
                               case AIRE_QUANTIZE_XIAOLING_WU: {
-                                aire::WuQuantizer wuQuantizer(original.data(), stride, width, height);
+                                aire::WuQuantizer wuQuantizer(original, stride, width, height);
                                 palette = wuQuantizer.quantizeImage(colors, 15, 15);
                               }
                                 break;
                             }
 
-                            aire::RemapPalette remapPalette(palette, original.data(), stride, width, height, dithering, strategy);
+                            aire::RemapPalette remapPalette(palette, original, stride, width, height, dithering, strategy);
                             if (maxColors > 255 || dithering != aire::Remap_Dither_Skip) {
                               std::vector<uint8_t> remapped = remapPalette.remap();
                               aire::PNGEncoder encoder(remapped.data(), stride, width, height);
@@ -113,7 +116,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_toPNGImpl(JNIEnv *env, jobject t
                             }
                           }
                           return {
-                              .data = input,
+                              .data = std::move(input),
                               .stride = stride,
                               .width = width,
                               .height = height,
@@ -142,6 +145,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_toJPEGImpl(JNIEnv *env, jobject
       throw AireError(msg);
     }
 
+    const bool premultiplied = isBitmapPremultiplied(env, bitmap);
     std::vector<uint8_t> compressedData;
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
@@ -149,21 +153,22 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_toJPEGImpl(JNIEnv *env, jobject
                         bitmap,
                         formats,
                         false,
-                        [&compressedData, quality](
+                        [&compressedData, quality, premultiplied](
                             std::vector<uint8_t> &input, int stride,
                             int width, int height,
                             AcquirePixelFormat fmt) -> BuiltImagePresentation {
                           if (fmt == APF_RGBA8888) {
-                            std::vector<uint8_t> original(input.size());
-                            aire::UnpremultiplyRGBA(input.data(), stride, original.data(), stride, width, height);
-                            aire::JPEGEncoder encoder(original.data(), stride, width, height);
+                            if (premultiplied) {
+                              aire::UnpremultiplyRGBA(input.data(), stride, input.data(), stride, width, height);
+                            }
+                            aire::JPEGEncoder encoder(input.data(), stride, width, height);
                             encoder.setQuality(quality);
                             auto output = encoder.encode();
                             compressedData.resize(output.size());
                             std::copy(output.begin(), output.end(), compressedData.begin());
                           }
                           return {
-                              .data = input,
+                              .data = std::move(input),
                               .stride = stride,
                               .width = width,
                               .height = height,
@@ -41,8 +41,56 @@
 #include "base/Dilation.h"
 #include "blur/GaussBlur.h"
 #include "color/ConvolveToneMapper.h"
+#include "base/Clahe.h"
 #include "MathUtils.hpp"
 #include "EigenUtils.h"
+#include <functional>
+
+// EqualizeColorspace.LUMA, others carry aire::ColorSpace values
+static const jint equalizeColorspaceLuma = -1;
+
+static aire::ColorSpace getEqualizeColorspace(jint colorspace) {
+    if (colorspace < aire::COLORSPACE_OKLAB || colorspace > aire::COLORSPACE_JZAZBZ) {
+        std::string errorString = "Unknown equalization colorspace: " + std::to_string(colorspace);
+        throw AireError(errorString);
+    }
+    return static_cast<aire::ColorSpace>(colorspace);
+}
+
+static jobject equalizeBitmap(JNIEnv *env, jobject bitmap,
+                              const std::function<void(uint8_t *, int, int, int)> &equalizer) {
+    try {
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&](std::vector<uint8_t> &input, int stride,
+                                                    int width, int height,
+                                                    AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        equalizer(input.data(), stride, width, height);
+                                                    }
+                                                    return {
+                                                            .data = std::move(input),
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    } catch (std::bad_alloc &err) {
+        std::string exception = "Not enough memory to equalize this image";
+        throwException(env, exception);
+        return nullptr;
+    }
+}
 
 extern "C"
 JNIEXPORT jobject JNICALL
@@ -68,7 +116,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_marbleImpl(JNIEnv *env, jobjec
                                                                            amplitude);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -104,7 +152,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_oilImpl(JNIEnv *env, jobject t
                                                                         levels);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -142,7 +190,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_crystallizeImpl(JNIEnv *env, j
                                                                           strokeColor);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -176,7 +224,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_fractalGlassImpl(JNIEnv *env,
                                                                                  height, glassSize, amplitude);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -219,7 +267,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_waterEffectImpl(JNIEnv *env, j
                                                                           amplitudeY);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -258,7 +306,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_perlinDistortionImpl(JNIEnv *e
                                                                                amplitude);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -314,7 +362,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_bokehImpl(JNIEnv *env, jobject
                                                         input = output;
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -348,7 +396,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_convexImpl(JNIEnv *env, jobjec
                                                         convex.apply(input.data(), stride, width, height);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -361,4 +409,57 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_convexImpl(JNIEnv *env, jobjec
         throwException(env, msg);
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_equalizeHistogramPipeline(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                            jint colorspace, jint binsCount) {
+    return equalizeBitmap(env, bitmap, [&](uint8_t *data, int stride, int width, int height) {
+        if (colorspace == equalizeColorspaceLuma) {
+            aire::equalizeHist(data, stride, width, height);
+        } else {
+            aire::equalizeHist(data, stride, width, height, binsCount, getEqualizeColorspace(colorspace));
+        }
+    });
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_equalizeHistogramTilesPipeline(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                                 jint gridSizeHorizontal, jint gridSizeVertical) {
+    return equalizeBitmap(env, bitmap, [&](uint8_t *data, int stride, int width, int height) {
+        aire::equalizeHistSquares(data, stride, width, height, gridSizeHorizontal, gridSizeVertical);
+    });
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_equalizeHistogramSlidingPipeline(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                                   jint gridSizeHorizontal, jint gridSizeVertical,
+                                                                                   jint colorspace, jint binsCount) {
+    return equalizeBitmap(env, bitmap, [&](uint8_t *data, int stride, int width, int height) {
+        if (colorspace == equalizeColorspaceLuma) {
+            aire::equalizeHistAdaptive(data, stride, width, height, gridSizeHorizontal, gridSizeVertical);
+        } else {
+            aire::equalizeHistAdaptive(data, stride, width, height, gridSizeHorizontal, gridSizeVertical, binsCount,
+                                       getEqualizeColorspace(colorspace));
+        }
+    });
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_contrastLimitedEqualizePipeline(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                                  jfloat threshold, jint gridSizeHorizontal,
+                                                                                  jint gridSizeVertical, jint colorspace,
+                                                                                  jint binsCount) {
+    return equalizeBitmap(env, bitmap, [&](uint8_t *data, int stride, int width, int height) {
+        if (colorspace == equalizeColorspaceLuma) {
+            aire::clahe(data, stride, width, height, threshold, gridSizeHorizontal, gridSizeVertical);
+        } else {
+            aire::clahe(data, stride, width, height, threshold, gridSizeHorizontal, gridSizeVertical, binsCount,
+                        getEqualizeColorspace(colorspace));
+        }
+    });
+}
@@ -62,7 +62,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_cropImpl(JNIEnv *env, jobject th
                                                         transform.setTransform(matrix);
                                                         transform.apply(output.data(), newStride, newWidth, newHeight);
                                                         return {
-                                                                .data = output,
+                                                                .data = std::move(output),
                                                                 .stride = newStride,
                                                                 .width = newWidth,
                                                                 .height = newHeight,
@@ -70,7 +70,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_cropImpl(JNIEnv *env, jobject th
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -126,7 +126,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_rotateImpl(JNIEnv *env, jobject
                                                         transform.setTransform(matrix);
                                                         transform.apply(output.data(), newStride, newWidth, newHeight);
                                                         return {
-                                                                .data = output,
+                                                                .data = std::move(output),
                                                                 .stride = newStride,
                                                                 .width = newWidth,
                                                                 .height = newHeight,
@@ -134,7 +134,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_rotateImpl(JNIEnv *env, jobject
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -196,7 +196,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpAffineImpl(JNIEnv *env, jobj
                                                         transform.setTransform(affine);
                                                         transform.apply(output.data(), newStride, newWidth, newHeight);
                                                         return {
-                                                                .data = output,
+                                                                .data = std::move(output),
                                                                 .stride = newStride,
                                                                 .width = newWidth,
                                                                 .height = newHeight,
@@ -204,7 +204,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpAffineImpl(JNIEnv *env, jobj
                                                         };
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
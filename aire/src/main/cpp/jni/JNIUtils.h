@@ -31,6 +31,10 @@
 #pragma once
 
 #include <jni.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <android/log.h>
@@ -54,6 +58,22 @@ static jint throwException(JNIEnv *env, std::string &msg) {
     return env->ThrowNew(exClass, msg.c_str());
 }
 
+// Reads com.awxkee.aire.Scalar as RGBA bytes, components are expected in 0..255
+static std::array<uint8_t, 4> getScalarRGBA(JNIEnv *env, jobject scalar) {
+    std::array<uint8_t, 4> rgba = {0, 0, 0, 0};
+    if (scalar == nullptr) {
+        return rgba;
+    }
+    jclass scalarClass = env->GetObjectClass(scalar);
+    const char *names[4] = {"r", "g", "b", "a"};
+    for (int i = 0; i < 4; ++i) {
+        jfieldID field = env->GetFieldID(scalarClass, names[i], "D");
+        const double value = env->GetDoubleField(scalar, field);
+        rgba[i] = static_cast<uint8_t>(std::clamp(std::round(value), 0.0, 255.0));
+    }
+    return rgba;
+}
+
 #define LOG_TAG "Aire"
 #define LOG(severity, ...) ((void)__android_log_print(ANDROID_LOG_##severity, LOG_TAG, __VA_ARGS__))
 #define LOGE(...) LOG(ERROR, __VA_ARGS__)
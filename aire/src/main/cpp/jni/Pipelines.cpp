@@ -63,7 +63,7 @@ Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_removeShadowsPipelines(JNI
                                                                             width, height, kernelSize);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -99,7 +99,7 @@ Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_dehazeImpl(JNIEnv *env, jo
                                                                      width, height, radius, omega);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
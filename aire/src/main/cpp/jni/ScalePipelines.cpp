@@ -0,0 +1,113 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 31/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include <jni.h>
+#include "JNIUtils.h"
+#include "AcquireBitmapPixels.h"
+#include "MathUtils.hpp"
+#include "scale/Resize.h"
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_ScalePipelinesImpl_scaleImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                           jint dstWidth, jint dstHeight, jint scaleMode,
+                                                           jint colorSpace) {
+    try {
+        if (dstWidth <= 0 || dstHeight <= 0) {
+            std::string msg = "Width and height must be > 0 but received (" + std::to_string(dstWidth) + "," + std::to_string(dstHeight) + ")";
+            throw AireError(msg);
+        }
+        if (!aire::isResizeFunctionSupported(scaleMode)) {
+            std::string msg = "Resize function " + std::to_string(scaleMode) + " is not supported natively";
+            throw AireError(msg);
+        }
+        // Only gamma encoded values are resized here, other color spaces go through resizeImpl
+        if (colorSpace != 0) {
+            std::string msg = "Color space " + std::to_string(colorSpace) + " is not supported natively";
+            throw AireError(msg);
+        }
+        const auto function = static_cast<aire::ResizeFunction>(scaleMode);
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        formats.insert(formats.begin(), APF_F16);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [dstWidth, dstHeight, function](
+                                                        std::vector<uint8_t> &input, int stride,
+                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        int newStride = computeStride(dstWidth, sizeof(uint8_t), 4);
+                                                        std::vector<uint8_t> output(newStride * dstHeight);
+                                                        aire::resizeRGBA8888(input.data(), stride, width, height,
+                                                                             output.data(), newStride, dstWidth, dstHeight,
+                                                                             function);
+                                                        return {
+                                                                .data = std::move(output),
+                                                                .stride = newStride,
+                                                                .width = dstWidth,
+                                                                .height = dstHeight,
+                                                                .pixelFormat = fmt
+                                                        };
+                                                    } else if (fmt == APF_F16) {
+                                                        int newStride = computeStride(dstWidth, sizeof(uint16_t), 4);
+                                                        std::vector<uint8_t> output(newStride * dstHeight);
+                                                        aire::resizeRGBAF16(reinterpret_cast<const uint16_t *>(input.data()),
+                                                                            stride, width, height,
+                                                                            reinterpret_cast<uint16_t *>(output.data()),
+                                                                            newStride, dstWidth, dstHeight, function);
+                                                        return {
+                                                                .data = std::move(output),
+                                                                .stride = newStride,
+                                                                .width = dstWidth,
+                                                                .height = dstHeight,
+                                                                .pixelFormat = fmt
+                                                        };
+                                                    }
+                                                    return {
+                                                            .data = std::move(input),
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    } catch (std::bad_alloc &err) {
+        std::string exception = "Not enough memory to scale this image";
+        throwException(env, exception);
+        return nullptr;
+    }
+}
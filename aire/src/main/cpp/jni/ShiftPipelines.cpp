@@ -69,7 +69,7 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_tiltShiftImpl(JNIEnv *env, jobje
                                                     }
                                                     blurred.clear();
                                                     return {
-                                                            .data = output,
+                                                            .data = std::move(output),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -108,7 +108,7 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_glitchImpl(JNIEnv *env, jobject
                                                                            corruptionSize, corruptions, cShiftX, cShiftY);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -149,7 +149,7 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_horizontalWindStaggerImpl(JNIEnv
                                                         input = std::move(output);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -201,7 +201,7 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_horizontalTiltShiftImpl(JNIEnv *
                                                     }
                                                     blurred.clear();
                                                     return {
-                                                            .data = output,
+                                                            .data = std::move(output),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -31,38 +31,97 @@
 #include <jni.h>
 #include "color/ConvolveToneMapper.h"
 #include "color/Adjustments.h"
-#include <jni.h>
+#include "color/Gamut.h"
+#include "color/AutoAdjust.h"
 #include "AcquireBitmapPixels.h"
 #include "JNIUtils.h"
 
+/**
+ * Tone maps RGBA_8888, RGB_565 and RGBA_F16 in place keeping their storage
+ * and RGBA_1010102 into RGBA_8888, source transfer is taken from bitmap color space
+ */
+static jobject toneMapBitmap(JNIEnv *env, jobject bitmap, const std::function<void(const aire::ToneSurface &)> &toneMapper) {
+    aire::ToneTransfer transfer = aire::TONE_TRANSFER_SRGB;
+    switch (getBitmapColorSpaceId(env, bitmap)) {
+        case 1:  // LINEAR_SRGB
+        case 3:  // LINEAR_EXTENDED_SRGB
+        case 12: // ACES
+        case 13: // ACESCG
+            transfer = aire::TONE_TRANSFER_LINEAR;
+            break;
+        case 16: // BT2020_HLG
+            transfer = aire::TONE_TRANSFER_HLG;
+            break;
+        case 17: // BT2020_PQ
+            transfer = aire::TONE_TRANSFER_PQ;
+            break;
+        default:
+            break;
+    }
+
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    formats.insert(formats.begin(), APF_F16);
+    formats.insert(formats.begin(), APF_RGBA1010102);
+    formats.insert(formats.begin(), APF_565);
+    return AcquireBitmapPixels(env,
+                               bitmap,
+                               formats,
+                               true,
+                               [&](std::vector<uint8_t> &input, int stride,
+                                   int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                   if (fmt == APF_RGBA8888 || fmt == APF_F16 || fmt == APF_565) {
+                                       const auto format = static_cast<aire::TonePixelFormat>(getPixelStorage(fmt));
+                                       toneMapper({
+                                                          .source = input.data(),
+                                                          .sourceStride = stride,
+                                                          .sourceFormat = format,
+                                                          .transfer = fmt == APF_F16 ? transfer : aire::TONE_TRANSFER_SRGB,
+                                                          .destination = input.data(),
+                                                          .destinationStride = stride,
+                                                          .destinationFormat = format,
+                                                          .width = width,
+                                                          .height = height
+                                                  });
+                                   } else if (fmt == APF_RGBA1010102) {
+                                       const int newStride = width * 4;
+                                       std::vector<uint8_t> output(newStride * height);
+                                       toneMapper({
+                                                          .source = input.data(),
+                                                          .sourceStride = stride,
+                                                          .sourceFormat = aire::TONE_RGBA1010102,
+                                                          .transfer = transfer,
+                                                          .destination = output.data(),
+                                                          .destinationStride = newStride,
+                                                          .destinationFormat = aire::TONE_RGBA8888,
+                                                          .width = width,
+                                                          .height = height
+                                                  });
+                                       return {
+                                               .data = std::move(output),
+                                               .stride = newStride,
+                                               .width = width,
+                                               .height = height,
+                                               .pixelFormat = APF_RGBA8888
+                                       };
+                                   }
+                                   return {
+                                           .data = std::move(input),
+                                           .stride = stride,
+                                           .width = width,
+                                           .height = height,
+                                           .pixelFormat = fmt
+                                   };
+                               });
+}
+
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_logarithmicImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::logarithmic(input.data(),
-                                                                          stride, width,
-                                                                          height,
-                                                                          exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::logarithmic(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -74,30 +133,9 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_acesFilmicImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::acesFilm(input.data(),
-                                                                       stride, width,
-                                                                       height,
-                                                                       exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::acesFilm(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -109,30 +147,9 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_exposureImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::exposure(input.data(),
-                                                                       stride, width,
-                                                                       height,
-                                                                       exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::exposure(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -144,30 +161,9 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_hejlBurgessToneMappingImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::hejlBurgess(input.data(),
-                                                                          stride, width,
-                                                                          height,
-                                                                          exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::hejlBurgess(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -179,30 +175,9 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_hableFilmicImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height,  AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::hableFilmic(input.data(),
-                                                                          stride, width,
-                                                                          height,
-                                                                          exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::hableFilmic(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -214,36 +189,16 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_acesHillImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::acesHill(input.data(),
-                                                                       stride, width,
-                                                                       height,
-                                                                       exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::acesHill(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
         return nullptr;
     }
 }
+
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_monochromeImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloatArray javaColor, jfloat exposure) {
@@ -262,38 +217,16 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_monochromeImpl(JNIEnv *env, jobj
     env->ReleaseFloatArrayElements(javaColor, inputElements, 0);
 
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure, &color](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::monochrome(input.data(),
-                                                                         stride, width,
-                                                                         height,
-                                                                         color.data(),
-                                                                         exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        color.clear();
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::monochrome(surface, color.data(), exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
         return nullptr;
     }
 }
+
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_whiteBalanceImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat temperature, jfloat tint) {
@@ -315,7 +248,7 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_whiteBalanceImpl(JNIEnv *env, jo
                                                                          tint);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -332,31 +265,40 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_whiteBalanceImpl(JNIEnv *env, jo
 
 extern "C"
 JNIEXPORT jobject JNICALL
-Java_com_awxkee_aire_pipeline_TonePipelinesImpl_mobiusImpl(JNIEnv *env, jobject thiz,
-                                                           jobject bitmap,
-                                                           jfloat exposure,
-                                                           jfloat transition,
-                                                           jfloat peak) {
+Java_com_awxkee_aire_pipeline_TonePipelinesImpl_chromaticAdaptationImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                        jfloat sourceTemperature,
+                                                                        jfloat targetTemperature) {
     try {
+        TransferFunction transfer = TRANSFER_SRGB;
+        switch (getBitmapColorSpaceId(env, bitmap)) {
+            case 1:  // LINEAR_SRGB
+            case 3:  // LINEAR_EXTENDED_SRGB
+                transfer = TRANSFER_LINEAR;
+                break;
+            default:
+                break;
+        }
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        formats.insert(formats.begin(), APF_565);
+        formats.insert(formats.begin(), APF_RGBA1010102);
+        formats.insert(formats.begin(), APF_F16);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [exposure, transition, peak](
+                                                [sourceTemperature, targetTemperature, transfer](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::mobius(input.data(),
-                                                                       stride, width,
-                                                                       height,
-                                                                       exposure,
-                                                                       transition,
-                                                                       peak);
-                                                    }
+                                                    aire::chromaticAdaptation(input.data(),
+                                                                              stride, width,
+                                                                              height,
+                                                                              sourceTemperature,
+                                                                              targetTemperature,
+                                                                              getPixelStorage(fmt),
+                                                                              transfer);
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -371,34 +313,30 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_mobiusImpl(JNIEnv *env, jobject
     }
 }
 
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_TonePipelinesImpl_mobiusImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                           jfloat exposure,
+                                                           jfloat transition,
+                                                           jfloat peak) {
+    try {
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::mobius(surface, exposure, transition, peak);
+        });
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_uchimuraImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::uchimura(input.data(),
-                                                                     stride, width,
-                                                                     height,
-                                                                     exposure);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::uchimura(surface, exposure);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -410,31 +348,9 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_aldridgeImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure, jfloat cutoff) {
     try {
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
-        jobject newBitmap = AcquireBitmapPixels(env,
-                                                bitmap,
-                                                formats,
-                                                true,
-                                                [exposure, cutoff](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        aire::aldridge(input.data(),
-                                                                       stride, width,
-                                                                       height,
-                                                                       exposure,
-                                                                       cutoff);
-                                                    }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
-                                                });
-        return newBitmap;
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::aldridge(surface, exposure, cutoff);
+        });
     } catch (AireError &err) {
         std::string msg = err.what();
         throwException(env, msg);
@@ -445,6 +361,62 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_aldridgeImpl(JNIEnv *env, jobjec
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_TonePipelinesImpl_dragoImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat exposure, jfloat sdrWhitePoint) {
+    try {
+        return toneMapBitmap(env, bitmap, [&](const aire::ToneSurface &surface) {
+            aire::drago(surface, exposure, sdrWhitePoint);
+        });
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_awxkee_aire_pipeline_TonePipelinesImpl_estimateWhiteBalanceImpl(JNIEnv *env, jobject thiz, jobject bitmap, jint estimator) {
+    try {
+        aire::WhiteBalanceGains gains = {1.f, 1.f, 1.f};
+        ReadBitmapPixels(env, bitmap, [&](const uint8_t *data, int stride, int width, int height) {
+            gains = aire::estimateWhiteBalance(data, stride, width, height,
+                                               static_cast<aire::WhiteBalanceEstimator>(estimator));
+        });
+        const float values[3] = {gains.red, gains.green, gains.blue};
+        jfloatArray result = env->NewFloatArray(3);
+        if (result == nullptr) {
+            std::string memError = "Can't create float array";
+            throwException(env, memError);
+            return nullptr;
+        }
+        env->SetFloatArrayRegion(result, 0, 3, values);
+        return result;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_awxkee_aire_pipeline_TonePipelinesImpl_estimateExposureImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat key) {
+    try {
+        float exposure = 1.f;
+        ReadBitmapPixels(env, bitmap, [&](const uint8_t *data, int stride, int width, int height) {
+            exposure = aire::estimateExposure(data, stride, width, height, key);
+        });
+        return exposure;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return 1.f;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_TonePipelinesImpl_autoAdjustImpl(JNIEnv *env, jobject thiz, jobject bitmap, jboolean balance,
+                                                              jint estimator, jboolean exposure, jfloat key) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
@@ -452,18 +424,15 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_dragoImpl(JNIEnv *env, jobject t
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [exposure, sdrWhitePoint](
-                                                        std::vector<uint8_t> &input, int stride,
-                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                [&](std::vector<uint8_t> &input, int stride,
+                                                    int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                                     if (fmt == APF_RGBA8888) {
-                                                        aire::drago(input.data(),
-                                                                       stride, width,
-                                                                       height,
-                                                                       exposure,
-                                                                       sdrWhitePoint);
+                                                        aire::autoAdjust(input.data(), stride, width, height,
+                                                                         balance, static_cast<aire::WhiteBalanceEstimator>(estimator),
+                                                                         exposure, key);
                                                     }
                                                     return {
-                                                            .data = input,
+                                                            .data = std::move(input),
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -476,4 +445,4 @@ Java_com_awxkee_aire_pipeline_TonePipelinesImpl_dragoImpl(JNIEnv *env, jobject t
         throwException(env, msg);
         return nullptr;
     }
-}
\ No newline at end of file
+}
@@ -29,7 +29,12 @@
  */
 
 #include <jni.h>
+#include <android/bitmap.h>
 #include "conversion/yuv/YuvConverter.h"
+#include "conversion/yuv/RgbaToYuv.h"
+#include "conversion/yuv/Yuv10Converter.h"
+#include "conversion/yuv/YuvPipeline.h"
+#include "AcquireBitmapPixels.h"
 #include <vector>
 #include <string>
 #include "JNIUtils.h"
@@ -58,8 +63,6 @@ Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_Yuv420nV21ToRGBA(JNIEnv *env, job
             return nullptr;
         }
         int rgbaStride = (int) sizeof(uint8_t) * 4 * width;
-        vector<uint8_t> rgbaBuffer(rgbaStride * height);
-        aire::NV21ToRGBA(rgbaBuffer.data(), rgbaStride, width, height, yBufferAddress, yStride, uvBufferAddress, uvStride);
         auto dstBufferAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(dstBuffer));
         int dstLength = (int) env->GetDirectBufferCapacity(dstBuffer);
         if (dstBufferAddress == nullptr || (dstLength == -1 || dstLength != rgbaStride * height)) {
@@ -67,8 +70,12 @@ Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_Yuv420nV21ToRGBA(JNIEnv *env, job
             throwException(env, exception);
             return static_cast<jobject>(nullptr);
         }
-        std::copy(rgbaBuffer.begin(), rgbaBuffer.end(), dstBufferAddress);
+        aire::NV21ToRGBA(dstBufferAddress, rgbaStride, width, height, yBufferAddress, yStride, uvBufferAddress, uvStride);
         return dstBuffer;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return static_cast<jobject>(nullptr);
     } catch (std::bad_alloc &err) {
         std::string exception = "Not enough memory to decode this image";
         throwException(env, exception);
@@ -114,4 +121,376 @@ Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_Yuv420nV21ToBGRImpl(JNIEnv *env,
         throwException(env, exception);
         return static_cast<jobject>(nullptr);
     }
-}
\ No newline at end of file
+}
+static uint8_t *getYuvPlane(JNIEnv *env, jobject buffer, int stride, int rowBytes, int rows) {
+    if (buffer == nullptr) {
+        std::string errorString = "Plane buffer must not be null";
+        throw AireError(errorString);
+    }
+    auto address = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(buffer));
+    const int64_t length = env->GetDirectBufferCapacity(buffer);
+    if (!address || length <= 0) {
+        std::string errorString = "Only direct byte buffers are supported";
+        throw AireError(errorString);
+    }
+    if (stride < rowBytes || length < static_cast<int64_t>(stride) * (rows - 1) + rowBytes) {
+        std::string errorString = "Plane buffer is too small for the given stride and size";
+        throw AireError(errorString);
+    }
+    return address;
+}
+
+static aire::YuvLayout getYuvLayout(jint layout) {
+    if (layout < aire::YUV_LAYOUT_NV12 || layout > aire::YUV_LAYOUT_I444) {
+        std::string errorString = "Unknown YUV layout: " + std::to_string(layout);
+        throw AireError(errorString);
+    }
+    return static_cast<aire::YuvLayout>(layout);
+}
+
+static aire::YuvMatrix getYuvMatrix(jint matrix) {
+    if (matrix < aire::YUV_MATRIX_BT601 || matrix > aire::YUV_MATRIX_BT2020) {
+        std::string errorString = "Unknown YUV matrix: " + std::to_string(matrix);
+        throw AireError(errorString);
+    }
+    return static_cast<aire::YuvMatrix>(matrix);
+}
+
+static aire::YuvRange getYuvRange(jint range) {
+    if (range != aire::YUV_RANGE_LIMITED && range != aire::YUV_RANGE_FULL) {
+        std::string errorString = "Unknown YUV range: " + std::to_string(range);
+        throw AireError(errorString);
+    }
+    return static_cast<aire::YuvRange>(range);
+}
+
+static aire::YuvTransfer getYuvTransfer(jint transfer) {
+    if (transfer < aire::YUV_TRANSFER_NONE || transfer > aire::YUV_TRANSFER_HLG) {
+        std::string errorString = "Unknown YUV transfer: " + std::to_string(transfer);
+        throw AireError(errorString);
+    }
+    return static_cast<aire::YuvTransfer>(transfer);
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_yuvToBitmapImpl(JNIEnv *env, jobject thiz, jobject destination,
+                                                               jint layout, jobject yBuffer, jint yStride,
+                                                               jobject uBuffer, jint uStride,
+                                                               jobject vBuffer, jint vStride,
+                                                               jint width, jint height, jint matrix, jint range) {
+    try {
+        if (width <= 0 || height <= 0) {
+            std::string errorString = "Invalid image size";
+            throw AireError(errorString);
+        }
+        const auto yuvLayout = getYuvLayout(layout);
+        const auto yuvMatrix = getYuvMatrix(matrix);
+        const auto yuvRange = getYuvRange(range);
+        const bool interleaved = yuvLayout == aire::YUV_LAYOUT_NV12 || yuvLayout == aire::YUV_LAYOUT_NV21;
+        const int chromaWidth = yuvLayout == aire::YUV_LAYOUT_I444 ? width : (width + 1) / 2;
+        const int chromaHeight = yuvLayout == aire::YUV_LAYOUT_I444 || yuvLayout == aire::YUV_LAYOUT_I422
+                                 ? height : (height + 1) / 2;
+
+        const uint8_t *yPlane = getYuvPlane(env, yBuffer, yStride, width, height);
+        const uint8_t *uPlane = getYuvPlane(env, uBuffer, uStride, interleaved ? chromaWidth * 2 : chromaWidth, chromaHeight);
+        const uint8_t *vPlane = interleaved ? nullptr : getYuvPlane(env, vBuffer, vStride, chromaWidth, chromaHeight);
+
+        AndroidBitmapInfo info;
+        if (AndroidBitmap_getInfo(env, destination, &info) < 0) {
+            std::string errorString = "Cannot acquire destination bitmap info";
+            throw AireError(errorString);
+        }
+        if (info.width != static_cast<uint32_t>(width) || info.height != static_cast<uint32_t>(height)) {
+            std::string errorString = "Destination bitmap must have the same size as YUV image";
+            throw AireError(errorString);
+        }
+        if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 && info.format != ANDROID_BITMAP_FORMAT_RGBA_F16) {
+            std::string errorString = "Destination bitmap must be ARGB_8888 or RGBA_F16";
+            throw AireError(errorString);
+        }
+
+        void *addr = nullptr;
+        if (AndroidBitmap_lockPixels(env, destination, &addr) != 0) {
+            std::string errorString = "Cannot acquire destination bitmap pixels";
+            throw AireError(errorString);
+        }
+
+        const int stride = static_cast<int>(info.stride);
+        try {
+            if (info.format == ANDROID_BITMAP_FORMAT_RGBA_F16) {
+                auto dst = reinterpret_cast<uint16_t *>(addr);
+                switch (yuvLayout) {
+                    case aire::YUV_LAYOUT_NV12:
+                        aire::NV12ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride, yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_NV21:
+                        aire::NV21ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride, yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_I420:
+                        aire::I420ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                            yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_I422:
+                        aire::I422ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                            yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_I444:
+                        aire::I444ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                            yuvMatrix, yuvRange);
+                        break;
+                }
+            } else {
+                auto dst = reinterpret_cast<uint8_t *>(addr);
+                switch (yuvLayout) {
+                    case aire::YUV_LAYOUT_NV12:
+                        aire::NV12ToRGBA(dst, stride, width, height, yPlane, yStride, uPlane, uStride, yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_NV21:
+                        aire::NV21ToRGBA(dst, stride, width, height, yPlane, yStride, uPlane, uStride, yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_I420:
+                        aire::I420ToRGBA(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                         yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_I422:
+                        aire::I422ToRGBA(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                         yuvMatrix, yuvRange);
+                        break;
+                    case aire::YUV_LAYOUT_I444:
+                        aire::I444ToRGBA(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                         yuvMatrix, yuvRange);
+                        break;
+                }
+            }
+        } catch (AireError &err) {
+            AndroidBitmap_unlockPixels(env, destination);
+            throw;
+        }
+
+        if (AndroidBitmap_unlockPixels(env, destination) != 0) {
+            std::string errorString = "Cannot unlock destination bitmap pixels";
+            throw AireError(errorString);
+        }
+        return destination;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+static void encodeYuv(JNIEnv *env, const uint8_t *src, int srcStride, int width, int height, bool bgra,
+                      jint layout, jobject yBuffer, jint yStride, jobject uBuffer, jint uStride,
+                      jobject vBuffer, jint vStride, jint matrix, jint range) {
+    const auto yuvLayout = getYuvLayout(layout);
+    const auto yuvMatrix = getYuvMatrix(matrix);
+    const auto yuvRange = getYuvRange(range);
+    if (yuvLayout != aire::YUV_LAYOUT_NV12 && yuvLayout != aire::YUV_LAYOUT_NV21 &&
+        yuvLayout != aire::YUV_LAYOUT_I420) {
+        std::string errorString = "Only NV12, NV21 and I420 layouts are supported for encoding";
+        throw AireError(errorString);
+    }
+    const bool interleaved = yuvLayout != aire::YUV_LAYOUT_I420;
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    uint8_t *yPlane = getYuvPlane(env, yBuffer, yStride, width, height);
+    uint8_t *uPlane = getYuvPlane(env, uBuffer, uStride, interleaved ? chromaWidth * 2 : chromaWidth, chromaHeight);
+    uint8_t *vPlane = interleaved ? nullptr : getYuvPlane(env, vBuffer, vStride, chromaWidth, chromaHeight);
+
+    switch (yuvLayout) {
+        case aire::YUV_LAYOUT_NV12:
+            (bgra ? aire::BGRAToNV12 : aire::RGBAToNV12)(src, srcStride, width, height, yPlane, yStride,
+                                                         uPlane, uStride, yuvMatrix, yuvRange);
+            break;
+        case aire::YUV_LAYOUT_NV21:
+            (bgra ? aire::BGRAToNV21 : aire::RGBAToNV21)(src, srcStride, width, height, yPlane, yStride,
+                                                         uPlane, uStride, yuvMatrix, yuvRange);
+            break;
+        default:
+            (bgra ? aire::BGRAToI420 : aire::RGBAToI420)(src, srcStride, width, height, yPlane, yStride,
+                                                         uPlane, uStride, vPlane, vStride, yuvMatrix, yuvRange);
+            break;
+    }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_bitmapToYuvImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                               jint layout, jobject yBuffer, jint yStride,
+                                                               jobject uBuffer, jint uStride,
+                                                               jobject vBuffer, jint vStride,
+                                                               jint matrix, jint range) {
+    try {
+        ReadBitmapPixels(env, bitmap, [&](const uint8_t *data, int stride, int width, int height) {
+            encodeYuv(env, data, stride, width, height, false, layout, yBuffer, yStride, uBuffer, uStride,
+                      vBuffer, vStride, matrix, range);
+        });
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+    } catch (std::bad_alloc &err) {
+        std::string exception = "Not enough memory to encode this image";
+        throwException(env, exception);
+    }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_rgbaToYuvImpl(JNIEnv *env, jobject thiz, jobject srcBuffer,
+                                                             jint srcStride, jint width, jint height,
+                                                             jboolean bgra, jint layout,
+                                                             jobject yBuffer, jint yStride,
+                                                             jobject uBuffer, jint uStride,
+                                                             jobject vBuffer, jint vStride,
+                                                             jint matrix, jint range) {
+    try {
+        if (width <= 0 || height <= 0) {
+            std::string errorString = "Invalid image size";
+            throw AireError(errorString);
+        }
+        const uint8_t *src = getYuvPlane(env, srcBuffer, srcStride, width * 4, height);
+        encodeYuv(env, src, srcStride, width, height, bgra, layout, yBuffer, yStride, uBuffer, uStride,
+                  vBuffer, vStride, matrix, range);
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_yuv10ToBitmapImpl(JNIEnv *env, jobject thiz, jobject destination,
+                                                                 jboolean p010, jobject yBuffer, jint yStride,
+                                                                 jobject uBuffer, jint uStride,
+                                                                 jobject vBuffer, jint vStride,
+                                                                 jint width, jint height, jint matrix, jint range,
+                                                                 jint transfer) {
+    try {
+        if (width <= 0 || height <= 0) {
+            std::string errorString = "Invalid image size";
+            throw AireError(errorString);
+        }
+        const auto yuvMatrix = getYuvMatrix(matrix);
+        const auto yuvRange = getYuvRange(range);
+        const auto yuvTransfer = getYuvTransfer(transfer);
+        const int chromaWidth = (width + 1) / 2;
+        const int chromaHeight = (height + 1) / 2;
+        auto yPlane = reinterpret_cast<const uint16_t *>(getYuvPlane(env, yBuffer, yStride, width * 2, height));
+        auto uPlane = reinterpret_cast<const uint16_t *>(getYuvPlane(env, uBuffer, uStride,
+                                                                     p010 ? chromaWidth * 4 : chromaWidth * 2,
+                                                                     chromaHeight));
+        auto vPlane = p010 ? nullptr
+                           : reinterpret_cast<const uint16_t *>(getYuvPlane(env, vBuffer, vStride, chromaWidth * 2,
+                                                                            chromaHeight));
+
+        AndroidBitmapInfo info;
+        if (AndroidBitmap_getInfo(env, destination, &info) < 0) {
+            std::string errorString = "Cannot acquire destination bitmap info";
+            throw AireError(errorString);
+        }
+        if (info.width != static_cast<uint32_t>(width) || info.height != static_cast<uint32_t>(height)) {
+            std::string errorString = "Destination bitmap must have the same size as YUV image";
+            throw AireError(errorString);
+        }
+        if (info.format != ANDROID_BITMAP_FORMAT_RGBA_1010102 && info.format != ANDROID_BITMAP_FORMAT_RGBA_F16) {
+            std::string errorString = "Destination bitmap must be RGBA_1010102 or RGBA_F16";
+            throw AireError(errorString);
+        }
+
+        void *addr = nullptr;
+        if (AndroidBitmap_lockPixels(env, destination, &addr) != 0) {
+            std::string errorString = "Cannot acquire destination bitmap pixels";
+            throw AireError(errorString);
+        }
+
+        const int stride = static_cast<int>(info.stride);
+        try {
+            if (info.format == ANDROID_BITMAP_FORMAT_RGBA_F16) {
+                auto dst = reinterpret_cast<uint16_t *>(addr);
+                if (p010) {
+                    aire::P010ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride,
+                                        yuvMatrix, yuvRange, yuvTransfer);
+                } else {
+                    aire::I010ToRGBAF16(dst, stride, width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride,
+                                        yuvMatrix, yuvRange, yuvTransfer);
+                }
+            } else {
+                auto dst = reinterpret_cast<uint8_t *>(addr);
+                if (p010) {
+                    aire::P010ToRGBA1010102(dst, stride, width, height, yPlane, yStride, uPlane, uStride,
+                                            yuvMatrix, yuvRange, yuvTransfer);
+                } else {
+                    aire::I010ToRGBA1010102(dst, stride, width, height, yPlane, yStride, uPlane, uStride,
+                                            vPlane, vStride, yuvMatrix, yuvRange, yuvTransfer);
+                }
+            }
+        } catch (AireError &err) {
+            AndroidBitmap_unlockPixels(env, destination);
+            throw;
+        }
+
+        if (AndroidBitmap_unlockPixels(env, destination) != 0) {
+            std::string errorString = "Cannot unlock destination bitmap pixels";
+            throw AireError(errorString);
+        }
+        return destination;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    } catch (std::bad_alloc &err) {
+        std::string exception = "Not enough memory to decode this image";
+        throwException(env, exception);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_YuvPipelinesImpl_yuvChainImpl(JNIEnv *env, jobject thiz, jobject yBuffer,
+                                                            jint yStride, jobject uvBuffer, jint uvStride,
+                                                            jint width, jint height, jint layout, jint range,
+                                                            jintArray jTypes, jfloatArray jParams) {
+    try {
+        if (width <= 0 || height <= 0) {
+            std::string errorString = "Invalid image size";
+            throw AireError(errorString);
+        }
+        jsize opsCount = env->GetArrayLength(jTypes);
+        jsize paramsLength = env->GetArrayLength(jParams);
+        if (paramsLength != opsCount * aire::yuvOpMaxParams) {
+            std::string msg = "Each YUV operation must have exactly " + std::to_string(aire::yuvOpMaxParams) + " params";
+            throw AireError(msg);
+        }
+
+        std::vector<jint> types(opsCount);
+        std::vector<jfloat> params(paramsLength);
+        env->GetIntArrayRegion(jTypes, 0, opsCount, types.data());
+        env->GetFloatArrayRegion(jParams, 0, paramsLength, params.data());
+
+        std::vector<aire::YuvOp> ops(opsCount);
+        for (int i = 0; i < opsCount; ++i) {
+            if (types[i] < aire::YUV_OP_CONTRAST || types[i] > aire::YUV_OP_CHROMA_MATRIX) {
+                std::string msg = "Unknown YUV operation: " + std::to_string(types[i]);
+                throw AireError(msg);
+            }
+            ops[i].type = static_cast<aire::YuvOpType>(types[i]);
+            std::copy(params.begin() + i * aire::yuvOpMaxParams,
+                      params.begin() + (i + 1) * aire::yuvOpMaxParams, ops[i].params);
+        }
+
+        const int chromaWidth = (width + 1) / 2;
+        const int chromaHeight = (height + 1) / 2;
+        uint8_t *yPlane = getYuvPlane(env, yBuffer, yStride, width, height);
+        uint8_t *uvPlane = getYuvPlane(env, uvBuffer, uvStride, chromaWidth * 2, chromaHeight);
+        aire::yuvChain(yPlane, yStride, uvPlane, uvStride, width, height, getYuvLayout(layout), getYuvRange(range),
+                       ops);
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+    } catch (std::bad_alloc &err) {
+        std::string exception = "Not enough memory to process this frame";
+        throwException(env, exception);
+    }
+}
@@ -31,9 +31,10 @@
 #include "DehazeDarkChannel.h"
 #include <vector>
 #include "Eigen/Eigen"
-#include <queue>
+#include <algorithm>
 #include "hwy/highway.h"
 #include "MathUtils.hpp"
+#include "base/Histogram.h"
 
 namespace aire {
 
@@ -110,29 +111,20 @@ namespace aire {
     }
 
     float getAtmosphericLightEstimate(std::vector<uint8_t> &darkImage, int width, int height) {
-        std::priority_queue<uint8_t, vector<uint8_t>, std::greater<uint8_t>> TopValues;
+        uint32_t histogram[256];
+        planeHistogram(darkImage.data(), width, width, height, histogram);
 
-        //find out the 0.1% highest pixels in the dark channel
-        int TopAmounts = darkImage.size() * 0.01;
+        // mean of the 1% highest pixels in the dark channel
+        const int topAmounts = std::max(static_cast<int>(darkImage.size() * 0.01), 1);
+        int remaining = topAmounts;
         float total = 0;
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                const uint8_t *src = reinterpret_cast<const uint8_t *>(reinterpret_cast<const uint8_t *>(darkImage.data()) + width * i);
-                if (TopValues.size() < TopAmounts) {
-                    TopValues.push(src[j]);
-                    total += src[j];
-                } else {
-                    if (TopValues.top() >= src[j])
-                        continue;
-                    total -= TopValues.top();
-                    total += src[j];
-                    TopValues.pop();
-                    TopValues.push(src[j]);
-                }
-            }
+        for (int value = 255; value >= 0 && remaining > 0; --value) {
+            const int taken = std::min(static_cast<int>(histogram[value]), remaining);
+            total += static_cast<float>(value) * static_cast<float>(taken);
+            remaining -= taken;
         }
 
-        total /= TopAmounts;
+        total /= topAmounts;
         return total;
     }
 
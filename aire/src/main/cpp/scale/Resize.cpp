@@ -0,0 +1,419 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 31/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "scale/Resize.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "Resize.h"
+#include "sampler.h"
+#include "concurrency.hpp"
+#include "jni/JNIUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static constexpr int resizePrecision = 14;
+    static constexpr int resizeIntermediateBits = 6;
+
+    static HWY_INLINE int32_t ResizeWeightsPair(const int16_t *weights) {
+        int32_t pair;
+        std::memcpy(&pair, weights, sizeof(int32_t));
+        return pair;
+    }
+
+    /**
+     * Two taps are interleaved channel by channel, so one pairwise multiply-add applies both weights.
+     * Result is kept in Q6 i16 without clamping, so ringing of the first pass survives into the second one
+     */
+    HWY_INLINE void
+    ResizeHorizontalRGBA8888(const uint8_t *src, int16_t *dst, const int dstWidth, const int taps,
+                             const int *starts, const int16_t *weights) {
+        const FixedTag<uint8_t, 8> du8x8;
+        const FixedTag<int16_t, 8> di16x8;
+        const FixedTag<int16_t, 4> di16x4;
+        const FixedTag<int32_t, 4> di32x4;
+        alignas(16) static constexpr uint8_t pairShuffle[8] = {0, 4, 1, 5, 2, 6, 3, 7};
+        const auto shuffle = LoadU(du8x8, pairShuffle);
+        const auto rounding = Set(di32x4, 1 << (resizePrecision - resizeIntermediateBits - 1));
+
+        for (int x = 0; x < dstWidth; ++x) {
+            const uint8_t *pixels = src + starts[x] * 4;
+            const int16_t *w = weights + x * taps;
+            auto acc = rounding;
+            for (int j = 0; j < taps; j += 2) {
+                const auto pair = PromoteTo(di16x8, TableLookupBytes(LoadU(du8x8, pixels + j * 4), shuffle));
+                const auto weightsPair = BitCast(di16x8, Set(di32x4, ResizeWeightsPair(w + j)));
+                acc = Add(acc, WidenMulPairwiseAdd(di32x4, pair, weightsPair));
+            }
+            StoreU(DemoteTo(di16x4, ShiftRight<resizePrecision - resizeIntermediateBits>(acc)), di16x4, dst + x * 4);
+        }
+    }
+
+    // Rows are padded to 64 lanes, only the tail of destination goes through a temporary
+    HWY_INLINE void
+    ResizeVerticalRGBA8888(const int16_t **rows, const int16_t *weights, const int taps, uint8_t *dst,
+                           const int length) {
+        const FixedTag<uint8_t, 16> du8;
+        const FixedTag<int16_t, 8> di16;
+        const FixedTag<int32_t, 4> di32;
+        constexpr int shift = resizePrecision + resizeIntermediateBits;
+        const auto rounding = Set(di32, 1 << (shift - 1));
+
+        for (int x = 0; x < length; x += 16) {
+            auto acc0 = rounding, acc1 = rounding, acc2 = rounding, acc3 = rounding;
+            for (int k = 0; k < taps; k += 2) {
+                const auto w = BitCast(di16, Set(di32, ResizeWeightsPair(weights + k)));
+                const auto a0 = LoadU(di16, rows[k] + x);
+                const auto a1 = LoadU(di16, rows[k] + x + 8);
+                const auto b0 = LoadU(di16, rows[k + 1] + x);
+                const auto b1 = LoadU(di16, rows[k + 1] + x + 8);
+                acc0 = Add(acc0, WidenMulPairwiseAdd(di32, InterleaveLower(di16, a0, b0), w));
+                acc1 = Add(acc1, WidenMulPairwiseAdd(di32, InterleaveUpper(di16, a0, b0), w));
+                acc2 = Add(acc2, WidenMulPairwiseAdd(di32, InterleaveLower(di16, a1, b1), w));
+                acc3 = Add(acc3, WidenMulPairwiseAdd(di32, InterleaveUpper(di16, a1, b1), w));
+            }
+            const auto v01 = OrderedDemote2To(di16, ShiftRight<shift>(acc0), ShiftRight<shift>(acc1));
+            const auto v23 = OrderedDemote2To(di16, ShiftRight<shift>(acc2), ShiftRight<shift>(acc3));
+            const auto result = OrderedDemote2To(du8, v01, v23);
+            if (x + 16 <= length) {
+                StoreU(result, du8, dst + x);
+            } else {
+                uint8_t tail[16];
+                StoreU(result, du8, tail);
+                std::copy(tail, tail + length - x, dst + x);
+            }
+        }
+    }
+
+    HWY_INLINE void
+    ResizeHorizontalRGBAF16(const uint16_t *src, float *dst, const int dstWidth, const int taps,
+                            const int *starts, const float *weights) {
+        const FixedTag<float, 4> df;
+        const Rebind<uint16_t, decltype(df)> du16;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+
+        for (int x = 0; x < dstWidth; ++x) {
+            const uint16_t *pixels = src + starts[x] * 4;
+            const float *w = weights + x * taps;
+            auto acc = Zero(df);
+            for (int j = 0; j < taps; ++j) {
+                acc = MulAdd(Set(df, w[j]), PromoteTo(df, BitCast(dh, LoadU(du16, pixels + j * 4))), acc);
+            }
+            StoreU(acc, df, dst + x * 4);
+        }
+    }
+
+    HWY_INLINE void
+    ResizeVerticalRGBAF16(const float **rows, const float *weights, const int taps, uint16_t *dst,
+                          const int length) {
+        const ScalableTag<float> df;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        const Rebind<uint16_t, decltype(df)> du16;
+        const int lanes = static_cast<int>(Lanes(df));
+
+        for (int x = 0; x < length; x += lanes) {
+            auto acc = Zero(df);
+            for (int k = 0; k < taps; ++k) {
+                acc = MulAdd(Set(df, weights[k]), LoadU(df, rows[k] + x), acc);
+            }
+            const auto result = BitCast(du16, DemoteTo(dh, acc));
+            if (x + lanes <= length) {
+                StoreU(result, du16, dst + x);
+            } else {
+                uint16_t tail[HWY_MAX_BYTES / sizeof(float)];
+                StoreU(result, du16, tail);
+                std::copy(tail, tail + length - x, dst + x);
+            }
+        }
+    }
+
+    /**
+     * Every band of output rows keeps ring of tapsY horizontally resized source rows, windows only move down,
+     * so each source row of the band is resized horizontally once and row k of a window lives in slot row % tapsY
+     */
+    template<typename T, typename R, typename W>
+    void ResizeImpl(const T *src, const int srcStride, const int srcWidth, const int srcHeight,
+                    T *dst, const int dstStride, const int dstWidth, const int dstHeight,
+                    const int tapsX, const int *startsX, const W *weightsX,
+                    const int tapsY, const int *startsY, const W *weightsY) {
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    srcHeight * srcWidth / (256 * 256)), 1, 12);
+        const int rowLength = dstWidth * 4;
+        // Enough for the widest vector of vertical pass
+        const int ringStride = (rowLength + 63) / 64 * 64;
+
+        concurrency::parallel_for_segment(threadCount, dstHeight, [&](int start, int end) {
+            if (start >= end) {
+                return;
+            }
+            std::vector<R> ring(ringStride * tapsY);
+            std::vector<int> ringRows(tapsY, -1);
+            std::vector<const R *> rows(tapsY);
+            // Source narrower than the window is read from zero padded copy
+            std::vector<T> padded(srcWidth < tapsX ? tapsX * 4 : 0);
+
+            for (int y = start; y < end; ++y) {
+                for (int k = 0; k < tapsY; ++k) {
+                    const int srcY = std::min(startsY[y] + k, srcHeight - 1);
+                    const int slot = srcY % tapsY;
+                    R *ringRow = ring.data() + slot * ringStride;
+                    if (ringRows[slot] != srcY) {
+                        auto srcRow = reinterpret_cast<const T *>(reinterpret_cast<const uint8_t *>(src) +
+                                                                  srcY * srcStride);
+                        if (!padded.empty()) {
+                            std::copy(srcRow, srcRow + srcWidth * 4, padded.begin());
+                            srcRow = padded.data();
+                        }
+                        if constexpr (std::is_same<T, uint16_t>::value) {
+                            ResizeHorizontalRGBAF16(srcRow, ringRow, dstWidth, tapsX, startsX, weightsX);
+                        } else {
+                            ResizeHorizontalRGBA8888(srcRow, ringRow, dstWidth, tapsX, startsX, weightsX);
+                        }
+                        ringRows[slot] = srcY;
+                    }
+                    rows[k] = ringRow;
+                }
+
+                auto dstRow = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(dst) + y * dstStride);
+                if constexpr (std::is_same<T, uint16_t>::value) {
+                    ResizeVerticalRGBAF16(rows.data(), weightsY + y * tapsY, tapsY, dstRow, rowLength);
+                } else {
+                    ResizeVerticalRGBA8888(rows.data(), weightsY + y * tapsY, tapsY, dstRow, rowLength);
+                }
+            }
+        });
+    }
+
+    void ResizeRGBA8888HWY(const uint8_t *src, const int srcStride, const int srcWidth, const int srcHeight,
+                           uint8_t *dst, const int dstStride, const int dstWidth, const int dstHeight,
+                           const int tapsX, const int *startsX, const int16_t *weightsX,
+                           const int tapsY, const int *startsY, const int16_t *weightsY) {
+        ResizeImpl<uint8_t, int16_t, int16_t>(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth,
+                                              dstHeight, tapsX, startsX, weightsX, tapsY, startsY, weightsY);
+    }
+
+    void ResizeRGBAF16HWY(const uint16_t *src, const int srcStride, const int srcWidth, const int srcHeight,
+                          uint16_t *dst, const int dstStride, const int dstWidth, const int dstHeight,
+                          const int tapsX, const int *startsX, const float *weightsX,
+                          const int tapsY, const int *startsY, const float *weightsY) {
+        ResizeImpl<uint16_t, float, float>(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth,
+                                           dstHeight, tapsX, startsX, weightsX, tapsY, startsY, weightsY);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(ResizeRGBA8888HWY);
+    HWY_EXPORT(ResizeRGBAF16HWY);
+
+    bool isResizeFunctionSupported(int function) {
+        switch (function) {
+            case RESIZE_BILINEAR:
+            case RESIZE_NEAREST:
+            case RESIZE_CUBIC:
+            case RESIZE_MITCHELL_NETRAVALLI:
+            case RESIZE_CATMULL_ROM:
+            case RESIZE_HERMITE:
+            case RESIZE_BSPLINE:
+            case RESIZE_HANN:
+            case RESIZE_BICUBIC:
+            case RESIZE_BOX:
+            case RESIZE_LANCZOS2:
+            case RESIZE_LANCZOS3:
+            case RESIZE_LANCZOS4:
+            case RESIZE_LANCZOS6:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static float resizeFilterSupport(const ResizeFunction function) {
+        switch (function) {
+            case RESIZE_NEAREST:
+            case RESIZE_BOX:
+                return 0.5f;
+            case RESIZE_BILINEAR:
+                return 1.f;
+            case RESIZE_HANN:
+            case RESIZE_LANCZOS3:
+                return 3.f;
+            case RESIZE_LANCZOS4:
+                return 4.f;
+            case RESIZE_LANCZOS6:
+                return 6.f;
+            default:
+                return 2.f;
+        }
+    }
+
+    static float resizeFilter(const ResizeFunction function, const float x) {
+        switch (function) {
+            case RESIZE_BILINEAR:
+                return BilinearFilter(x);
+            case RESIZE_CUBIC:
+                return SimpleCubic(x);
+            case RESIZE_MITCHELL_NETRAVALLI:
+                return MitchellNetravalli(x);
+            case RESIZE_CATMULL_ROM:
+                return CatmullRom(x);
+            case RESIZE_HERMITE:
+                return CubicHermite(x);
+            case RESIZE_BSPLINE:
+                return BSpline(x);
+            case RESIZE_HANN:
+                return HannWindow(x);
+            case RESIZE_BICUBIC:
+                return BiCubicSpline(x);
+            case RESIZE_BOX:
+                return x > -0.5f && x <= 0.5f ? 1.f : 0.f;
+            case RESIZE_LANCZOS2:
+                return LanczosWindow(x, 2.f);
+            case RESIZE_LANCZOS3:
+                return Lanczos3Sinc(x);
+            case RESIZE_LANCZOS4:
+                return LanczosWindow(x, 4.f);
+            case RESIZE_LANCZOS6:
+                return LanczosWindow(x, 6.f);
+            default:
+                return 0.f;
+        }
+    }
+
+    template<typename W>
+    struct ResizeWeights {
+        int taps;
+        std::vector<int> starts;
+        std::vector<W> weights;
+    };
+
+    /**
+     * Window of every output sample is moved inside the source, so all windows have the same even count of taps
+     * and vectors never read out of the row. Samples outside of the filter support get zero weight.
+     * Q14 weights are rounded and the rounding error goes to the largest weight, so flat areas stay exact
+     */
+    template<typename W>
+    static ResizeWeights<W> computeResizeWeights(const int srcSize, const int dstSize, const ResizeFunction function) {
+        const float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+        const float filterScale = std::max(scale, 1.f);
+        const float support = function == RESIZE_NEAREST ? 0.5f : resizeFilterSupport(function) * filterScale;
+
+        ResizeWeights<W> result;
+        int taps = static_cast<int>(std::ceil(support)) * 2 + 1;
+        result.taps = taps + (taps & 1);
+        result.starts.resize(dstSize);
+        result.weights.resize(dstSize * result.taps, 0);
+        std::vector<float> window(result.taps);
+
+        for (int i = 0; i < dstSize; ++i) {
+            const float center = (static_cast<float>(i) + 0.5f) * scale;
+            int first = std::max(static_cast<int>(std::floor(center - support + 0.5f)), 0);
+            int last = std::min(static_cast<int>(std::floor(center + support + 0.5f)), srcSize);
+            const int nearest = std::clamp(static_cast<int>(center), 0, srcSize - 1);
+            if (function == RESIZE_NEAREST || last <= first) {
+                first = nearest;
+                last = nearest + 1;
+            }
+            const int start = std::max(std::min(first, srcSize - result.taps), 0);
+
+            std::fill(window.begin(), window.end(), 0.f);
+            float sum = 0.f;
+            for (int j = first; j < last; ++j) {
+                const float weight = function == RESIZE_NEAREST ? 1.f :
+                                     resizeFilter(function, (static_cast<float>(j) + 0.5f - center) / filterScale);
+                window[j - start] = weight;
+                sum += weight;
+            }
+            if (sum == 0.f) {
+                window[nearest - start] = 1.f;
+                sum = 1.f;
+            }
+
+            result.starts[i] = start;
+            W *weights = result.weights.data() + i * result.taps;
+            if constexpr (std::is_same<W, int16_t>::value) {
+                int fixedSum = 0, largest = 0;
+                for (int j = 0; j < result.taps; ++j) {
+                    weights[j] = static_cast<int16_t>(std::lround(window[j] / sum * 16384.f));
+                    fixedSum += weights[j];
+                    if (std::abs(weights[j]) > std::abs(weights[largest])) {
+                        largest = j;
+                    }
+                }
+                weights[largest] = static_cast<int16_t>(weights[largest] + 16384 - fixedSum);
+            } else {
+                for (int j = 0; j < result.taps; ++j) {
+                    weights[j] = window[j] / sum;
+                }
+            }
+        }
+        return result;
+    }
+
+    void resizeRGBA8888(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+                        uint8_t *dst, int dstStride, int dstWidth, int dstHeight, ResizeFunction function) {
+        if (!isResizeFunctionSupported(function)) {
+            throw AireError("Resize function " + std::to_string(static_cast<int>(function)) + " is not supported");
+        }
+        const auto horizontal = computeResizeWeights<int16_t>(srcWidth, dstWidth, function);
+        const auto vertical = computeResizeWeights<int16_t>(srcHeight, dstHeight, function);
+        HWY_DYNAMIC_DISPATCH(ResizeRGBA8888HWY)(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth,
+                                                dstHeight, horizontal.taps, horizontal.starts.data(),
+                                                horizontal.weights.data(), vertical.taps, vertical.starts.data(),
+                                                vertical.weights.data());
+    }
+
+    void resizeRGBAF16(const uint16_t *src, int srcStride, int srcWidth, int srcHeight,
+                       uint16_t *dst, int dstStride, int dstWidth, int dstHeight, ResizeFunction function) {
+        if (!isResizeFunctionSupported(function)) {
+            throw AireError("Resize function " + std::to_string(static_cast<int>(function)) + " is not supported");
+        }
+        const auto horizontal = computeResizeWeights<float>(srcWidth, dstWidth, function);
+        const auto vertical = computeResizeWeights<float>(srcHeight, dstHeight, function);
+        HWY_DYNAMIC_DISPATCH(ResizeRGBAF16HWY)(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth,
+                                               dstHeight, horizontal.taps, horizontal.starts.data(),
+                                               horizontal.weights.data(), vertical.taps, vertical.starts.data(),
+                                               vertical.weights.data());
+    }
+}
+#endif
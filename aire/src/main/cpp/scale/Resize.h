@@ -0,0 +1,68 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 31/03/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace aire {
+
+    // Same values as com.awxkee.aire.ResizeFunction, only filters from sampler.h are available natively
+    enum ResizeFunction {
+        RESIZE_BILINEAR = 0,
+        RESIZE_NEAREST = 1,
+        RESIZE_CUBIC = 2,
+        RESIZE_MITCHELL_NETRAVALLI = 3,
+        RESIZE_CATMULL_ROM = 4,
+        RESIZE_HERMITE = 5,
+        RESIZE_BSPLINE = 6,
+        RESIZE_HANN = 7,
+        RESIZE_BICUBIC = 8,
+        RESIZE_BOX = 24,
+        RESIZE_LANCZOS2 = 26,
+        RESIZE_LANCZOS3 = 27,
+        RESIZE_LANCZOS4 = 28,
+        RESIZE_LANCZOS6 = 46
+    };
+
+    bool isResizeFunctionSupported(int function);
+
+    /**
+     * Separable resize: weights for every output column and row are computed once, then each band of output rows
+     * runs horizontal pass into a ring of intermediate rows and vertical pass from it.
+     * RGBA8888 uses Q14 weights, RGBA F16 uses f32 weights. Filters are stretched by the scale factor when
+     * downscaling. Premultiplied pixels are resized as they are, so transparent colors don't bleed
+     */
+    void resizeRGBA8888(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+                        uint8_t *dst, int dstStride, int dstWidth, int dstHeight, ResizeFunction function);
+
+    void resizeRGBAF16(const uint16_t *src, int srcStride, int srcWidth, int srcHeight,
+                       uint16_t *dst, int dstStride, int dstWidth, int dstHeight, ResizeFunction function);
+}
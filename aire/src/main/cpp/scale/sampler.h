@@ -186,7 +186,7 @@ static inline T Lanczos3Sinc(T x) {
 
 template<typename T>
 static inline T BilinearFilter(T x) {
-    x = ::abs(x);
+    x = std::abs(x);
     if (x < static_cast<T>(1.0f)) {
         return static_cast<T>(1.0f) - x;
     } else {
@@ -56,6 +56,27 @@ interface BasePipelines {
         kernelHeight: Int
     ): Bitmap
 
+    /**
+     *  Performs morphology on the image in a single native pass, composite operations chain erosion
+     *  and dilation over cache sized tiles and subtract in the last pass
+     *
+     * @param morphOp - See [MorphOp] for more info
+     * @param morphOpMode - See [MorphOpMode] for more info
+     * @param borderMode - Edge handling mode
+     * @param borderScalar - If [EdgeMode.CONSTANT] selected then this scalar value be used
+     * @param kernel - kernel is arbitrary shaped, non zero elements belong to it
+     */
+    fun fusedMorphology(
+        bitmap: Bitmap,
+        morphOp: MorphOp,
+        morphOpMode: MorphOpMode,
+        borderMode: EdgeMode,
+        borderScalar: Scalar,
+        kernel: IntArray,
+        kernelWidth: Int,
+        kernelHeight: Int
+    ): Bitmap
+
     fun getBokehKernel(
         @IntRange(from = 3) kernelSize: Int,
         @IntRange(from = 3) sides: Int = 6,
@@ -97,7 +118,18 @@ interface BasePipelines {
 
     fun emboss(bitmap: Bitmap, intensity: Float): Bitmap
 
-    fun grain(bitmap: Bitmap, intensity: Float = 0.75f): Bitmap
+    /**
+     * @param seed - same seed produces same grain
+     * @param luminanceResponse - 0...1, concentrates grain in mid tones
+     * @param chromaIntensity - colored grain strength, 0 keeps grain monochrome
+     */
+    fun grain(
+        bitmap: Bitmap,
+        intensity: Float = 0.75f,
+        seed: Long = System.nanoTime(),
+        @FloatRange(from = 0.0, to = 1.0) luminanceResponse: Float = 0f,
+        chromaIntensity: Float = 0f,
+    ): Bitmap
 
     fun sharpness(bitmap: Bitmap, kernelSize: Int): Bitmap
 
@@ -154,4 +186,16 @@ interface BasePipelines {
      * @param colorMatrix - Only 3x3 matrix allowed, some matrices are available in `ColorMatrices`
      */
     fun colorMatrix(bitmap: Bitmap, colorMatrix: FloatArray): Bitmap
+
+    /**
+     * Applies 3D LUT with tetrahedral interpolation, RGBA_8888 and RGBA_F16 are supported
+     * @param lut - contents of .cube or .3dl file, parsed LUTs are cached by content
+     */
+    fun lut3D(bitmap: Bitmap, lut: ByteArray): Bitmap
+
+    /**
+     * Applies chain of per pixel operations in a single pass, affine operations and curves are fused
+     * into a fixed point matrix, other chains are baked into a 33x33x33 LUT once per set of parameters
+     */
+    fun pointwise(bitmap: Bitmap, ops: List<PointwiseOp>): Bitmap
 }
\ No newline at end of file
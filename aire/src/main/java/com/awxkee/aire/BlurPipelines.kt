@@ -96,6 +96,20 @@ interface BlurPipelines {
         rangeSigma: Float
     ): Bitmap
 
+    /**
+     * Edge preserving blur on a downsampled bilateral grid, cost does not depend on spatial sigma.
+     * RGBA_8888 and RGBA_F16 are processed natively
+     * @param spatialSigma - spatial sigma in pixels, must be > 0
+     * @param rangeSigma - intensity sigma in 0...255 units, must be > 0
+     * @param linearLight - blend in linear light instead of gamma encoded sRGB
+     */
+    fun bilateralGridBlur(
+        bitmap: Bitmap,
+        spatialSigma: Float,
+        rangeSigma: Float,
+        linearLight: Boolean = false,
+    ): Bitmap
+
     /***
      * Performs motion blur on the image
      *
@@ -265,6 +265,58 @@ interface EffectsPipelines {
         @IntRange(from = 2) binsCount: Int
     ): Bitmap
 
+    /**
+     * Native histogram equalization
+     * @param colorspace - equalized channel, LUMA ignores binsCount
+     * @param binsCount - Preferable 128
+     * @throws Exception if bins count is not in 2...4096
+     */
+    fun equalizeHistogram(
+        bitmap: Bitmap,
+        colorspace: EqualizeColorspace = EqualizeColorspace.LUMA,
+        @IntRange(from = 2, to = 4096) binsCount: Int = 128
+    ): Bitmap
+
+    /**
+     * Native equalization of each tile on its own without blending between tiles
+     * @throws Exception if horizontal grid or vertical <= 0
+     */
+    fun equalizeHistogramTiles(
+        bitmap: Bitmap,
+        gridSizeHorizontal: Int = 8,
+        gridSizeVertical: Int = 8
+    ): Bitmap
+
+    /**
+     * Native sliding window equalization, window is image size over grid size centered at each pixel
+     * @param colorspace - equalized channel, LUMA ignores binsCount
+     * @param binsCount - Preferable 128
+     * @throws Exception if horizontal grid or vertical <= 0 or bins count is not in 2...4096
+     */
+    fun equalizeHistogramSliding(
+        bitmap: Bitmap,
+        gridSizeHorizontal: Int = 3,
+        gridSizeVertical: Int = 3,
+        colorspace: EqualizeColorspace = EqualizeColorspace.LUMA,
+        @IntRange(from = 2, to = 4096) binsCount: Int = 128
+    ): Bitmap
+
+    /**
+     * Native contrast limited adaptive equalization, tile mappings are blended bilinearly
+     * @param threshold - clip limit in multiples of uniform bin height
+     * @param colorspace - equalized channel, LUMA ignores binsCount
+     * @param binsCount - Preferable 128
+     * @throws Exception if horizontal grid or vertical <= 0 or bins count is not in 2...4096
+     */
+    fun contrastLimitedEqualize(
+        bitmap: Bitmap,
+        @FloatRange(from = 0.01) threshold: Float = 0.5f,
+        gridSizeHorizontal: Int = 8,
+        gridSizeVertical: Int = 8,
+        colorspace: EqualizeColorspace = EqualizeColorspace.LUMA,
+        @IntRange(from = 2, to = 4096) binsCount: Int = 128
+    ): Bitmap
+
     /**
      * Copies palette from one image to another using statistical method
      * lαβ best in common over LAB, OKLAB and LUV
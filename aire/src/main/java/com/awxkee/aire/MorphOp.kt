@@ -38,12 +38,12 @@ enum class MorphOp(internal val value: Int) {
     ERODE(1),
 
     /**
-     *  It is the dilation followed by erosion
+     *  It is the erosion followed by dilation
      */
     OPENING(2),
 
     /**
-     *  It is the erosion followed by dilation
+     *  It is the dilation followed by erosion
      */
     CLOSING(3),
 
@@ -0,0 +1,78 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 3/23/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+package com.awxkee.aire
+
+/**
+ * Per pixel operation for [BasePipelines.pointwise], chain of them is executed in a single pass.
+ * Contrast, brightness, saturation, color matrix, grayscale, gamma and threshold are fused into one matrix
+ * with curves, chains with other operations are baked into 3D LUT
+ */
+sealed class PointwiseOp(internal val type: Int, internal val params: FloatArray) {
+    class Exposure(exposure: Float) : PointwiseOp(0, floatArrayOf(exposure))
+    class WhiteBalance(temperature: Float = 1f, tint: Float = 0f) :
+        PointwiseOp(1, floatArrayOf(temperature, tint))
+
+    class Saturation(saturation: Float) : PointwiseOp(2, floatArrayOf(saturation))
+    class Contrast(gain: Float) : PointwiseOp(3, floatArrayOf(gain))
+    class Brightness(bias: Float) : PointwiseOp(4, floatArrayOf(bias))
+    class Gamma(gamma: Float) : PointwiseOp(5, floatArrayOf(gamma))
+    class Vibrance(vibrance: Float) : PointwiseOp(6, floatArrayOf(vibrance))
+
+    /**
+     * @param colorMatrix - Only 3x3 matrix allowed, some matrices are available in `ColorMatrices`
+     */
+    class ColorMatrix(colorMatrix: FloatArray) : PointwiseOp(7, colorMatrix.copyOf(9))
+    class Grayscale(rPrimary: Float = 0.299f, gPrimary: Float = 0.587f, bPrimary: Float = 0.114f) :
+        PointwiseOp(8, floatArrayOf(rPrimary, gPrimary, bPrimary))
+
+    class LogarithmicToneMapping(exposure: Float = 1.0f) : PointwiseOp(9, floatArrayOf(exposure))
+    class AcesFilmicToneMapping(exposure: Float = 1.0f) : PointwiseOp(10, floatArrayOf(exposure))
+    class HejlBurgessToneMapping(exposure: Float = 1.0f) : PointwiseOp(11, floatArrayOf(exposure))
+    class HableFilmicToneMapping(exposure: Float = 1.0f) : PointwiseOp(12, floatArrayOf(exposure))
+    class AcesHillToneMapping(exposure: Float = 1.0f) : PointwiseOp(13, floatArrayOf(exposure))
+    class Monochrome(color: FloatArray, exposure: Float = 1.0f) :
+        PointwiseOp(14, floatArrayOf(color[0], color[1], color[2], color[3], exposure))
+
+    class Mobius(exposure: Float = 1.0f, transition: Float = 0.9f, peak: Float = 1.0f) :
+        PointwiseOp(15, floatArrayOf(exposure, transition, peak))
+
+    class Uchimura(exposure: Float = 1.0f) : PointwiseOp(16, floatArrayOf(exposure))
+    class Aldridge(exposure: Float = 1.0f, cutoff: Float = 0.025f) :
+        PointwiseOp(17, floatArrayOf(exposure, cutoff))
+
+    class Drago(exposure: Float = 1.0f, sdrWhitePoint: Float = 250.0f) :
+        PointwiseOp(18, floatArrayOf(exposure, sdrWhitePoint))
+
+    /**
+     * Each of R, G, B becomes 255 if it is greater than level and 0 otherwise
+     */
+    class Threshold(level: Int) : PointwiseOp(19, floatArrayOf(level.toFloat()))
+}
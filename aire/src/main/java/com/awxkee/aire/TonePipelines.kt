@@ -49,6 +49,17 @@ interface TonePipelines {
 
     fun whiteBalance(bitmap: Bitmap, temperature: Float = 1f, tint: Float = 0.0f): Bitmap
 
+    /**
+     * White balance by Bradford chromatic adaptation
+     * @param sourceTemperature - color temperature in Kelvin of the light the image was taken under
+     * @param targetTemperature - color temperature in Kelvin of the white to adapt to, default is D65
+     */
+    fun chromaticAdaptation(
+        bitmap: Bitmap,
+        sourceTemperature: Float,
+        targetTemperature: Float = 6504f
+    ): Bitmap
+
     fun mobius(
         bitmap: Bitmap,
         exposure: Float = 1.0f,
@@ -61,4 +72,30 @@ interface TonePipelines {
     fun aldridge(bitmap: Bitmap, exposure: Float = 1.0f, cutoff: Float = 0.025f): Bitmap
 
     fun drago(bitmap: Bitmap, exposure: Float = 1.0f, sdrWhitePoint: Float = 250.0f): Bitmap
+
+    /**
+     * Estimates illuminant on a decimated sample grid
+     * @return linear RGB gains [r, g, b] that neutralize the illuminant, green is always 1
+     */
+    fun estimateWhiteBalance(
+        bitmap: Bitmap,
+        estimator: WhiteBalanceEstimator = WhiteBalanceEstimator.GRAY_WORLD
+    ): FloatArray
+
+    /**
+     * Estimates linear exposure multiplier that brings log average luminance to [key]
+     * without pushing 99th percentile of luminance to clipping
+     */
+    fun estimateExposure(bitmap: Bitmap, key: Float = 0.18f): Float
+
+    /**
+     * Estimates and applies white balance and exposure in a single pass
+     */
+    fun autoAdjust(
+        bitmap: Bitmap,
+        whiteBalance: Boolean = true,
+        estimator: WhiteBalanceEstimator = WhiteBalanceEstimator.GRAY_WORLD,
+        exposure: Boolean = true,
+        key: Float = 0.18f
+    ): Bitmap
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 30/03/24, 5:24 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+package com.awxkee.aire
+
+/**
+ * Operation for [YuvPipelines.processNV12] and [YuvPipelines.processNV21] executed directly on YUV planes.
+ * Contrast, brightness, gamma, sharpen, denoise and CLAHE change only luma, the others change only chroma
+ */
+sealed class YuvOp(internal val type: Int, internal val params: FloatArray) {
+    class Contrast(gain: Float) : YuvOp(0, floatArrayOf(gain))
+    class Brightness(bias: Float) : YuvOp(1, floatArrayOf(bias))
+    class Gamma(gamma: Float) : YuvOp(2, floatArrayOf(gamma))
+
+    /**
+     * Unsharp mask with 3x3 gaussian, intensity is clamped to 0...31
+     */
+    class Sharpen(intensity: Float) : YuvOp(3, floatArrayOf(intensity))
+
+    /**
+     * Neighbours closer to the pixel than threshold in luma units are averaged with it
+     */
+    class Denoise(threshold: Float = 12f) : YuvOp(4, floatArrayOf(threshold))
+    class Clahe(threshold: Float = 3f, gridX: Int = 8, gridY: Int = 8) :
+        YuvOp(5, floatArrayOf(threshold, gridX.toFloat(), gridY.toFloat()))
+
+    class Saturation(saturation: Float) : YuvOp(6, floatArrayOf(saturation))
+    class Hue(degrees: Float) : YuvOp(7, floatArrayOf(degrees))
+
+    /**
+     * @param matrix - Row major 2x2 matrix applied to Cb and Cr
+     */
+    class ChromaMatrix(matrix: FloatArray) : YuvOp(8, matrix.copyOf(4))
+}
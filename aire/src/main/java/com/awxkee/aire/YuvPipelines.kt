@@ -30,6 +30,9 @@
 
 package com.awxkee.aire
 
+import android.graphics.Bitmap
+import android.os.Build
+import androidx.annotation.RequiresApi
 import java.nio.ByteBuffer
 
 interface YuvPipelines {
@@ -50,4 +53,219 @@ interface YuvPipelines {
         width: Int,
         height: Int
     ): ByteBuffer
-}
\ No newline at end of file
+
+    /**
+     * Converts straight into [destination], which must be ARGB_8888 or RGBA_F16 of the image size,
+     * so a camera preview may reuse the same bitmap for every frame
+     */
+    fun NV12ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+    ): Bitmap
+
+    fun NV21ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+    ): Bitmap
+
+    fun I420ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+    ): Bitmap
+
+    fun I422ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+    ): Bitmap
+
+    fun I444ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+    ): Bitmap
+
+    /**
+     * Encodes [bitmap] into caller provided planes, chroma is averaged over 2x2 blocks.
+     * Planes must be direct byte buffers large enough for the given strides
+     */
+    fun bitmapToNV12(
+        bitmap: Bitmap,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED
+    )
+
+    fun bitmapToNV21(
+        bitmap: Bitmap,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED
+    )
+
+    fun bitmapToI420(
+        bitmap: Bitmap,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED
+    )
+
+    /**
+     * Same as bitmap encoders for RGBA8888 or BGRA8888 pixels held in a direct byte buffer
+     */
+    fun RGBAToNV12(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        bgra: Boolean = false
+    )
+
+    fun RGBAToNV21(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        bgra: Boolean = false
+    )
+
+    fun RGBAToI420(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        matrix: YuvMatrix = YuvMatrix.BT601,
+        range: YuvRange = YuvRange.LIMITED,
+        bgra: Boolean = false
+    )
+
+    /**
+     * 10 bit P010 with samples in high bits, strides are in bytes. [destination] must be RGBA_1010102 or RGBA_F16,
+     * linearized PQ keeps highlights above 1.0 only in RGBA_F16
+     */
+    @RequiresApi(Build.VERSION_CODES.O)
+    fun P010ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT2020,
+        range: YuvRange = YuvRange.LIMITED,
+        transfer: YuvTransfer = YuvTransfer.NONE,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.RGBA_F16)
+    ): Bitmap
+
+    /**
+     * 10 bit planar 4:2:0 with samples in low bits, strides are in bytes
+     */
+    @RequiresApi(Build.VERSION_CODES.O)
+    fun I010ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix = YuvMatrix.BT2020,
+        range: YuvRange = YuvRange.LIMITED,
+        transfer: YuvTransfer = YuvTransfer.NONE,
+        destination: Bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.RGBA_F16)
+    ): Bitmap
+
+    /**
+     * Runs [ops] in place on NV12 frame, planes stay NV12 so there are no RGB conversions per frame
+     */
+    fun processNV12(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        ops: List<YuvOp>,
+        range: YuvRange = YuvRange.LIMITED
+    )
+
+    fun processNV21(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        width: Int,
+        height: Int,
+        ops: List<YuvOp>,
+        range: YuvRange = YuvRange.LIMITED
+    )
+}
@@ -41,6 +41,7 @@ import com.awxkee.aire.EdgeMode
 import com.awxkee.aire.KernelShape
 import com.awxkee.aire.MorphOp
 import com.awxkee.aire.MorphOpMode
+import com.awxkee.aire.PointwiseOp
 import com.awxkee.aire.Scalar
 
 class BasePipelinesImpl : BasePipelines {
@@ -71,6 +72,28 @@ class BasePipelinesImpl : BasePipelines {
         )
     }
 
+    override fun fusedMorphology(
+        bitmap: Bitmap,
+        morphOp: MorphOp,
+        morphOpMode: MorphOpMode,
+        borderMode: EdgeMode,
+        borderScalar: Scalar,
+        kernel: IntArray,
+        kernelWidth: Int,
+        kernelHeight: Int
+    ): Bitmap {
+        return morphologyPipeline(
+            bitmap,
+            morphOp.value,
+            morphOpMode.value,
+            borderMode.value,
+            borderScalar,
+            kernel,
+            kernelWidth,
+            kernelHeight
+        )
+    }
+
     override fun grayscale(
         bitmap: Bitmap,
         rPrimary: Float,
@@ -100,6 +123,19 @@ class BasePipelinesImpl : BasePipelines {
         return colorMatrixImpl(bitmap, colorMatrix)
     }
 
+    override fun lut3D(bitmap: Bitmap, lut: ByteArray): Bitmap {
+        return lut3DImpl(bitmap, lut)
+    }
+
+    override fun pointwise(bitmap: Bitmap, ops: List<PointwiseOp>): Bitmap {
+        val types = IntArray(ops.size) { ops[it].type }
+        val params = FloatArray(ops.size * 9)
+        ops.forEachIndexed { index, op ->
+            op.params.copyInto(params, index * 9)
+        }
+        return pointwiseImpl(bitmap, types, params)
+    }
+
     override fun brightness(bitmap: Bitmap, bias: Float): Bitmap {
         return brightnessImpl(bitmap, bias)
     }
@@ -120,8 +156,14 @@ class BasePipelinesImpl : BasePipelines {
         )
     }
 
-    override fun grain(bitmap: Bitmap, intensity: Float): Bitmap {
-        return grainImpl(bitmap, intensity)
+    override fun grain(
+        bitmap: Bitmap,
+        intensity: Float,
+        seed: Long,
+        luminanceResponse: Float,
+        chromaIntensity: Float,
+    ): Bitmap {
+        return grainImpl(bitmap, intensity, seed, luminanceResponse, chromaIntensity)
     }
 
     override fun sharpness(bitmap: Bitmap, kernelSize: Int): Bitmap {
@@ -264,10 +306,20 @@ class BasePipelinesImpl : BasePipelines {
 
     private external fun sharpnessImpl(bitmap: Bitmap, intensity: Float = 1f): Bitmap
 
-    private external fun grainImpl(bitmap: Bitmap, intensity: Float): Bitmap
+    private external fun grainImpl(
+        bitmap: Bitmap,
+        intensity: Float,
+        seed: Long,
+        luminanceResponse: Float,
+        chromaIntensity: Float,
+    ): Bitmap
 
     private external fun colorMatrixImpl(bitmap: Bitmap, colorMatrix: FloatArray): Bitmap
 
+    private external fun lut3DImpl(bitmap: Bitmap, lut: ByteArray): Bitmap
+
+    private external fun pointwiseImpl(bitmap: Bitmap, types: IntArray, params: FloatArray): Bitmap
+
     private external fun contrastImpl(bitmap: Bitmap, gain: Float): Bitmap
 
     private external fun brightnessImpl(bitmap: Bitmap, bias: Float): Bitmap
@@ -294,4 +346,15 @@ class BasePipelinesImpl : BasePipelines {
         kernelWidth: Int,
         kernelHeight: Int
     ): Bitmap
+
+    private external fun morphologyPipeline(
+        bitmap: Bitmap,
+        morphOp: Int,
+        morphOpMode: Int,
+        borderMode: Int,
+        borderScalar: Scalar,
+        kernel: IntArray,
+        kernelWidth: Int,
+        kernelHeight: Int
+    ): Bitmap
 }
\ No newline at end of file
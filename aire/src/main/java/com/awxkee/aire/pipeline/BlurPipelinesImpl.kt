@@ -209,6 +209,18 @@ class BlurPipelinesImpl : BlurPipelines {
         return fastBilateralBlurImpl(bitmap, kernelSize, spatialSigma, rangeSigma)
     }
 
+    override fun bilateralGridBlur(
+        bitmap: Bitmap,
+        spatialSigma: Float,
+        rangeSigma: Float,
+        linearLight: Boolean,
+    ): Bitmap {
+        if (spatialSigma <= 0 || rangeSigma <= 0) {
+            throw IllegalStateException("Sigma must be more than 0")
+        }
+        return bilateralGridBlurImpl(bitmap, spatialSigma, rangeSigma, linearLight)
+    }
+
     override fun boxBlur(bitmap: Bitmap, kernelSize: Int): Bitmap {
         if (kernelSize < 1) {
             throw IllegalStateException("Kernel size must be more or equal 1")
@@ -382,6 +394,13 @@ class BlurPipelinesImpl : BlurPipelines {
         spatialSigma: Float
     ): Bitmap
 
+    private external fun bilateralGridBlurImpl(
+        bitmap: Bitmap,
+        spatialSigma: Float,
+        rangeSigma: Float,
+        linearLight: Boolean,
+    ): Bitmap
+
     private external fun gaussianBlurImpl(
         bitmap: Bitmap,
         horizontalKernelSize: Int,
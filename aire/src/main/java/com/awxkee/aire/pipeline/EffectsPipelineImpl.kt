@@ -33,6 +33,7 @@ package com.awxkee.aire.pipeline
 import android.graphics.Bitmap
 import androidx.annotation.IntRange
 import com.awxkee.aire.EffectsPipelines
+import com.awxkee.aire.EqualizeColorspace
 import com.awxkee.aire.PaletteTransferColorspace
 
 class EffectsPipelineImpl : EffectsPipelines {
@@ -237,6 +238,56 @@ class EffectsPipelineImpl : EffectsPipelines {
         return claheJZAZBZImpl(bitmap, threshold, gridSizeHorizontal, gridSizeVertical, binsCount)
     }
 
+    override fun equalizeHistogram(
+        bitmap: Bitmap,
+        colorspace: EqualizeColorspace,
+        binsCount: Int
+    ): Bitmap {
+        return equalizeHistogramPipeline(bitmap, colorspace.value, binsCount)
+    }
+
+    override fun equalizeHistogramTiles(
+        bitmap: Bitmap,
+        gridSizeHorizontal: Int,
+        gridSizeVertical: Int
+    ): Bitmap {
+        return equalizeHistogramTilesPipeline(bitmap, gridSizeHorizontal, gridSizeVertical)
+    }
+
+    override fun equalizeHistogramSliding(
+        bitmap: Bitmap,
+        gridSizeHorizontal: Int,
+        gridSizeVertical: Int,
+        colorspace: EqualizeColorspace,
+        binsCount: Int
+    ): Bitmap {
+        return equalizeHistogramSlidingPipeline(
+            bitmap,
+            gridSizeHorizontal,
+            gridSizeVertical,
+            colorspace.value,
+            binsCount
+        )
+    }
+
+    override fun contrastLimitedEqualize(
+        bitmap: Bitmap,
+        threshold: Float,
+        gridSizeHorizontal: Int,
+        gridSizeVertical: Int,
+        colorspace: EqualizeColorspace,
+        binsCount: Int
+    ): Bitmap {
+        return contrastLimitedEqualizePipeline(
+            bitmap,
+            threshold,
+            gridSizeHorizontal,
+            gridSizeVertical,
+            colorspace.value,
+            binsCount
+        )
+    }
+
     override fun copyPalette(
         source: Bitmap,
         destination: Bitmap,
@@ -387,6 +438,35 @@ class EffectsPipelineImpl : EffectsPipelines {
         binsCount: Int,
     ): Bitmap
 
+    private external fun equalizeHistogramPipeline(
+        bitmap: Bitmap,
+        colorspace: Int,
+        binsCount: Int
+    ): Bitmap
+
+    private external fun equalizeHistogramTilesPipeline(
+        bitmap: Bitmap,
+        gridSizeHorizontal: Int,
+        gridSizeVertical: Int
+    ): Bitmap
+
+    private external fun equalizeHistogramSlidingPipeline(
+        bitmap: Bitmap,
+        gridSizeHorizontal: Int,
+        gridSizeVertical: Int,
+        colorspace: Int,
+        binsCount: Int
+    ): Bitmap
+
+    private external fun contrastLimitedEqualizePipeline(
+        bitmap: Bitmap,
+        threshold: Float,
+        gridSizeHorizontal: Int,
+        gridSizeVertical: Int,
+        colorspace: Int,
+        binsCount: Int
+    ): Bitmap
+
     private external fun copyPaletteImpl(
         source: Bitmap,
         dest: Bitmap,
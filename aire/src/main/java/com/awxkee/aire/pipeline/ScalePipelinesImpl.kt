@@ -31,6 +31,7 @@
 package com.awxkee.aire.pipeline
 
 import android.graphics.Bitmap
+import android.os.Build
 import com.awxkee.aire.ResizeFunction
 import com.awxkee.aire.ScaleColorSpace
 import com.awxkee.aire.ScalePipelines
@@ -43,9 +44,32 @@ class ScalePipelinesImpl : ScalePipelines {
         scaleMode: ResizeFunction,
         colorSpace: ScaleColorSpace,
     ): Bitmap {
+        if (colorSpace == ScaleColorSpace.SRGB && scaleMode in nativeFunctions &&
+            (bitmap.config == Bitmap.Config.ARGB_8888 ||
+                    (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O && bitmap.config == Bitmap.Config.RGBA_F16))
+        ) {
+            return scaleImpl(bitmap, dstWidth, dstHeight, scaleMode.value, colorSpace.value)
+        }
         return resizeImpl(bitmap, dstWidth, dstHeight, scaleMode.value, colorSpace.value)
     }
 
+    private val nativeFunctions = setOf(
+        ResizeFunction.Bilinear,
+        ResizeFunction.Nearest,
+        ResizeFunction.Cubic,
+        ResizeFunction.MitchellNetravalli,
+        ResizeFunction.CatmullRom,
+        ResizeFunction.Hermite,
+        ResizeFunction.BSpline,
+        ResizeFunction.Hann,
+        ResizeFunction.Bicubic,
+        ResizeFunction.Box,
+        ResizeFunction.Lanczos2,
+        ResizeFunction.Lanczos3,
+        ResizeFunction.Lanczos4,
+        ResizeFunction.Lanczos6,
+    )
+
     private external fun scaleImpl(
         bitmap: Bitmap,
         dstWidth: Int,
@@ -32,6 +32,7 @@ package com.awxkee.aire.pipeline
 
 import android.graphics.Bitmap
 import com.awxkee.aire.TonePipelines
+import com.awxkee.aire.WhiteBalanceEstimator
 
 class TonePipelinesImpl : TonePipelines {
     override fun logarithmicToneMapping(bitmap: Bitmap, exposure: Float): Bitmap {
@@ -66,6 +67,14 @@ class TonePipelinesImpl : TonePipelines {
         return whiteBalanceImpl(bitmap, temperature, tint)
     }
 
+    override fun chromaticAdaptation(
+        bitmap: Bitmap,
+        sourceTemperature: Float,
+        targetTemperature: Float
+    ): Bitmap {
+        return chromaticAdaptationImpl(bitmap, sourceTemperature, targetTemperature)
+    }
+
     override fun mobius(bitmap: Bitmap, exposure: Float, transition: Float, peak: Float): Bitmap {
         return mobiusImpl(bitmap, exposure, transition, peak)
     }
@@ -82,6 +91,36 @@ class TonePipelinesImpl : TonePipelines {
         return dragoImpl(bitmap, exposure, sdrWhitePoint)
     }
 
+    override fun estimateWhiteBalance(bitmap: Bitmap, estimator: WhiteBalanceEstimator): FloatArray {
+        return estimateWhiteBalanceImpl(bitmap, estimator.value)
+    }
+
+    override fun estimateExposure(bitmap: Bitmap, key: Float): Float {
+        return estimateExposureImpl(bitmap, key)
+    }
+
+    override fun autoAdjust(
+        bitmap: Bitmap,
+        whiteBalance: Boolean,
+        estimator: WhiteBalanceEstimator,
+        exposure: Boolean,
+        key: Float
+    ): Bitmap {
+        return autoAdjustImpl(bitmap, whiteBalance, estimator.value, exposure, key)
+    }
+
+    private external fun estimateWhiteBalanceImpl(bitmap: Bitmap, estimator: Int): FloatArray
+
+    private external fun estimateExposureImpl(bitmap: Bitmap, key: Float): Float
+
+    private external fun autoAdjustImpl(
+        bitmap: Bitmap,
+        whiteBalance: Boolean,
+        estimator: Int,
+        exposure: Boolean,
+        key: Float
+    ): Bitmap
+
     private external fun dragoImpl(bitmap: Bitmap, exposure: Float, sdrWhitePoint: Float): Bitmap
 
     private external fun aldridgeImpl(bitmap: Bitmap, exposure: Float, cutoff: Float): Bitmap
@@ -92,6 +131,12 @@ class TonePipelinesImpl : TonePipelines {
 
     private external fun whiteBalanceImpl(bitmap: Bitmap, temperature: Float, tint: Float): Bitmap
 
+    private external fun chromaticAdaptationImpl(
+        bitmap: Bitmap,
+        sourceTemperature: Float,
+        targetTemperature: Float
+    ): Bitmap
+
     private external fun monochromeImpl(bitmap: Bitmap, color: FloatArray, exposure: Float): Bitmap
 
     private external fun acesHillImpl(bitmap: Bitmap, exposure: Float): Bitmap
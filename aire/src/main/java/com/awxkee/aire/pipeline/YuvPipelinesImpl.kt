@@ -30,7 +30,14 @@
 
 package com.awxkee.aire.pipeline
 
+import android.graphics.Bitmap
+import android.os.Build
+import androidx.annotation.RequiresApi
+import com.awxkee.aire.YuvMatrix
+import com.awxkee.aire.YuvOp
 import com.awxkee.aire.YuvPipelines
+import com.awxkee.aire.YuvRange
+import com.awxkee.aire.YuvTransfer
 import java.nio.ByteBuffer
 
 class YuvPipelinesImpl: YuvPipelines {
@@ -58,6 +65,353 @@ class YuvPipelinesImpl: YuvPipelines {
         return Yuv420nV21ToBGRImpl(dstBuffer, yBuffer, yStride, uvBuffer, uvStride, width, height)
     }
 
+    override fun NV12ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        destination: Bitmap
+    ): Bitmap {
+        return yuvToBitmapImpl(
+            destination, 0, yBuffer, yStride, uvBuffer, uvStride, null, 0,
+            width, height, matrix.value, range.value
+        )
+    }
+
+    override fun NV21ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        destination: Bitmap
+    ): Bitmap {
+        return yuvToBitmapImpl(
+            destination, 1, yBuffer, yStride, vuBuffer, vuStride, null, 0,
+            width, height, matrix.value, range.value
+        )
+    }
+
+    override fun I420ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        destination: Bitmap
+    ): Bitmap {
+        return yuvToBitmapImpl(
+            destination, 2, yBuffer, yStride, uBuffer, uStride, vBuffer, vStride,
+            width, height, matrix.value, range.value
+        )
+    }
+
+    override fun I422ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        destination: Bitmap
+    ): Bitmap {
+        return yuvToBitmapImpl(
+            destination, 3, yBuffer, yStride, uBuffer, uStride, vBuffer, vStride,
+            width, height, matrix.value, range.value
+        )
+    }
+
+    override fun I444ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        destination: Bitmap
+    ): Bitmap {
+        return yuvToBitmapImpl(
+            destination, 4, yBuffer, yStride, uBuffer, uStride, vBuffer, vStride,
+            width, height, matrix.value, range.value
+        )
+    }
+
+    override fun bitmapToNV12(
+        bitmap: Bitmap,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        matrix: YuvMatrix,
+        range: YuvRange
+    ) {
+        bitmapToYuvImpl(bitmap, 0, yBuffer, yStride, uvBuffer, uvStride, null, 0, matrix.value, range.value)
+    }
+
+    override fun bitmapToNV21(
+        bitmap: Bitmap,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        matrix: YuvMatrix,
+        range: YuvRange
+    ) {
+        bitmapToYuvImpl(bitmap, 1, yBuffer, yStride, vuBuffer, vuStride, null, 0, matrix.value, range.value)
+    }
+
+    override fun bitmapToI420(
+        bitmap: Bitmap,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        matrix: YuvMatrix,
+        range: YuvRange
+    ) {
+        bitmapToYuvImpl(bitmap, 2, yBuffer, yStride, uBuffer, uStride, vBuffer, vStride, matrix.value, range.value)
+    }
+
+    override fun RGBAToNV12(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        bgra: Boolean
+    ) {
+        rgbaToYuvImpl(
+            srcBuffer, srcStride, width, height, bgra, 0, yBuffer, yStride, uvBuffer, uvStride,
+            null, 0, matrix.value, range.value
+        )
+    }
+
+    override fun RGBAToNV21(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        bgra: Boolean
+    ) {
+        rgbaToYuvImpl(
+            srcBuffer, srcStride, width, height, bgra, 1, yBuffer, yStride, vuBuffer, vuStride,
+            null, 0, matrix.value, range.value
+        )
+    }
+
+    override fun RGBAToI420(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        bgra: Boolean
+    ) {
+        rgbaToYuvImpl(
+            srcBuffer, srcStride, width, height, bgra, 2, yBuffer, yStride, uBuffer, uStride,
+            vBuffer, vStride, matrix.value, range.value
+        )
+    }
+
+    @RequiresApi(Build.VERSION_CODES.O)
+    override fun P010ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        transfer: YuvTransfer,
+        destination: Bitmap
+    ): Bitmap {
+        return yuv10ToBitmapImpl(
+            destination, true, yBuffer, yStride, uvBuffer, uvStride, null, 0,
+            width, height, matrix.value, range.value, transfer.value
+        )
+    }
+
+    @RequiresApi(Build.VERSION_CODES.O)
+    override fun I010ToBitmap(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: YuvMatrix,
+        range: YuvRange,
+        transfer: YuvTransfer,
+        destination: Bitmap
+    ): Bitmap {
+        return yuv10ToBitmapImpl(
+            destination, false, yBuffer, yStride, uBuffer, uStride, vBuffer, vStride,
+            width, height, matrix.value, range.value, transfer.value
+        )
+    }
+
+    override fun processNV12(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        ops: List<YuvOp>,
+        range: YuvRange
+    ) {
+        processYuv(yBuffer, yStride, uvBuffer, uvStride, width, height, 0, ops, range)
+    }
+
+    override fun processNV21(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        vuBuffer: ByteBuffer,
+        vuStride: Int,
+        width: Int,
+        height: Int,
+        ops: List<YuvOp>,
+        range: YuvRange
+    ) {
+        processYuv(yBuffer, yStride, vuBuffer, vuStride, width, height, 1, ops, range)
+    }
+
+    private fun processYuv(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        layout: Int,
+        ops: List<YuvOp>,
+        range: YuvRange
+    ) {
+        val types = IntArray(ops.size) { ops[it].type }
+        val params = FloatArray(ops.size * 4)
+        ops.forEachIndexed { index, op ->
+            op.params.copyInto(params, index * 4)
+        }
+        yuvChainImpl(yBuffer, yStride, uvBuffer, uvStride, width, height, layout, range.value, types, params)
+    }
+
+    private external fun yuvChainImpl(
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uvBuffer: ByteBuffer,
+        uvStride: Int,
+        width: Int,
+        height: Int,
+        layout: Int,
+        range: Int,
+        types: IntArray,
+        params: FloatArray
+    )
+
+    private external fun yuv10ToBitmapImpl(
+        destination: Bitmap,
+        p010: Boolean,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer?,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: Int,
+        range: Int,
+        transfer: Int
+    ): Bitmap
+
+    private external fun bitmapToYuvImpl(
+        bitmap: Bitmap,
+        layout: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer?,
+        vStride: Int,
+        matrix: Int,
+        range: Int
+    )
+
+    private external fun rgbaToYuvImpl(
+        srcBuffer: ByteBuffer,
+        srcStride: Int,
+        width: Int,
+        height: Int,
+        bgra: Boolean,
+        layout: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer?,
+        vStride: Int,
+        matrix: Int,
+        range: Int
+    )
+
+    private external fun yuvToBitmapImpl(
+        destination: Bitmap,
+        layout: Int,
+        yBuffer: ByteBuffer,
+        yStride: Int,
+        uBuffer: ByteBuffer,
+        uStride: Int,
+        vBuffer: ByteBuffer?,
+        vStride: Int,
+        width: Int,
+        height: Int,
+        matrix: Int,
+        range: Int
+    ): Bitmap
+
     private external fun Yuv420nV21ToRGBA(
         dstBuffer: ByteBuffer,
         yBuffer: ByteBuffer,